@@ -36,6 +36,11 @@
 #endif
 #include "sysemu/cpus.h"
 #include "sysemu/replay.h"
+// CF FIES
+#include "fault-injection-controller.h"
+#include "fault-injection-dcls.h"
+#include "fault-injection-stats.h"
+// CF FIES END
 
 /* -icount align implementation. */
 
@@ -145,6 +150,13 @@ static inline tcg_target_ulong cpu_tb_exec(CPUState *cpu, TranslationBlock *itb)
     int tb_exit;
     uint8_t *tb_ptr = itb->tc.ptr;
 
+    // CF FIES
+    /* In DCLS mode, the TB is run by the faulted and the shadow context.  */
+    if (unlikely(fies_dcls) && !fies_dcls_active) {
+        return FIESER_dcls_tb_exec(cpu, itb, cpu_tb_exec);
+    }
+    // CF FIES END
+
     qemu_log_mask_and_addr(CPU_LOG_EXEC, itb->pc,
                            "Trace %p [%d: " TARGET_FMT_lx "] %s\n",
                            itb->tc.ptr, cpu->cpu_index, itb->pc,
@@ -193,7 +205,6 @@ static inline tcg_target_ulong cpu_tb_exec(CPUState *cpu, TranslationBlock *itb)
     return ret;
 }
 
-#ifndef CONFIG_USER_ONLY
 /* Execute the code without caching the generated code. An interpreter
    could be used if available. */
 static void cpu_exec_nocache(CPUState *cpu, int max_cycles,
@@ -210,11 +221,19 @@ static void cpu_exec_nocache(CPUState *cpu, int max_cycles,
        We only end up here when an existing TB is too long.  */
     cflags |= MIN(max_cycles, CF_COUNT_MASK);
 
+    // CF FIES
+    /* tb_gen_code needs mmap_lock in user mode, where FIES runs the
+       faulty variants of instructions through here as well.  */
+    mmap_lock();
+    // CF FIES END
     tb_lock();
     tb = tb_gen_code(cpu, orig_tb->pc, orig_tb->cs_base,
                      orig_tb->flags, cflags);
     tb->orig_tb = orig_tb;
     tb_unlock();
+    // CF FIES
+    mmap_unlock();
+    // CF FIES END
 
     /* execute the generated code */
     trace_exec_tb_nocache(tb, tb->pc);
@@ -225,7 +244,6 @@ static void cpu_exec_nocache(CPUState *cpu, int max_cycles,
     tb_remove(tb);
     tb_unlock();
 }
-#endif
 
 void cpu_exec_step_atomic(CPUState *cpu)
 {
@@ -417,6 +435,14 @@ static inline TranslationBlock *tb_find(CPUState *cpu,
         last_tb = NULL;
     }
 #endif
+    // CF FIES
+    /* Instructions with an armed fault are dispatched by cpu_exec, as
+       are all TBs in DCLS mode.  */
+    if (unlikely(fies_enabled)
+        && (fies_dcls || FIESER_insn_armed(tb->pc))) {
+        last_tb = NULL;
+    }
+    // CF FIES END
     /* See if we can patch the calling TB. */
     if (last_tb && !qemu_loglevel_mask(CPU_LOG_TB_NOCHAIN)) {
         if (!acquired_tb_lock) {
@@ -729,6 +755,17 @@ int cpu_exec(CPUState *cpu)
             }
 
             tb = tb_find(cpu, last_tb, tb_exit, cflags);
+            // CF FIES
+            /* Run the faulty variant of an instruction with an active fault
+               as a single-use TB, so that the clean TB stays cached and the
+               fault reverts once it becomes inactive.  */
+            if (unlikely(fies_enabled) && FIESER_insn_fault_active(tb->pc)) {
+                cpu_exec_nocache(cpu, 1, tb, true);
+                last_tb = NULL;
+                tb_exit = 0;
+                continue;
+            }
+            // CF FIES END
             cpu_loop_exec_tb(cpu, tb, &last_tb, &tb_exit);
             /* Try to align the host and virtual clocks
                if the guest is in advance */
@@ -736,6 +773,10 @@ int cpu_exec(CPUState *cpu)
         }
     }
 
+    // CF FIES
+    FIESER_stats_publish_insns(cpu);
+    // CF FIES END
+
     cc->cpu_exec_exit(cpu);
     rcu_read_unlock();
 
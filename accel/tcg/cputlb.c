@@ -33,6 +33,7 @@
 #include "exec/helper-proto.h"
 #include "qemu/atomic.h"
 #include "fault-injection-controller.h"
+#include "fault-injection-dcls.h"
 
 /* DEBUG defines, enable DEBUG_TLB_LOG to log to the CPU_LOG_MMU target */
 /* #define DEBUG_TLB */
@@ -552,9 +553,11 @@ void tlb_reset_dirty(CPUState *cpu, ram_addr_t start1, ram_addr_t length)
 
 static inline void tlb_set_dirty1(CPUTLBEntry *tlb_entry, target_ulong vaddr)
 {
-    if (tlb_entry->addr_write == (vaddr | TLB_NOTDIRTY)) {
-        tlb_entry->addr_write = vaddr;
+    // CF FIES
+    if ((tlb_entry->addr_write & ~TLB_FIES) == (vaddr | TLB_NOTDIRTY)) {
+        tlb_entry->addr_write &= ~TLB_NOTDIRTY;
     }
+    // CF FIES END
 }
 
 /* update the TLB corresponding to virtual page vaddr
@@ -672,6 +675,12 @@ void tlb_set_page_with_attrs(CPUState *cpu, target_ulong vaddr,
     tn.addend = addend - vaddr;
     if (prot & PAGE_READ) {
         tn.addr_read = address;
+        // CF FIES
+        if (unlikely(fies_enabled) && !(address & TLB_MMIO)
+            && FIESER_tlb_filtered(vaddr, false)) {
+            tn.addr_read |= TLB_FIES;
+        }
+        // CF FIES END
     } else {
         tn.addr_read = -1;
     }
@@ -698,6 +707,12 @@ void tlb_set_page_with_attrs(CPUState *cpu, target_ulong vaddr,
         if (prot & PAGE_WRITE_INV) {
             tn.addr_write |= TLB_INVALID_MASK;
         }
+        // CF FIES
+        if (unlikely(fies_enabled) && !(tn.addr_write & TLB_MMIO)
+            && FIESER_tlb_filtered(vaddr, true)) {
+            tn.addr_write |= TLB_FIES;
+        }
+        // CF FIES END
     }
 
     /* Pairs with flag setting in tlb_reset_dirty_range */
@@ -780,6 +795,13 @@ static uint64_t io_readx(CPUArchState *env, CPUIOTLBEntry *iotlbentry,
 
     cpu->mem_io_vaddr = addr;
 
+    // CF FIES
+    /* The shadow context of DCLS mode replays the device reads.  */
+    if (unlikely(fies_dcls_active)
+        && FIESER_dcls_io_begin(addr, size, &val, false)) {
+        return val;
+    }
+    // CF FIES END
     if (mr->global_locking && !qemu_mutex_iothread_locked()) {
         qemu_mutex_lock_iothread();
         locked = true;
@@ -790,14 +812,14 @@ static uint64_t io_readx(CPUArchState *env, CPUIOTLBEntry *iotlbentry,
         cpu_transaction_failed(cpu, physaddr, addr, size, MMU_DATA_LOAD,
                                mmu_idx, iotlbentry->attrs, r, retaddr);
     }
-    // CF FIES
-    uint64_t addr64 = addr;
-    FIESER_hook(env, (&addr64), ((uint32_t*)&val), FI_MEMORY_CONTENT, read_access_type);
-    // CF FIES END
-
     if (locked) {
         qemu_mutex_unlock_iothread();
     }
+    // CF FIES
+    if (unlikely(fies_dcls_active)) {
+        FIESER_dcls_io_end(addr, size, val, false);
+    }
+    // CF FIES END
     
     return val;
 }
@@ -819,12 +841,20 @@ static void io_writex(CPUArchState *env, CPUIOTLBEntry *iotlbentry,
     }
     cpu->mem_io_vaddr = addr;
     cpu->mem_io_pc = retaddr;
-    
+
     // CF FIES
-    uint64_t addr64 = addr;
-    FIESER_hook(env, (&addr64), ((uint32_t*)&val), FI_MEMORY_CONTENT, write_access_type);
+    /* Stores to RAM, which is tracked for dirty pages, are logged like
+       those of the fast path, device writes are replayed by the shadow
+       context of DCLS mode.  */
+    if (unlikely(fies_dcls_active)) {
+        if (mr == &io_mem_notdirty) {
+            FIESER_dcls_do_store(addr, val, size,
+                                 qemu_map_ram_ptr(NULL, physaddr));
+        } else if (FIESER_dcls_io_begin(addr, size, &val, true)) {
+            return;
+        }
+    }
     // CF FIES END
-
     if (mr->global_locking && !qemu_mutex_iothread_locked()) {
         qemu_mutex_lock_iothread();
         locked = true;
@@ -838,6 +868,11 @@ static void io_writex(CPUArchState *env, CPUIOTLBEntry *iotlbentry,
     if (locked) {
         qemu_mutex_unlock_iothread();
     }
+    // CF FIES
+    if (unlikely(fies_dcls_active) && mr != &io_mem_notdirty) {
+        FIESER_dcls_io_end(addr, size, val, true);
+    }
+    // CF FIES END
 }
 
 /* Return true if ADDR is present in the victim tlb, and has been copied
@@ -998,7 +1033,11 @@ static void *atomic_mmu_lookup(CPUArchState *env, target_ulong addr,
     }
 
     /* Notice an IO access  */
-    if (unlikely(tlb_addr & TLB_MMIO)) {
+    // CF FIES
+    /* Accesses to pages with TLB_FIES are serialized as well, so that
+       the fault controller sees the loads and stores of the operation.  */
+    if (unlikely(tlb_addr & (TLB_MMIO | TLB_FIES))) {
+    // CF FIES END
         /* There's really nothing that can be done to
            support this apart from stop-the-world.  */
         goto stop_the_world;
@@ -0,0 +1,69 @@
+/*
+ * Host perf map of translated blocks
+ *
+ * Writes /tmp/perf-<pid>.map in the format understood by perf(1), so
+ * that samples in the code_gen_buffer are attributed to the guest PC of
+ * the translated block and to whether the block carries FIES
+ * instrumentation (fault_controller_call_* helper calls).
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+#include "qemu/error-report.h"
+#include "perf-map.h"
+
+bool perf_map_enabled;
+static FILE *perf_map_file;
+
+static void perf_map_exit(void)
+{
+    if (perf_map_file) {
+        fclose(perf_map_file);
+        perf_map_file = NULL;
+    }
+}
+
+void perf_map_enable(void)
+{
+    char *path;
+
+    if (perf_map_file) {
+        return;
+    }
+
+    path = g_strdup_printf("/tmp/perf-%d.map", getpid());
+    perf_map_file = fopen(path, "w");
+    if (!perf_map_file) {
+        warn_report("could not open %s: %s, perf map disabled",
+                    path, strerror(errno));
+        g_free(path);
+        return;
+    }
+    g_free(path);
+
+    /* QEMU is often killed at the end of a profile, which would lose
+       the records still in the stdio buffer.  */
+    setvbuf(perf_map_file, NULL, _IOLBF, 0);
+
+    perf_map_enabled = true;
+    atexit(perf_map_exit);
+}
+
+/*
+ * Called with tb_lock held, hence there is a single writer.  A tb_flush
+ * reuses the code buffer, so entries written before it may overlap
+ * later ones and profiles spanning a flush are approximate.
+ */
+void perf_map_report_tb(const void *start, size_t size, uint64_t guest_pc,
+                        bool fies_instrumented)
+{
+    if (!perf_map_file) {
+        return;
+    }
+
+    fprintf(perf_map_file, "%" PRIxPTR " %zx guest-tb%s:0x%" PRIx64 "\n",
+            (uintptr_t)start, size, fies_instrumented ? "-fies" : "",
+            guest_pc);
+}
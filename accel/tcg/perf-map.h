@@ -0,0 +1,17 @@
+/*
+ * Host perf map of translated blocks
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#ifndef ACCEL_TCG_PERF_MAP_H
+#define ACCEL_TCG_PERF_MAP_H
+
+void perf_map_enable(void);
+void perf_map_report_tb(const void *start, size_t size, uint64_t guest_pc,
+                        bool fies_instrumented);
+
+extern bool perf_map_enabled;
+
+#endif
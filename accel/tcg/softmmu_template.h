@@ -131,7 +131,11 @@ WORD_TYPE helper_le_ld_name(CPUArchState *env, target_ulong addr,
     }
 
     /* Handle an IO access.  */
-    if (unlikely(tlb_addr & ~TARGET_PAGE_MASK)) {
+// CF FIES
+    /* Loads from pages with TLB_FIES are RAM accesses, which are seen
+       by the fault controller below.  */
+    if (unlikely(tlb_addr & ~(TARGET_PAGE_MASK | TLB_FIES))) {
+// CF FIES END
         if ((addr & (DATA_SIZE - 1)) != 0) {
             goto do_unaligned_access;
         }
@@ -141,8 +145,7 @@ WORD_TYPE helper_le_ld_name(CPUArchState *env, target_ulong addr,
         res = glue(io_read, SUFFIX)(env, mmu_idx, index, addr, retaddr);
         res = TGT_LE(res);
 // CF FIES
-        uint64_t addr64 = addr;
-        FIESER_hook(env, (&addr64), ((uint32_t*)&res), FI_MEMORY_CONTENT, read_access_type);
+        res = FIESER_hook_mem(env, addr, res, DATA_SIZE, false, read_access_type, FI_SITE_SOFTMMU);
 // CF FIES END
         return res;
     }
@@ -163,10 +166,6 @@ WORD_TYPE helper_le_ld_name(CPUArchState *env, target_ulong addr,
 
         /* Little-endian combine.  */
         res = (res1 >> shift) | (res2 << ((DATA_SIZE * 8) - shift));
-// CF FIES
-        uint64_t addr64 = addr;
-        FIESER_hook(env, (&addr64), ((uint32_t*)&res), FI_MEMORY_CONTENT, read_access_type);
-// CF FIES END
         return res;
     }
 
@@ -176,8 +175,9 @@ WORD_TYPE helper_le_ld_name(CPUArchState *env, target_ulong addr,
 #else
     res = glue(glue(ld, LSUFFIX), _le_p)((uint8_t *)haddr);
 #endif
-    uint64_t addr64 = addr;    
-    FIESER_hook(env, (&addr64), ((uint32_t*)&res), FI_MEMORY_CONTENT, read_access_type);
+// CF FIES
+    res = FIESER_hook_mem(env, addr, res, DATA_SIZE, false, read_access_type, FI_SITE_SOFTMMU);
+// CF FIES END
     return res;
 }
 
@@ -187,7 +187,7 @@ WORD_TYPE helper_be_ld_name(CPUArchState *env, target_ulong addr,
 {
 // CF FIES
     uint64_t addr64 = addr;
-    FIESER_hook(env, (&addr64), NULL, FI_MEMORY_ADDR, read_access_type);
+    FIESER_hook(env, (&addr64), NULL, FI_MEMORY_ADDR, read_access_type, FI_SITE_SOFTMMU);
     addr = addr64;
 // CF FIES END
 
@@ -214,7 +214,11 @@ WORD_TYPE helper_be_ld_name(CPUArchState *env, target_ulong addr,
     }
 
     /* Handle an IO access.  */
-    if (unlikely(tlb_addr & ~TARGET_PAGE_MASK)) {
+// CF FIES
+    /* Loads from pages with TLB_FIES are RAM accesses, which are seen
+       by the fault controller below.  */
+    if (unlikely(tlb_addr & ~(TARGET_PAGE_MASK | TLB_FIES))) {
+// CF FIES END
         if ((addr & (DATA_SIZE - 1)) != 0) {
             goto do_unaligned_access;
         }
@@ -224,7 +228,7 @@ WORD_TYPE helper_be_ld_name(CPUArchState *env, target_ulong addr,
         res = glue(io_read, SUFFIX)(env, mmu_idx, index, addr, retaddr);
         res = TGT_BE(res);
 // CF FIES
-        FIESER_hook(env, (&addr64), ((uint32_t*)&res), FI_MEMORY_CONTENT, read_access_type);
+        res = FIESER_hook_mem(env, addr, res, DATA_SIZE, true, read_access_type, FI_SITE_SOFTMMU);
 // CF FIES END
         return res;
     }
@@ -245,14 +249,14 @@ WORD_TYPE helper_be_ld_name(CPUArchState *env, target_ulong addr,
 
         /* Big-endian combine.  */
         res = (res1 << shift) | (res2 >> ((DATA_SIZE * 8) - shift));
-// CF FIES
-        FIESER_hook(env, (&addr64), ((uint32_t*)&res), FI_MEMORY_CONTENT, read_access_type);
-// CF FIES END
         return res;
     }
 
     haddr = addr + env->tlb_table[mmu_idx][index].addend;
     res = glue(glue(ld, LSUFFIX), _be_p)((uint8_t *)haddr);
+// CF FIES
+    res = FIESER_hook_mem(env, addr, res, DATA_SIZE, true, read_access_type, FI_SITE_SOFTMMU);
+// CF FIES END
     return res;
 }
 #endif /* DATA_SIZE > 1 */
@@ -292,7 +296,7 @@ void helper_le_st_name(CPUArchState *env, target_ulong addr, DATA_TYPE val,
 {
 // CF FIES
     uint64_t addr64 = addr;
-    FIESER_hook(env, (&addr64), NULL, FI_MEMORY_ADDR, write_access_type);
+    FIESER_hook(env, (&addr64), NULL, FI_MEMORY_ADDR, write_access_type, FI_SITE_SOFTMMU);
     addr = addr64;
 // CF FIES END
 
@@ -317,17 +321,21 @@ void helper_le_st_name(CPUArchState *env, target_ulong addr, DATA_TYPE val,
     }
 
     /* Handle an IO access.  */
-    if (unlikely(tlb_addr & ~TARGET_PAGE_MASK)) {
+// CF FIES
+    /* Stores to pages with TLB_FIES are RAM accesses, which are filtered
+       by the fault controller below.  */
+    if (unlikely(tlb_addr & ~(TARGET_PAGE_MASK | TLB_FIES))) {
+// CF FIES END
         if ((addr & (DATA_SIZE - 1)) != 0) {
             goto do_unaligned_access;
         }
 
         /* ??? Note that the io helpers always read data in the target
            byte ordering.  We should push the LE/BE request down into io.  */
-        val = TGT_LE(val);
 // CF FIES
-	FIESER_hook(env, (&addr64), ((uint32_t*)&val), FI_MEMORY_CONTENT, write_access_type);
+        val = FIESER_hook_mem(env, addr, val, DATA_SIZE, false, write_access_type, FI_SITE_SOFTMMU);
 // CF FIES END
+        val = TGT_LE(val);
         glue(io_write, SUFFIX)(env, mmu_idx, index, val, addr, retaddr);
         return;
     }
@@ -357,10 +365,6 @@ void helper_le_st_name(CPUArchState *env, target_ulong addr, DATA_TYPE val,
         for (i = 0; i < DATA_SIZE; ++i) {
             /* Little-endian extract.  */
             uint8_t val8 = val >> (i * 8);
-// CF FIES
-	    hwaddr temp = addr + i;
-            FIESER_hook(env, (&temp), ((uint32_t*)&val8), FI_MEMORY_CONTENT, write_access_type);
-// CF FIES END
             glue(helper_ret_stb, MMUSUFFIX)(env, addr + i, val8,
                                             oi, retaddr);
         }
@@ -368,15 +372,13 @@ void helper_le_st_name(CPUArchState *env, target_ulong addr, DATA_TYPE val,
     }
 
     haddr = addr + env->tlb_table[mmu_idx][index].addend;
-#if DATA_SIZE == 1
 // CF FIES
-    FIESER_hook(env, (&addr64), ((uint32_t*)&val), FI_MEMORY_CONTENT, write_access_type);
+    val = FIESER_hook_mem(env, addr, val, DATA_SIZE, false, write_access_type, FI_SITE_SOFTMMU);
+    FIESER_dcls_store(addr, val, DATA_SIZE, (void *)haddr);
 // CF FIES END
+#if DATA_SIZE == 1
     glue(glue(st, SUFFIX), _p)((uint8_t *)haddr, val);
 #else
-// CF FIES
-    FIESER_hook(env, (&addr64), ((uint32_t*)&val), FI_MEMORY_CONTENT, write_access_type);
-// CF FIES END
     glue(glue(st, SUFFIX), _le_p)((uint8_t *)haddr, val);
 #endif
 }
@@ -387,7 +389,8 @@ void helper_be_st_name(CPUArchState *env, target_ulong addr, DATA_TYPE val,
 {
 // CF FIES
     uint64_t addr64 = addr;
-    FIESER_hook(env, (&addr64), ((uint32_t*)&val), FI_MEMORY_ADDR, write_access_type);
+    FIESER_hook(env, (&addr64), NULL, FI_MEMORY_ADDR, write_access_type, FI_SITE_SOFTMMU);
+    addr = addr64;
 // CF FIES END
     unsigned mmu_idx = get_mmuidx(oi);
     int index = (addr >> TARGET_PAGE_BITS) & (CPU_TLB_SIZE - 1);
@@ -410,17 +413,21 @@ void helper_be_st_name(CPUArchState *env, target_ulong addr, DATA_TYPE val,
     }
 
     /* Handle an IO access.  */
-    if (unlikely(tlb_addr & ~TARGET_PAGE_MASK)) {
+// CF FIES
+    /* Stores to pages with TLB_FIES are RAM accesses, which are filtered
+       by the fault controller below.  */
+    if (unlikely(tlb_addr & ~(TARGET_PAGE_MASK | TLB_FIES))) {
+// CF FIES END
         if ((addr & (DATA_SIZE - 1)) != 0) {
             goto do_unaligned_access;
         }
 
         /* ??? Note that the io helpers always read data in the target
            byte ordering.  We should push the LE/BE request down into io.  */
-        val = TGT_BE(val);
 // CF FIES
-	FIESER_hook(env, (&addr64), ((uint32_t*)&val), FI_MEMORY_CONTENT, write_access_type);
+        val = FIESER_hook_mem(env, addr, val, DATA_SIZE, true, write_access_type, FI_SITE_SOFTMMU);
 // CF FIES END
+        val = TGT_BE(val);
         glue(io_write, SUFFIX)(env, mmu_idx, index, val, addr, retaddr);
         return;
     }
@@ -450,9 +457,6 @@ void helper_be_st_name(CPUArchState *env, target_ulong addr, DATA_TYPE val,
         for (i = 0; i < DATA_SIZE; ++i) {
             /* Big-endian extract.  */
             uint8_t val8 = val >> (((DATA_SIZE - 1) * 8) - (i * 8));
-// CF FIES
-	    FIESER_hook(env, (&addr64), ((uint32_t*)&val8), FI_MEMORY_CONTENT, write_access_type);
-// CF FIES END
             glue(helper_ret_stb, MMUSUFFIX)(env, addr + i, val8,
                                             oi, retaddr);
         }
@@ -461,7 +465,8 @@ void helper_be_st_name(CPUArchState *env, target_ulong addr, DATA_TYPE val,
 
     haddr = addr + env->tlb_table[mmu_idx][index].addend;
 // CF FIES
-    FIESER_hook(env, (&addr64), ((uint32_t*)&val), FI_MEMORY_CONTENT, write_access_type);
+    val = FIESER_hook_mem(env, addr, val, DATA_SIZE, true, write_access_type, FI_SITE_SOFTMMU);
+    FIESER_dcls_store(addr, val, DATA_SIZE, (void *)haddr);
 // CF FIES END
     glue(glue(st, SUFFIX), _be_p)((uint8_t *)haddr, val);
 }
@@ -30,6 +30,9 @@
 #include "exec/tb-lookup.h"
 #include "disas/disas.h"
 #include "exec/log.h"
+// CF FIES
+#include "fault-injection-controller.h"
+// CF FIES END
 
 /* 32-bit helpers */
 
@@ -155,6 +158,13 @@ void *HELPER(lookup_tb_ptr)(CPUArchState *env)
     if (tb == NULL) {
         return tcg_ctx->code_gen_epilogue;
     }
+    // CF FIES
+    /* Instructions with an armed fault are dispatched by cpu_exec, as
+       are all TBs in DCLS mode.  */
+    if (unlikely(fies_enabled) && (fies_dcls || FIESER_insn_armed(pc))) {
+        return tcg_ctx->code_gen_epilogue;
+    }
+    // CF FIES END
     qemu_log_mask_and_addr(CPU_LOG_EXEC, pc,
                            "Chain %p [%d: " TARGET_FMT_lx "] %s\n",
                            tb->tc.ptr, cpu->cpu_index, pc,
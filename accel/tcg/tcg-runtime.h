@@ -28,6 +28,13 @@ DEF_HELPER_FLAGS_1(lookup_tb_ptr, TCG_CALL_NO_WG_SE, ptr, env)
 
 DEF_HELPER_FLAGS_1(exit_atomic, TCG_CALL_NO_WG, noreturn, env)
 
+// CF FIES
+#ifdef CONFIG_USER_ONLY
+DEF_HELPER_FLAGS_4(fies_user_ld, TCG_CALL_NO_WG, i64, env, tl, i64, i32)
+DEF_HELPER_FLAGS_4(fies_user_st, TCG_CALL_NO_WG, i64, env, tl, i64, i32)
+#endif
+// CF FIES END
+
 #ifdef CONFIG_SOFTMMU
 
 DEF_HELPER_FLAGS_5(atomic_cmpxchgb, TCG_CALL_NO_WG,
@@ -58,6 +58,10 @@
 #include "qemu/main-loop.h"
 #include "exec/log.h"
 #include "sysemu/cpus.h"
+#include "perf-map.h"
+// CF FIES
+#include "fault-injection-controller.h"
+// CF FIES END
 
 /* #define DEBUG_TB_INVALIDATE */
 /* #define DEBUG_TB_FLUSH */
@@ -937,6 +941,19 @@ void tb_flush(CPUState *cpu)
     }
 }
 
+// CF FIES
+/* Flush all translations right away.  Has to be called from an exclusive
+ * section (e.g. async_safe_run_on_cpu() work), so that no vCPU executes a
+ * TB translated before the state it was translated from changed.  */
+void tb_flush_exclusive(CPUState *cpu)
+{
+    if (tcg_enabled()) {
+        do_tb_flush(cpu, RUN_ON_CPU_HOST_INT(
+                        atomic_mb_read(&tb_ctx.tb_flush_count)));
+    }
+}
+// CF FIES END
+
 /*
  * Formerly ifdef DEBUG_TB_CHECK. These debug functions are user-mode-only,
  * so in order to prevent bit rot we compile them unconditionally in user-mode,
@@ -1288,8 +1305,18 @@ TranslationBlock *tb_gen_code(CPUState *cpu,
     tcg_func_start(tcg_ctx);
 
     tcg_ctx->cpu = ENV_GET_CPU(env);
+    // CF FIES
+    tcg_ctx->fies_instrumented = false;
+    tcg_ctx->fies_vfp = false;
+#ifdef CONFIG_USER_ONLY
+    tcg_ctx->fies_mem_hooks = fies_enabled && FIESER_mem_armed();
+#endif
+    // CF FIES END
     gen_intermediate_code(cpu, tb);
     tcg_ctx->cpu = NULL;
+    // CF FIES
+    tb->fies_vfp = tcg_ctx->fies_vfp;
+    // CF FIES END
 
     trace_translate_block(tb, tb->pc, tb->tc.ptr);
 
@@ -1326,6 +1353,11 @@ TranslationBlock *tb_gen_code(CPUState *cpu,
     }
     tb->tc.size = gen_code_size;
 
+    if (perf_map_enabled) {
+        perf_map_report_tb(gen_code_buf, gen_code_size, tb->pc,
+                           tcg_ctx->fies_instrumented);
+    }
+
 #ifdef CONFIG_PROFILER
     atomic_set(&prof->code_time, prof->code_time + profile_getclock() - ti);
     atomic_set(&prof->code_in_len, prof->code_in_len + tb->size);
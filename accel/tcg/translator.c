@@ -17,6 +17,9 @@
 #include "exec/gen-icount.h"
 #include "exec/log.h"
 #include "exec/translator.h"
+// CF FIES
+#include "fault-injection-stats.h"
+// CF FIES END
 
 /* Pairs with tcg_clear_temp_count.
    To be called by #TranslatorOps.{translate_insn,tb_stop} if
@@ -71,6 +74,11 @@ void translator_loop(const TranslatorOps *ops, DisasContextBase *db,
         db->num_insns++;
         ops->insn_start(db, cpu);
         tcg_debug_assert(db->is_jmp == DISAS_NEXT);  /* no early exit */
+// CF FIES
+        if (unlikely(fies_stats)) {
+            FIESER_stats_gen_count_insn();
+        }
+// CF FIES END
 
         /* Pass breakpoint hits to target for further processing */
         if (unlikely(!QTAILQ_EMPTY(&cpu->breakpoints))) {
@@ -25,6 +25,9 @@
 #include "exec/cpu_ldst.h"
 #include "translate-all.h"
 #include "exec/helper-proto.h"
+// CF FIES
+#include "fault-injection-controller.h"
+// CF FIES END
 
 #undef EAX
 #undef ECX
@@ -619,10 +622,44 @@ static void *atomic_mmu_lookup(CPUArchState *env, target_ulong addr,
     if (unlikely(addr & (size - 1))) {
         cpu_loop_exit_atomic(ENV_GET_CPU(env), retaddr);
     }
+    // CF FIES
+    /* Accesses to faulty memory are re-executed serially, with the
+       instrumented loads and stores.  */
+    if (unlikely(fies_enabled) && FIESER_mem_range_armed(addr, size)) {
+        cpu_loop_exit_atomic(ENV_GET_CPU(env), retaddr);
+    }
+    // CF FIES END
     helper_retaddr = retaddr;
     return g2h(addr);
 }
 
+// CF FIES
+/* The generated loads and stores access the host memory directly, hence
+   while memory faults are loaded, the translator passes the accessed
+   value through these helpers (see tcg_gen_qemu_ld_i64).  */
+uint64_t HELPER(fies_user_ld)(CPUArchState *env, target_ulong addr,
+                              uint64_t val, uint32_t memop)
+{
+    unsigned size = 1 << (memop & MO_SIZE);
+
+    val = FIESER_hook_mem(env, addr, extract64(val, 0, size * 8), size,
+                          (memop & MO_BSWAP) == MO_BE, read_access_type,
+                          FI_SITE_USER_EXEC);
+
+    return memop & MO_SIGN ? sextract64(val, 0, size * 8) : val;
+}
+
+uint64_t HELPER(fies_user_st)(CPUArchState *env, target_ulong addr,
+                              uint64_t val, uint32_t memop)
+{
+    unsigned size = 1 << (memop & MO_SIZE);
+
+    return FIESER_hook_mem(env, addr, extract64(val, 0, size * 8), size,
+                           (memop & MO_BSWAP) == MO_BE, write_access_type,
+                           FI_SITE_USER_EXEC);
+}
+// CF FIES END
+
 /* Macro to call the above, with local variables from the use context.  */
 #define ATOMIC_MMU_DECLS do {} while (0)
 #define ATOMIC_MMU_LOOKUP  atomic_mmu_lookup(env, addr, DATA_SIZE, GETPC())
@@ -3081,7 +3081,8 @@ MemTxResult address_space_read(AddressSpace *as, hwaddr addr,
 {
     // CF FIES	
     MemTxResult temp = flatview_read(address_space_to_flatview(as), addr, attrs, buf, len);
-    FIESER_hook(NULL, &addr, (uint32_t*)buf, FI_MEMORY_CONTENT, false);
+    FIESER_hook_mem_buf(NULL, addr, buf, len, read_access_type,
+                        FI_SITE_ADDRESS_SPACE_READ);
     return temp;
     //was: return flatview_read(address_space_to_flatview(as), addr, attrs, buf, len);
     // CF FIES	
@@ -3183,7 +3184,8 @@ static MemTxResult flatview_rw(FlatView *fv, hwaddr addr, MemTxAttrs attrs,
 {
     if (is_write) {
 // CF FIES
-        FIESER_hook(NULL, &addr, (uint32_t*)buf, FI_MEMORY_CONTENT, is_write);
+        FIESER_hook_mem_buf(NULL, addr, buf, len, write_access_type,
+                            FI_SITE_FLATVIEW_RW);
 // CF FIES END
         return flatview_write(fv, addr, attrs, (uint8_t *)buf, len);
     } else {
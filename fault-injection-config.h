@@ -14,14 +14,10 @@
 #define FAULT_INJECTION_CONFIG_H_
 
 /**
- * Uncomment the following define for activating debug output
- */
-//#define DEBUG_FAULT_CONTROLLER
-
-/**
- * Uncomment the following define for activating debug output
+ * Debug output of the fault controller is provided by the
+ * fies_* trace events (see trace-events), which can be
+ * enabled at runtime, e.g. with "-trace fies_*".
  */
-// #define DEBUG_FAULT_CONTROLLER_TLB_FLUSH
 
 /**
  * Defines the width of the memory interface (in this
@@ -31,6 +27,62 @@
  */
 #define MEMORY_WIDTH 16
 
+/**
+ * Defines the maximal width of a cell in bits, i.e. the
+ * width of the fault mask. Memory cells wider than
+ * MEMORY_WIDTH are selected per fault with <width>.
+ */
+#define MAX_CELL_WIDTH 64
+
+/**
+ * Defines the maximal bit interleaving factor of a memory
+ * array, i.e. the number of cells sharing a physical row
+ * in multi-cell upsets (see <interleave>).
+ */
+#define MAX_INTERLEAVE 64
+
+/**
+ * The register numbers of the floating-point and SIMD register file.
+ * Registers below FI_REG_VFP_S0, which are not a core register, select
+ * the CPSR (PSTATE in AArch64 state). S32-S63 are the halves of D16-D31,
+ * which are only accessed by NEON instructions. A Q register covers two
+ * D registers, the mask of its faults is applied to both halves.
+ */
+#define FI_REG_VFP_S0   64
+#define FI_REG_VFP_D0   128
+#define FI_REG_VFP_Q0   192
+#define FI_REG_VFP_END  208
+#define FI_REG_FPSCR    224
+
+/**
+ * The register numbers of the banked SP, LR and SPSR of the AArch32
+ * modes, in the order of the register banks: usr/sys, svc, abt, und,
+ * irq, fiq, hyp and mon. The registers of the bank of the current mode
+ * are the ones accessed as r13, r14 and the SPSR.
+ */
+#define FI_REG_BANKED_SP    232
+#define FI_REG_BANKED_LR    240
+#define FI_REG_BANKED_SPSR  248
+#define FI_REG_BANKED_END   256
+
+/**
+ * The register numbers of the main and the process stack pointer of the
+ * current security state of M-profile CPUs. The one in use is the one
+ * accessed as r13. On M-profile CPUs, the registers from 16 on, which
+ * select the CPSR otherwise, select the xPSR.
+ */
+#define FI_REG_M_MSP        256
+#define FI_REG_M_PSP        257
+#define FI_REG_M_END        258
+
+/**
+ * Register numbers from FI_REG_CP on select a coprocessor or system
+ * register by the key of its ARMCPRegInfo (ENCODE_CP_REG() and
+ * ENCODE_AA64_CP_REG() in target/arm/cpu.h) without the non-secure
+ * bank bit.
+ */
+#define FI_REG_CP           0x10000
+
 /**
  * Uncomment the following define for activating debug output
  */
@@ -60,6 +112,24 @@ extern unsigned int file_input_to_use;
 extern unsigned int file_input_to_use_address;
 extern char *fault_library_name;
 
+/**
+ * Set by FIESER_enable() once QEMU runs with fault injection or
+ * profiling. While it is clear, the hook sites return immediately
+ * and the translator emits no fault controller helpers.
+ */
+extern bool fies_enabled;
+
+/**
+ * see fault-injection-dcls.c for documentation
+ */
+extern bool fies_dcls;
+
+/**
+ * see fault-injection-controller.c for documentation
+ */
+extern void FIESER_enable(void);
+extern void FIESER_init(void);
+
 
 extern FILE *outfile;
 
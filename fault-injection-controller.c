@@ -16,28 +16,45 @@
 #include "fault-injection-data-analyzer.h"
 #include "fault-injection-config.h"
 #include "fault-injection-profiler.h"
+#include "fault-injection-stats.h"
+#include "fault-injection-overhead.h"
+#include "fault-injection-index.h"
+#include "fault-injection-coupling.h"
+#include "fault-injection-history.h"
+#include "fault-injection-nvic.h"
+#include "fault-injection-irq.h"
+#include "fault-injection-ptimer.h"
+#include "fault-injection-ecc.h"
+#include "fault-injection-dcls.h"
 
 #include "qemu/osdep.h"
 #include "qemu-common.h"
 #include "qemu/config-file.h"
+#include "qapi/error.h"
 #include "qemu/timer.h"
+#include "qemu/host-utils.h"
 #include "include/monitor/monitor.h"
 #include "hmp.h"
+#include "sysemu/reset.h"
+#include "translate-all.h"
+#include "trace-root.h"
 
 //#define DEBUG_FAULT_INJECTION
 
 /**
  * State of the different CPUs
  */
-static CPUState *next_cpu;
 int shutting_down = false;
     
+#if !defined(CONFIG_USER_ONLY)
 static Monitor *qemu_serial_monitor;
+#endif
 //unsigned int sbst_cycle_count_address = 0;
 //unsigned int fault_counter_address = 0;
 unsigned int file_input_to_use = 0;
 unsigned int file_input_to_use_address = 0;
 char *fault_library_name;
+bool fies_enabled;
 
 /**
  * Maybe useless
@@ -45,99 +62,80 @@ char *fault_library_name;
 static hwaddr address_in_use = UINT64_MAX;
 
 /**
- * The timer value, which controls the time-triggered
- * fault injection experiments.
- */
-static int64_t timer_value = 0;
-
-/**
- * Array, which stores the previous
- * memory cell operations for
- * dynamic faults.
- */
-static int **ops_on_memory_cell;
-
-/**
- * Array, which stores the previous
- * register cell operations for
- * dynamic faults.
+ * A pending look-up error, which replaces the next instruction
+ * dispatched at pc (or at any pc) once, when it is translated.
  */
-static int **ops_on_register_cell;
+static struct {
+    bool pending;
+    bool any_pc;
+    target_ulong pc;
+    uint32_t insn;
+    int id;
+} lookup_error;
 
 /**
- * Declares the different types of previous
- * cell operations for dynamic faults.
+ * The timer value, which controls the time-triggered
+ * fault injection experiments.
  */
-typedef enum
-{
-    OPs_0w0,
-    OPs_0w1,
-    OPs_1w0,
-    OPs_1w1,
-} CellOps;
+static int64_t timer_value = 0;
 
 /**
- * Allocates and initializes the ops_on_memory_cell- and
- * ops_on_register_cell-array.
+ * Reads the content of a specified register (r0-r15 and the CPSR
+ * otherwise in AArch32 state, x0-x30, SP and the PSTATE otherwise in
+ * AArch64 state, see FI_REG_VFP_S0 for the FP/SIMD registers,
+ * FI_REG_BANKED_SP for the banked registers, FI_REG_M_MSP for the
+ * M-profile stack pointers and FI_REG_CP for the coprocessor registers).
  *
- * @param[in] ids - the maximal id number.
+ * @param[in] env - the information of the CPU-state.
+ * @param[in] regno - the register address
+ * @param[out] - the content of  the specified register.
  */
-void FIESER_helper_init_ops_on_cell(int ids)
+static uint64_t FIESER_helper_read_cpu_register(CPUArchState *env, hwaddr regno)
 {
-    int i = 0, j = 0;
-
-    ops_on_memory_cell = malloc(ids * sizeof (int *));
-    ops_on_register_cell = malloc(ids * sizeof (int *));
+#if defined(TARGET_ARM)
+    uint64_t value = 0;
 
-    for (i = 0; i < ids; i++)
+    if (regno >= FI_REG_CP)
     {
-        ops_on_memory_cell[i] = malloc(MEMORY_WIDTH * sizeof (int *));
-        ops_on_register_cell[i] = malloc(MEMORY_WIDTH * sizeof (int *));
+        arm_fies_read_cpreg(env, regno, &value);
+        return value;
     }
 
-    for (i = 0; i < ids; i++)
-    {
-        for (j = 0; j < MEMORY_WIDTH; j++)
-        {
-            ops_on_memory_cell[i][j] = -1;
-            ops_on_register_cell[i][j] = -1;
-        }
-    }
+    if (do_inject_is_banked_register(regno))
+        return do_inject_read_banked_register(env, regno);
 
-}
+    if (do_inject_is_m_sp_register(regno))
+        return do_inject_read_m_sp_register(env, regno);
 
-/**
- * Deletes the ops_on_memory_cell- and
- * ops_on_register_cell-array.
- */
-void FIESER_helper_destroy_ops_on_cell(void)
-{
-    int i = 0;
+    if (regno >= FI_REG_VFP_S0)
+        return do_inject_is_vfp_register(regno) ? do_inject_read_vfp_register(env, regno) : 0;
 
-    for (i = 0; i < getMaxIDInFaultList(); i++)
-    {
-        free(ops_on_memory_cell[i]);
-        free(ops_on_register_cell[i]);
-    }
+    if (is_a64(env))
+        return regno < 32 ? env->xregs[regno] : pstate_read(env);
+
+    if (regno < 16)
+        return env->regs[regno];
 
-    free(ops_on_memory_cell);
-    free(ops_on_register_cell);
+    return arm_feature(env, ARM_FEATURE_M) ? xpsr_read(env) : cpsr_read(env);
+#else
+#error unsupported target CPU
+#endif
 }
 
 /**
- * Reads the content of a specified register.
+ * Reads the content of a specified memory cell.
  *
  * @param[in] env - the information of the CPU-state.
- * @param[in] regno - the register address
- * @param[out] - the content of  the specified register.
+ * @param[in] addr - the address of the memory cell.
+ * @param[out] - the content of the specified memory cell.
  */
-static uint32_t FIESER_helper_read_cpu_register(CPUArchState *env, hwaddr regno)
+static uint32_t FIESER_helper_read_memory_cell(CPUArchState *env, hwaddr addr)
 {
-#if defined(TARGET_ARM)
-    return ((CPUARMState *) env)->regs[(int) regno];
-#else
-#error unsupported target CPU
-#endif
+    uint32_t memword = 0;
+
+    cpu_memory_rw_debug(ENV_GET_CPU(env), addr, (uint8_t *) &memword,
+                        (MEMORY_WIDTH / 8), 0);
+    return memword;
 }
 
 /**
@@ -228,6 +226,54 @@ void FIESER_timer_init(void)
     timer_value = qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL);
 }
 
+/**
+ * Flushes a page from the TLB and accounts the host cycles spent,
+ * if hook overhead timing is enabled.
+ *
+ * @param[in] cpu - the CPU, whose TLB is flushed.
+ * @param[in] addr - an address within the flushed page.
+ */
+static void FIESER_tlb_flush_page(CPUState *cpu, target_ulong addr)
+{
+    int64_t start;
+
+    trace_fies_tlb_flush(addr);
+
+    if (likely(!profile_hook_overhead))
+    {
+        tlb_flush_page(cpu, addr);
+        return;
+    }
+
+    start = cpu_get_host_ticks();
+    tlb_flush_page(cpu, addr);
+    FIESER_overhead_phase_end(FI_OVERHEAD_TLB_FLUSH, start);
+}
+
+/**
+ * Injects all bits set in the fault mask in a single operation and increments
+ * the counter for the single fault types in the analyzer-module.
+ *
+ * @param[in] env - Reference to the information of the CPU state.
+ * @param[in] addr - the address or the buffer, where the fault is injected.
+ * @param[in] fault - pointer to the linked list entry.
+ * @param[in] fi_info - information for performing faults.
+ * @param[in] type - the fault type, which is counted.
+ */
+static void FIESER_inject_mask(CPUArchState *env, hwaddr *addr,
+                               FaultList *fault, FaultInjectionInfo fi_info,
+                               enum FaultType type)
+{
+    fi_info.mask = fault->params.mask;
+    fi_info.bit_value = fault->params.set_bit;
+    do_inject_memory_register(env, addr, fi_info);
+
+    if (fi_info.fault_on_register)
+        incr_num_injected_faults(fault->id, FI_COMP_REGISTER, type);
+    else
+        incr_num_injected_faults(fault->id, FI_COMP_RAM, type);
+}
+
 /**
  * Sets bit-flip faults active for the different triggering-methods, extract the necessary
  * information (e.g. set bits in the fault mask), calls the appropriate functions in the
@@ -246,40 +292,18 @@ static void FIESER_inject_bitflip(CPUArchState *env, hwaddr *addr,
                                   uint32_t pc)
 {
     int64_t current_timer_value = 0;
-    int mask = fault->params.mask, set_bit = 0;
 
     fi_info.bit_flip = 1;
+    fi_info.width = fault->params.width;
+    fi_info.burst = fault->params.burst;
+    fi_info.interleave = fault->params.interleave;
+    fi_info.column = fault->params.column;
 
     if (fault->trigger == FI_TRGR_PC)
     {
         if (pc == fault->params.address)
         {
-            /**
-             * search the set bits in mask (integer)
-             */
-            while (mask)
-            {
-                /**
-                 * extract least significant bit of 2s complement
-                 */
-                set_bit = mask & -mask;
-
-                /**
-                 * toggle the bit off
-                 */
-                mask ^= set_bit;
-
-                /**
-                 * determine the position of the set bit
-                 */
-                fi_info.injected_bit = log2(set_bit);
-                do_inject_memory_register(env, addr, fi_info);
-
-                if (fi_info.fault_on_register)
-                    incr_num_injected_faults(fault->id, FI_COMP_REGISTER, FI_TYPE_TRANSIENT);
-                else
-                    incr_num_injected_faults(fault->id, FI_COMP_RAM, FI_TYPE_TRANSIENT);
-            }
+            FIESER_inject_mask(env, addr, fault, fi_info, FI_TYPE_TRANSIENT);
             fault->was_triggered = 1;
         }
         else
@@ -294,32 +318,7 @@ static void FIESER_inject_bitflip(CPUArchState *env, hwaddr *addr,
         if (current_timer_value > fault->timer
                 && current_timer_value < fault->duration)
         {
-            /**
-             * search the set bits in mask (integer)
-             */
-            while (mask)
-            {
-                /**
-                 * extract least significant bit of 2s complement
-                 */
-                set_bit = mask & -mask;
-
-                /**
-                 * toggle the bit off
-                 */
-                mask ^= set_bit;
-
-                /**
-                 * determine the position of the set bit
-                 */
-                fi_info.injected_bit = log2(set_bit);
-                do_inject_memory_register(env, addr, fi_info);
-
-                if (fi_info.fault_on_register)
-                    incr_num_injected_faults(fault->id, FI_COMP_REGISTER, FI_TYPE_TRANSIENT);
-                else
-                    incr_num_injected_faults(fault->id, FI_COMP_RAM, FI_TYPE_TRANSIENT);
-            }
+            FIESER_inject_mask(env, addr, fault, fi_info, FI_TYPE_TRANSIENT);
             fault->was_triggered = 1;
         }
         else
@@ -335,32 +334,7 @@ static void FIESER_inject_bitflip(CPUArchState *env, hwaddr *addr,
                 && current_timer_value < fault->duration
                 && (current_timer_value / fault->interval) % 2 == 0)
         {
-            /**
-             * search the set bits in mask (integer)
-             */
-            while (mask)
-            {
-                /**
-                 * extract least significant bit of 2s complement
-                 */
-                set_bit = mask & -mask;
-
-                /**
-                 * toggle the bit off
-                 */
-                mask ^= set_bit;
-
-                /**
-                 * determine the position of the set bit
-                 */
-                fi_info.injected_bit = log2(set_bit);
-                do_inject_memory_register(env, addr, fi_info);
-
-                if (fi_info.fault_on_register)
-                    incr_num_injected_faults(fault->id, FI_COMP_REGISTER, FI_TYPE_TRANSIENT);
-                else
-                    incr_num_injected_faults(fault->id, FI_COMP_RAM, FI_TYPE_TRANSIENT);
-            }
+            FIESER_inject_mask(env, addr, fault, fi_info, FI_TYPE_TRANSIENT);
             fault->was_triggered = 1;
         }
         else
@@ -370,32 +344,7 @@ static void FIESER_inject_bitflip(CPUArchState *env, hwaddr *addr,
     }
     else if (fault->type == FI_TYPE_PERMANENT)
     {
-        /**
-         * search the set bits in mask (integer)
-         */
-        while (mask)
-        {
-            /**
-             * extract least significant bit of 2s complement
-             */
-            set_bit = mask & -mask;
-
-            /**
-             * toggle the bit off
-             */
-            mask ^= set_bit;
-
-            /**
-             * determine the position of the set bit
-             */
-            fi_info.injected_bit = log2(set_bit);
-            do_inject_memory_register(env, addr, fi_info);
-
-            if (fi_info.fault_on_register)
-                incr_num_injected_faults(fault->id, FI_COMP_REGISTER, FI_TYPE_PERMANENT);
-            else
-                incr_num_injected_faults(fault->id, FI_COMP_RAM, FI_TYPE_PERMANENT);
-        }
+        FIESER_inject_mask(env, addr, fault, fi_info, FI_TYPE_PERMANENT);
         fault->was_triggered = 1;
     }
     else
@@ -468,6 +417,32 @@ static void FIESER_check_fault_trigger(FaultList *fault, enum FaultComponent fau
 
 }
 
+/**
+ * Checks if an access-triggered fault is active at the current time. Unlike
+ * FIESER_check_fault_trigger, an active fault is not counted as injected, as
+ * the caller may not inject it on every access.
+ *
+ * @param[in] fault - pointer to the linked list entry.
+ * @param[out] - true if the fault is active.
+ */
+bool FIESER_fault_active(FaultList *fault)
+{
+    int64_t current_timer_value;
+
+    if (fault->type == FI_TYPE_PERMANENT)
+        return true;
+
+    current_timer_value = FIESER_timer_get();
+
+    if (current_timer_value <= fault->timer
+            || current_timer_value >= fault->duration)
+        return false;
+
+    return fault->type == FI_TYPE_TRANSIENT
+            || (fault->type == FI_TYPE_INTERMITTENT
+                && (current_timer_value / fault->interval) % 2 == 0);
+}
+
 /**
  * Sets new-value faults active for the different triggering-methods, prepares the necessary
  * information (e.g. copy new-value to bit_value), calls the appropriate functions in the
@@ -489,6 +464,10 @@ static void FIESER_inject_new_value(CPUArchState *env, hwaddr *addr,
 
     fi_info.bit_flip = 0;
     fi_info.new_value = 1;
+    fi_info.width = fault->params.width;
+    fi_info.burst = fault->params.burst;
+    fi_info.interleave = fault->params.interleave;
+    fi_info.column = fault->params.column;
 
     if (fault->trigger == FI_TRGR_PC)
     {
@@ -615,49 +594,18 @@ static void FIESER_inject_state_register(CPUArchState *env, hwaddr *addr,
                                          uint32_t pc)
 {
     int64_t current_timer_value = 0;
-    int mask = fault->params.mask, set_bit = 0;
 
     fi_info.bit_flip = 0;
+    fi_info.width = fault->params.width;
+    fi_info.burst = fault->params.burst;
+    fi_info.interleave = fault->params.interleave;
+    fi_info.column = fault->params.column;
 
     if (fault->trigger == FI_TRGR_PC)
     {
         if (pc == fault->params.address)
         {
-            /**
-             * search the set bits in mask (integer)
-             */
-            while (mask)
-            {
-                /**
-                 * extract least significant bit of 2s complement
-                 */
-                set_bit = mask & -mask;
-
-                /**
-                 * toggle the bit off
-                 */
-                mask ^= set_bit;
-
-                /**
-                 * determine the position of the set bit
-                 */
-                fi_info.injected_bit = log2(set_bit);
-
-                /**
-                 * copy the information, if a bit should be set or reset, which is stored
-                 * in the set_bit-variable of the linked list to the bit-value-variable of
-                 * the FaultInjectionInfo struct, if the mask is set at this position.
-                 * The double negation (!!) is used to convert an integer to a single
-                 * logical value (0 or 1).
-                 */
-                fi_info.bit_value = !!(fault->params.set_bit & set_bit);
-                do_inject_memory_register(env, addr, fi_info);
-
-                if (fi_info.fault_on_register)
-                    incr_num_injected_faults(fault->id, FI_COMP_REGISTER, FI_TYPE_TRANSIENT);
-                else
-                    incr_num_injected_faults(fault->id, FI_COMP_RAM, FI_TYPE_TRANSIENT);
-            }
+            FIESER_inject_mask(env, addr, fault, fi_info, FI_TYPE_TRANSIENT);
             fault->was_triggered = 1;
         }
         else
@@ -672,41 +620,7 @@ static void FIESER_inject_state_register(CPUArchState *env, hwaddr *addr,
         if (current_timer_value > fault->timer
                 && current_timer_value < fault->duration)
         {
-            /**
-             * search the set bits in mask (integer)
-             */
-            while (mask)
-            {
-                /**
-                 * extract least significant bit of 2s complement
-                 */
-                set_bit = mask & -mask;
-
-                /**
-                 * toggle the bit off
-                 */
-                mask ^= set_bit;
-
-                /**
-                 * determine the position of the set bit
-                 */
-                fi_info.injected_bit = log2(set_bit);
-
-                /**
-                 * copy the information, if a bit should be set or reset, which is stored
-                 * in the set_bit-variable of the linked list to the bit-value-variable of
-                 * the FaultInjectionInfo struct, if the mask is set at this position.
-                 * The double negation (!!) is used to convert an integer to a single
-                 * logical value (0 or 1).
-                 */
-                fi_info.bit_value = !!(fault->params.set_bit & set_bit);
-                do_inject_memory_register(env, addr, fi_info);
-
-                if (fi_info.fault_on_register)
-                    incr_num_injected_faults(fault->id, FI_COMP_REGISTER, FI_TYPE_TRANSIENT);
-                else
-                    incr_num_injected_faults(fault->id, FI_COMP_RAM, FI_TYPE_TRANSIENT);
-            }
+            FIESER_inject_mask(env, addr, fault, fi_info, FI_TYPE_TRANSIENT);
             fault->was_triggered = 1;
         }
         else
@@ -722,41 +636,7 @@ static void FIESER_inject_state_register(CPUArchState *env, hwaddr *addr,
                 && current_timer_value < fault->duration
                 && (current_timer_value / fault->interval) % 2 == 0)
         {
-            /**
-             * search the set bits in mask (integer)
-             */
-            while (mask)
-            {
-                /**
-                 * extract least significant bit of 2s complement
-                 */
-                set_bit = mask & -mask;
-
-                /**
-                 * toggle the bit off
-                 */
-                mask ^= set_bit;
-
-                /**
-                 * determine the position of the set bit
-                 */
-                fi_info.injected_bit = log2(set_bit);
-
-                /**
-                 * copy the information, if a bit should be set or reset, which is stored
-                 * in the set_bit-variable of the linked list to the bit-value-variable of
-                 * the FaultInjectionInfo struct, if the mask is set at this position.
-                 * The double negation (!!) is used to convert an integer to a single
-                 * logical value (0 or 1).
-                 */
-                fi_info.bit_value = !!(fault->params.set_bit & set_bit);
-                do_inject_memory_register(env, addr, fi_info);
-
-                if (fi_info.fault_on_register)
-                    incr_num_injected_faults(fault->id, FI_COMP_REGISTER, FI_TYPE_TRANSIENT);
-                else
-                    incr_num_injected_faults(fault->id, FI_COMP_RAM, FI_TYPE_TRANSIENT);
-            }
+            FIESER_inject_mask(env, addr, fault, fi_info, FI_TYPE_TRANSIENT);
             fault->was_triggered = 1;
         }
         else
@@ -766,21 +646,7 @@ static void FIESER_inject_state_register(CPUArchState *env, hwaddr *addr,
     }
     else if (fault->type == FI_TYPE_PERMANENT)
     {
-        /* search the set bits in mask (integer) */
-        while (mask)
-        {
-            set_bit = mask & -mask; // extract least significant bit of 2s complement
-            mask ^= set_bit; // toggle the bit off
-
-            fi_info.injected_bit = (uint32_t) log2(set_bit); // determine the position of the set bit
-            fi_info.bit_value = !!(fault->params.set_bit & set_bit); // determine if bit should be set or reset
-            do_inject_memory_register(env, addr, fi_info);
-
-            if (fi_info.fault_on_register)
-                incr_num_injected_faults(fault->id, FI_COMP_REGISTER, FI_TYPE_PERMANENT);
-            else
-                incr_num_injected_faults(fault->id, FI_COMP_RAM, FI_TYPE_PERMANENT);
-        }
+        FIESER_inject_mask(env, addr, fault, fi_info, FI_TYPE_PERMANENT);
         fault->was_triggered = 1;
     }
     else
@@ -800,6 +666,7 @@ static void FIESER_controller_memory_address(CPUArchState *env, hwaddr *addr)
 {
     FaultList *fault;
     int element = 0;
+    hwaddr before;
     FaultInjectionInfo fi_info = {0, 0, 0, 0, 0, 0, 0};
     ARMCPU *cpu = arm_env_get_cpu(env);
 
@@ -807,10 +674,7 @@ static void FIESER_controller_memory_address(CPUArchState *env, hwaddr *addr)
     {
         fault = getFaultListElement(element);
 
-#if defined(DEBUG_FAULT_CONTROLLER_TLB_FLUSH)
-        printf("flushing tlb address %x\n", (int) *addr);
-#endif
-        tlb_flush_page(CPU(cpu), (target_ulong) * addr);
+        FIESER_tlb_flush_page(CPU(cpu), (target_ulong) * addr);
 
 
 
@@ -833,10 +697,7 @@ static void FIESER_controller_memory_address(CPUArchState *env, hwaddr *addr)
             fi_info.bit_flip = 0;
             fi_info.fault_on_address = 1;
             fi_info.fault_on_register = 0;
-
-#if defined(DEBUG_FAULT_CONTROLLER)
-            printf("memory address before: 0x%08x\n", (uint32_t) * addr);
-#endif
+            before = *addr;
 
             if (fault->mode == FI_MODE_BITFLIP)
                 FIESER_inject_bitflip(env, addr, fault, fi_info, 0);
@@ -845,9 +706,8 @@ static void FIESER_controller_memory_address(CPUArchState *env, hwaddr *addr)
             else if (fault->mode == FI_MODE_STATE_FAULT)
                 FIESER_inject_state_register(env, addr, fault, fi_info, 0);
 
-#if defined(DEBUG_FAULT_CONTROLLER)
-            printf("memory address after: 0x%08x\n", (uint32_t) * addr);
-#endif
+            trace_fies_memory_address(fault->id, before, *addr,
+                                      fault->was_triggered);
         }
 
         //      tlb_flush_page(env, (target_ulong)fault->params.address);
@@ -861,14 +721,15 @@ static void FIESER_controller_memory_address(CPUArchState *env, hwaddr *addr)
  *
  * @param[in] env - Reference to the information of the CPU state.
  * @param[in] fault - pointer to the linked list entry.
- * @param[in] addr - the address of the accessed cell.
- * @param[in] value -  the value or buffer, which should be written to memory.
+ * @param[in] value -  the value, which should be written to the memory cell.
+ * @param[in] covered - the bits of the memory cell, which are written by the access.
  * @param[in] access_type - if the access-operation is a write, read or execute.
  */
-static void FIESER_helper_log_cell_operations_memory(CPUArchState *env, FaultList *fault, hwaddr *addr,
-                                                     uint32_t *value, AccessType access_type)
+static void FIESER_helper_log_cell_operations_memory(CPUArchState *env, FaultList *fault,
+                                                     uint64_t value, uint64_t covered,
+                                                     AccessType access_type)
 {
-    unsigned memword = 0, mask = 0, set_bit, bit_pos = 0, id = 0;
+    uint64_t memword = 0;
 
     /**
      * only a write access can trigger a dynamic fault
@@ -877,153 +738,205 @@ static void FIESER_helper_log_cell_operations_memory(CPUArchState *env, FaultLis
     {
         uint8_t *membytes = (uint8_t *) & memword;
         CPUState *cpu = ENV_GET_CPU(env);
-        cpu_memory_rw_debug(cpu, *addr, membytes, (MEMORY_WIDTH / 8), 0);
+        cpu_memory_rw_debug(cpu, (uint32_t) fault->params.address, membytes,
+                            fault->params.width / 8, 0);
 
-        mask = fault->params.mask;
+        FIESER_history_record(fault, do_inject_memory_load(membytes, fault->params.width / 8),
+                              value, covered);
+    }
+}
 
-        /**
-         * search the set bits in mask (integer)
-         */
-        while (mask)
-        {
-            /**
-             * extract least significant bit of 2s complement
-             */
-            set_bit = mask & -mask;
+/**
+ * Assembles the content of a memory cell from the bytes of an access, which
+ * overlaps the cell. Bytes of the cell outside of the access read as zero.
+ *
+ * @param[in] cell_addr - the address of the memory cell.
+ * @param[in] size - the width of the memory cell in bytes.
+ * @param[in] addr - the first accessed address.
+ * @param[in] buf - the accessed bytes in guest memory order.
+ * @param[in] len - the length of the access in bytes.
+ * @param[out] covered - the bits of the cell, which are covered by the access.
+ * @param[out] - the content of the memory cell.
+ */
+static uint64_t FIESER_helper_cell_gather(hwaddr cell_addr, unsigned size,
+                                          hwaddr addr, const uint8_t *buf,
+                                          hwaddr len, uint64_t *covered)
+{
+    uint8_t cell[8] = {0}, mask[8] = {0};
+    hwaddr lo = MAX(cell_addr, addr);
+    hwaddr hi = MIN(cell_addr + size, addr + len);
 
-            /**
-             * toggle the bit off
-             */
-            mask ^= set_bit;
+    memcpy(cell + (lo - cell_addr), buf + (lo - addr), hi - lo);
+    memset(mask + (lo - cell_addr), 0xff, hi - lo);
+    *covered = do_inject_memory_load(mask, size);
 
-            /**
-             * determine the position of the set bit
-             */
-            bit_pos = (uint32_t) log2(set_bit);
-            id = fault->id - 1;
-
-            if (!!(memword & set_bit) == 0 && !!(*value & set_bit) == 0)
-                ops_on_memory_cell[id][bit_pos] = OPs_0w0;
-            else if (!!(memword & set_bit) == 0 && !!(*value & set_bit) == 1)
-                ops_on_memory_cell[id][bit_pos] = OPs_0w1;
-            else if (!!(memword & set_bit) == 1 && !!(*value & set_bit) == 0)
-                ops_on_memory_cell[id][bit_pos] = OPs_1w0;
-            else if (!!(memword & set_bit) == 1 && !!(*value & set_bit) == 1)
-                ops_on_memory_cell[id][bit_pos] = OPs_1w1;
-            else
-                ops_on_memory_cell[id][bit_pos] = -1;
-        }
-    }
+    return do_inject_memory_load(cell, size);
 }
 
 /**
- * Iterates through the linked list and checks if an entry or element belongs to
- * a fault in the memory cells of the main memory (RAM) and if the accessed
- * address is defined in the XML-file.
+ * Writes the bytes of a memory cell, which are covered by an access, back to
+ * the bytes of the access.
+ *
+ * @param[in] cell_addr - the address of the memory cell.
+ * @param[in] size - the width of the memory cell in bytes.
+ * @param[in] addr - the first accessed address.
+ * @param[in] buf - the accessed bytes in guest memory order.
+ * @param[in] len - the length of the access in bytes.
+ * @param[in] value - the content of the memory cell.
+ */
+static void FIESER_helper_cell_scatter(hwaddr cell_addr, unsigned size,
+                                       hwaddr addr, uint8_t *buf,
+                                       hwaddr len, uint64_t value)
+{
+    uint8_t cell[8];
+    hwaddr lo = MAX(cell_addr, addr);
+    hwaddr hi = MIN(cell_addr + size, addr + len);
+
+    do_inject_memory_store(cell, size, value);
+    memcpy(buf + (lo - addr), cell + (lo - cell_addr), hi - lo);
+}
+
+/**
+ * Injects an access-triggered fault into the memory cell of the fault, as far
+ * as the cell is covered by the access. The cell is assembled from the accessed
+ * bytes (bytes outside of the access read as zero), injected as a whole and
+ * only the accessed bytes are written back. Hence, byte and halfword accesses
+ * to a wider cell and accesses spanning several cells see exactly the bits of
+ * the cell they transfer.
  *
  * @param[in] env - Reference to the information of the CPU state.
- * @param[in] addr - the address of the accessed cell.
- * @param[in] value -  the value or buffer, which should be written to register.
+ * @param[in] fault - pointer to the linked list entry.
+ * @param[in] addr - the first accessed address.
+ * @param[in] buf - the accessed bytes in guest memory order.
+ * @param[in] len - the length of the access in bytes.
  * @param[in] access_type - if the access-operation is a write, read or execute.
  */
-static void FIESER_controller_memory_content(CPUArchState *env, hwaddr *addr,
-                                             uint32_t *value, AccessType access_type)
+static void FIESER_controller_memory_cell(CPUArchState *env, FaultList *fault,
+                                          hwaddr addr, uint8_t *buf, hwaddr len,
+                                          AccessType access_type)
 {
-    FaultList *fault;
-    int element = 0;
     FaultInjectionInfo fi_info = {0, 0, 0, 0, 0, 0, 0};
-    ARMCPU *cpu = arm_env_get_cpu(env);
+    hwaddr cell_addr = (uint32_t) fault->params.address;
+    unsigned size = fault->params.width / 8;
+    uint64_t value, before, covered;
 
-    for (element = 0; element < getNumFaultListElements(); element++)
-    {
-        fault = getFaultListElement(element);
+    value = before = FIESER_helper_cell_gather(cell_addr, size, addr, buf, len,
+                                               &covered);
 
+    /* set/reset values */
+    fi_info.access_triggered_content_fault = 1;
 
-        /*
-         * accessed address is not the defined fault address or the trigger is set to
-         * time- or pc-triggering.
-         */
-        if (fault->params.address != (int) *addr
-                || fault->trigger != FI_TRGR_ACCESS)
-        {
-            continue;
-        }
+    FIESER_helper_log_cell_operations_memory(env, fault, value, covered,
+                                             access_type);
 
-#if defined(DEBUG_FAULT_CONTROLLER_TLB_FLUSH)
-        printf("flushing tlb address %x\n", (int) *addr);
-#endif
-        tlb_flush_page(CPU(cpu), (target_ulong) * addr);
+    if (fault->mode == FI_MODE_BITFLIP)
+        FIESER_inject_bitflip(env, &value, fault, fi_info, 0);
+    else if (fault->mode == FI_MODE_NEW_VALUE)
+        FIESER_inject_new_value(env, &value, fault, fi_info, 0);
+    else if (fault->mode == FI_MODE_STATE_FAULT)
+        FIESER_inject_state_register(env, &value, fault, fi_info, 0);
 
-        if (fault->component == FI_COMP_RAM
-                && (fault->target == FI_TAGT_MEMORY_CELL || fault->target == FI_TAGT_RW_LOGIC))
-        {
-#if defined(DEBUG_FAULT_CONTROLLER)
-            printf("FAULT INJECTED TRIGGERED TO %x with addr %x \n", (int) *addr, fault->params.address);
-#endif
-            /* set/reset values */
-            fi_info.new_value = 0;
-            fi_info.bit_flip = 0;
-            fi_info.fault_on_address = 0;
-            fi_info.access_triggered_content_fault = 1;
-            fi_info.fault_on_register = 0;
+    FIESER_helper_cell_scatter(cell_addr, size, addr, buf, len, value);
 
-            FIESER_helper_log_cell_operations_memory(env, fault, addr, value, access_type);
+    trace_fies_memory_content(fault->id, cell_addr, access_type,
+                              before, value, fault->was_triggered);
 
-#if defined(DEBUG_FAULT_CONTROLLER)
-            printf("-----------------------START-------------------------------\n");
-            if (access_type == read_access_type)
-                printf("value read from cell before fault injection: 0x%08x\n", *value);
-            else if (access_type == write_access_type)
-                printf("value to write into cell before fault injection: 0x%08x\n", *value);
-#endif
+    if (fault->params.cf_address != -1
+            && trace_event_get_state_backends(TRACE_FIES_COUPLED_CELL))
+    {
+        trace_fies_coupled_cell(fault->id, fault->params.cf_address,
+                                FIESER_helper_read_memory_cell(env, fault->params.cf_address));
+    }
+}
 
-            if (fault->mode == FI_MODE_BITFLIP)
-            {
-                uint64_t value64 = *value;
-                FIESER_inject_bitflip(env, &value64, fault, fi_info, 0);
-                *value = value64;
-            }
-            else if (fault->mode == FI_MODE_NEW_VALUE)
-            {
-                uint64_t value64 = *value;
-                FIESER_inject_new_value(env, &value64, fault, fi_info, 0);
-                *value = value64;
-            }
-            else if (fault->mode == FI_MODE_STATE_FAULT)
-            {
-                uint64_t value64 = *value;
-                FIESER_inject_state_register(env, &value64, fault, fi_info, 0);
-                *value = value64;
-            }
+/**
+ * Keeps the memory cells of permanent stuck-at faults stuck, when they are
+ * written. The stuck bits were patched into the memory at activation (see
+ * FIESER_activate_permanent_faults), so reads need no interception and only
+ * the written value has to be filtered. The injection was already counted
+ * at activation.
+ *
+ * @param[in] addr - the first written address.
+ * @param[in] buf - the written bytes in guest memory order.
+ * @param[in] len - the length of the access in bytes.
+ */
+static void FIESER_controller_write_filter(hwaddr addr, uint8_t *buf, hwaddr len)
+{
+    FaultList *fault;
+    int pos = FIESER_index_lookup(FI_INDEX_WRITE_FILTER, addr, len);
+    hwaddr cell_addr;
+    unsigned size;
+    uint64_t value, before, covered, mask;
 
-#if defined(DEBUG_FAULT_CONTROLLER)
-            unsigned memword = 0;
-            uint8_t *membytes = (uint8_t *) & memword;
-            CPUState *cpu = ENV_GET_CPU(env);
+    while ((fault = FIESER_index_next(FI_INDEX_WRITE_FILTER, addr, &pos)))
+    {
+        cell_addr = (uint32_t) fault->params.address;
+        size = fault->params.width / 8;
+        mask = fault->params.mask;
 
-            if (fault->params.cf_address != -1)
-            {
-                cpu_memory_rw_debug(cpu, fault->params.cf_address, membytes, (MEMORY_WIDTH / 8), 0);
-                printf("coupled cell content after fault injection: 0x%08x\n", memword);
-            }
+        value = before = FIESER_helper_cell_gather(cell_addr, size, addr, buf,
+                                                   len, &covered);
+        value = (value & ~mask) | (fault->params.set_bit & mask);
+        FIESER_helper_cell_scatter(cell_addr, size, addr, buf, len, value);
 
-            if (access_type == read_access_type)
-                printf("value read from cell after fault injection: 0x%08x\n", *value);
-            else if (access_type == write_access_type)
-                printf("value to write into cell after fault injection: 0x%08x\n", *value);
+        trace_fies_memory_content(fault->id, cell_addr, write_access_type,
+                                  before, value, fault->was_triggered);
+    }
+}
 
-            cpu_memory_rw_debug(cpu, *addr, membytes, (MEMORY_WIDTH / 8), 0);
-            printf("cell content after fault injection: 0x%08x\n", memword);
-            printf("-----------------------END---------------------------------\n");
-#endif
-        }
-        else
-        {
-            continue;
-        }
-        //
-        //      tlb_flush_page(env, (target_ulong)fault->params.address);
-        //      tlb_flush_page(env, (target_ulong)fault->params.cf_address);
+/**
+ * Looks up the faults in the memory cells of the main memory (RAM), which overlap
+ * the accessed range, in the address indices and injects them. Accesses, which do
+ * not touch an armed memory cell, only cost the index lookups.
+ *
+ * @param[in] env - Reference to the information of the CPU state or NULL, if the
+ *                  access is not performed by a CPU (e.g. DMA).
+ * @param[in] addr - the first accessed address.
+ * @param[in] buf - the accessed bytes in guest memory order.
+ * @param[in] len - the length of the access in bytes.
+ * @param[in] access_type - if the access-operation is a write, read or execute.
+ */
+static void FIESER_controller_memory_content(CPUArchState *env, hwaddr addr,
+                                             uint8_t *buf, hwaddr len,
+                                             AccessType access_type)
+{
+    FaultList *fault;
+    int pos;
+
+    /**
+     * the ECC sees the stored codeword, i.e. the content before the
+     * stuck bits of permanent faults are forced into a store
+     */
+    if (unlikely(fies_ecc_tracking))
+        FIESER_ecc_access(env, addr, buf, len, access_type);
+
+    if (access_type == write_access_type)
+        FIESER_controller_write_filter(addr, buf, len);
+
+    pos = FIESER_index_lookup(FI_INDEX_ACCESS, addr, len);
+    if (likely(pos < 0)
+            && likely(FIESER_index_lookup(FI_INDEX_COUPLING, addr, len) < 0))
+        return;
+
+    /**
+     * accesses without a CPU are attributed to the current CPU (if any)
+     */
+    if (!env)
+    {
+        CPUState *cpu = current_cpu ? current_cpu : first_cpu;
+
+        if (!cpu)
+            return;
+
+        env = cpu->env_ptr;
+    }
+
+    FIESER_coupling_access(env, addr, buf, len, access_type);
+
+    while ((fault = FIESER_index_next(FI_INDEX_ACCESS, addr, &pos)))
+    {
+        FIESER_tlb_flush_page(ENV_GET_CPU(env), (target_ulong) addr);
+        FIESER_controller_memory_cell(env, fault, addr, buf, len, access_type);
     }
 }
 
@@ -1039,18 +952,26 @@ static void FIESER_controller_insn(CPUArchState *env, hwaddr *addr, uint32_t *in
 {
     FaultList *fault;
     int element = 0;
-    uint32_t insn = 0;
+    uint32_t insn = 0, before;
 
-    //printf("---------------------------HARTL------------------------------------------\n");
-    //printf("instruction number before fault injection: 0x%08x\n", (unsigned int)*addr);
+    /**
+     * a pending look-up error replaces the fetched instruction once
+     */
+    if (lookup_error.pending
+            && (lookup_error.any_pc || lookup_error.pc == *addr))
+    {
+        lookup_error.pending = false;
+        do_inject_insn(&insn, lookup_error.insn);
+        trace_fies_lookup_error(lookup_error.id, *addr, insn);
+        *ins = (uint32_t) insn;
+    }
+
+    before = *ins;
 
     for (element = 0; element < getNumFaultListElements(); element++)
     {
         fault = getFaultListElement(element);
 
-        //printf("---------------------------HARTL2------------------------------------------\n");
-        //printf("fault->params.address: 0x%08x\n", (unsigned int)fault->params.address);
-
         /**
          * accessed address is not the defined fault address or the trigger is set to
          * time- or pc-triggering.
@@ -1060,13 +981,6 @@ static void FIESER_controller_insn(CPUArchState *env, hwaddr *addr, uint32_t *in
                 || fault->component != FI_COMP_CPU)
             continue;
 
-        //printf("---------------------------HARTL3------------------------------------------\n");
-
-#if defined(DEBUG_FAULT_CONTROLLER)
-        printf("---------------------------START------------------------------------------\n");
-        printf("instruction number before fault injection: 0x%08x\n", (unsigned int) *addr);
-#endif
-
         if (fault->target == FI_TAGT_INSTRUCTION_DECODER)
         {
 
@@ -1109,6 +1023,12 @@ static void FIESER_controller_insn(CPUArchState *env, hwaddr *addr, uint32_t *in
                 insn |= 0x46c0;
                 do_inject_insn(&insn, insn);
                 break;
+                /**
+                 * No operation (A64) "NOP" - 0xd503201f
+                 */
+            case FI_INSTRUCTION_VALUE_A64:
+                do_inject_insn(&insn, 0xd503201f);
+                break;
             default:
                 assert(0);
                 break;
@@ -1116,10 +1036,7 @@ static void FIESER_controller_insn(CPUArchState *env, hwaddr *addr, uint32_t *in
             *ins = (uint32_t) insn;
         }
 
-#if defined(DEBUG_FAULT_CONTROLLER)
-        printf("instruction number after fault injection: 0x%08x\n", (unsigned int) *addr);
-        printf("---------------------------END--------------------------------------------\n");
-#endif
+        trace_fies_insn(fault->id, *addr, before, *ins);
     }
 }
 
@@ -1141,6 +1058,15 @@ static void FIESER_controller_pc_or_time(CPUArchState *env,
     unsigned int pc = (unsigned long) *addr;
     hwaddr reg_mem_addr = 0;
     FaultInjectionInfo fi_info = {0, 0, 0, 0, 0, 0, 0};
+    uint64_t before = 0;
+    bool trace_state;
+
+    /**
+     * <address> holds 32 bits, so PC-triggered faults are limited to the
+     * lower 4 GiB; a higher A64 PC must not match the truncated value
+     */
+    if (injection_mode != FI_TIME && *addr > UINT32_MAX)
+        return;
 
     for (element = 0; element < getNumFaultListElements(); element++)
     {
@@ -1153,10 +1079,20 @@ static void FIESER_controller_pc_or_time(CPUArchState *env,
                 && fault->trigger != FI_TRGR_PC)
             continue;
 
-#if defined(DEBUG_FAULT_CONTROLLER)
-        printf("---------------------------START------------------------------------------\n");
-        printf("pc before fault injection: 0x%08x\n", (unsigned int) *addr);
-#endif
+        /**
+         * the A64 translator calls the PC hook only in front of the
+         * trigger addresses and the timer hook once per TB, each
+         * evaluates only the faults it is emitted for
+         */
+        if ((injection_mode == FI_TIME && fault->trigger != FI_TRGR_TIME)
+                || (injection_mode == FI_PC_A64 && fault->trigger != FI_TRGR_PC))
+            continue;
+
+        /**
+         * applied at their activation edges by the scheduler
+         */
+        if (FIESER_index_scheduled_fault(fault))
+            continue;
 
         if (fault->component == FI_COMP_CPU
                 && fault->target == FI_TAGT_CONDITION_FLAGS)
@@ -1165,6 +1101,7 @@ static void FIESER_controller_pc_or_time(CPUArchState *env,
             if (!fault->was_triggered)
                 continue;
 
+            trace_fies_condition_flags(fault->id, pc, fault->mode);
             do_inject_condition_flags(env, fault->mode, fault->params.set_bit);
         }
         else if (fault->component == FI_COMP_CPU
@@ -1177,11 +1114,21 @@ static void FIESER_controller_pc_or_time(CPUArchState *env,
             }
 
             /**
-             * overwrites the pc directly in the CPUArchState.
-             * This is needed, because the pc is not accessed
-             * at this time (time- triggering).
+             * the next instruction is replaced when it is translated into a
+             * single-use TB (see FIESER_insn_fault_active), so the guest
+             * memory and the cached TBs stay untouched. PC-triggered faults
+             * hit the instruction at their address, which is the next one as
+             * the translator ends the TB in front of it. Time-triggered
+             * faults hit the first instruction of the next TB.
              */
-            do_inject_look_up_error(env, fault->params.instruction, (injection_mode == FI_PC_THUMB16) ? 2 : 4);
+            lookup_error.pending = true;
+            lookup_error.any_pc = fault->trigger != FI_TRGR_PC;
+            lookup_error.pc = pc;
+            lookup_error.insn = fault->params.instruction;
+            lookup_error.id = fault->id;
+
+            if (lookup_error.any_pc)
+                cpu_exit(ENV_GET_CPU(env));
         }
         else if (fault->component == FI_COMP_REGISTER
                 && fault->target == FI_TAGT_REGISTER_CELL)
@@ -1204,11 +1151,9 @@ static void FIESER_controller_pc_or_time(CPUArchState *env,
              * variable contains the pc-value.
              */
             reg_mem_addr = fault->params.instruction;
-#if defined(DEBUG_FAULT_CONTROLLER)
-            unsigned memword = 0;
-            memword = FIESER_helper_read_cpu_register(env, reg_mem_addr);
-            printf("injecting fault on register %d with initial content 0x%08x\n", fault->params.instruction, memword);
-#endif
+            trace_state = trace_event_get_state_backends(TRACE_FIES_TIMED_REGISTER);
+            if (trace_state)
+                before = FIESER_helper_read_cpu_register(env, reg_mem_addr);
 
             if (fault->mode == FI_MODE_BITFLIP)
             {
@@ -1222,12 +1167,13 @@ static void FIESER_controller_pc_or_time(CPUArchState *env,
             {
                 FIESER_inject_state_register(env, &reg_mem_addr, fault, fi_info, pc);
             }
-#if defined(DEBUG_FAULT_CONTROLLER)
-            printf("fault status: %d (1-active, 0-inactive)\n", fault->was_triggered);
 
-            memword = FIESER_helper_read_cpu_register(env, reg_mem_addr);
-            printf("cell content after fault injection: 0x%08x\n", memword);
-#endif
+            if (trace_state)
+            {
+                trace_fies_timed_register(fault->id, pc, reg_mem_addr, before,
+                                          FIESER_helper_read_cpu_register(env, reg_mem_addr),
+                                          fault->was_triggered);
+            }
         }
         else if (fault->component == FI_COMP_RAM
                 && (fault->target == FI_TAGT_MEMORY_CELL || fault->target == FI_TAGT_RW_LOGIC))
@@ -1242,15 +1188,9 @@ static void FIESER_controller_pc_or_time(CPUArchState *env,
             fi_info.fault_on_register = 0;
 
             reg_mem_addr = fault->params.instruction;
-#if defined(DEBUG_FAULT_CONTROLLER)
-            unsigned memword = 0;
-            uint8_t *membytes = (uint8_t *) & memword;
-            CPUState *cpu = ENV_GET_CPU(env);
-
-            cpu_memory_rw_debug(cpu, reg_mem_addr, membytes, (MEMORY_WIDTH / 8), 0);
-            printf("injecting fault on memory cell: 0x%08x with initial content 0x%08x\n",
-                   fault->params.instruction, memword);
-#endif
+            trace_state = trace_event_get_state_backends(TRACE_FIES_TIMED_MEMORY);
+            if (trace_state)
+                before = FIESER_helper_read_memory_cell(env, reg_mem_addr);
 
             if (fault->mode == FI_MODE_BITFLIP)
             {
@@ -1264,20 +1204,91 @@ static void FIESER_controller_pc_or_time(CPUArchState *env,
             {
                 FIESER_inject_state_register(env, &reg_mem_addr, fault, fi_info, pc);
             }
-#if defined(DEBUG_FAULT_CONTROLLER)
-            printf("fault status: %d (1-active, 0-inactive)\n", fault->was_triggered);
 
-            memword = 0;
-            membytes = (uint8_t *) & memword;
+            if (trace_state)
+            {
+                trace_fies_timed_memory(fault->id, pc, reg_mem_addr, before,
+                                        FIESER_helper_read_memory_cell(env, reg_mem_addr),
+                                        fault->was_triggered);
+            }
+        }
+    }
+}
 
-            cpu_memory_rw_debug(cpu, reg_mem_addr, membytes, (MEMORY_WIDTH / 8), 0);
-            printf("cell content after fault injection: 0x%08x\n", memword);
-#endif
+/**
+ * Applies an activation edge of a scheduled fault (see
+ * FIESER_index_scheduled_fault). Faults in the CPU state and the NVIC are
+ * injected once, at the rising edge. Unlike the faults checked after every
+ * instruction, a State Fault in a register or the condition flags is set
+ * at each activation, but not held while the fault is active. IRQ and
+ * TIMER faults are applied to their device at both edges.
+ *
+ * @param[in] env - Reference to the information of the CPU state or NULL
+ *                  for IRQ and TIMER faults.
+ * @param[in] fault - pointer to the linked list entry.
+ * @param[in] active - if the fault became active or inactive.
+ */
+void FIESER_controller_scheduled(CPUArchState *env, FaultList *fault, bool active)
+{
+    FaultInjectionInfo fi_info = {0, 0, 0, 0, 0, 0, 0};
+    unsigned int pc;
+    hwaddr reg_addr;
+    uint64_t before;
+
+    if (fault->component == FI_COMP_IRQ)
+    {
+        FIESER_irq_scheduled(fault, active);
+        return;
+    }
+
+    if (fault->component == FI_COMP_TIMER)
+    {
+        FIESER_ptimer_scheduled(fault, active);
+        return;
+    }
+
+    if (!active)
+        return;
+
+    pc = env->regs[15];
+
+    if (fault->component == FI_COMP_NVIC)
+    {
+        FIESER_nvic_inject(fault);
+    }
+    else if (fault->component == FI_COMP_CPU
+            && fault->target == FI_TAGT_CONDITION_FLAGS)
+    {
+        trace_fies_condition_flags(fault->id, pc, fault->mode);
+        do_inject_condition_flags(env, fault->mode, fault->params.set_bit);
+        incr_num_injected_faults(fault->id, FI_COMP_CPU, fault->type);
+    }
+    else if (fault->component == FI_COMP_REGISTER
+            && fault->target == FI_TAGT_REGISTER_CELL)
+    {
+        /**
+         * the register is in the instruction-variable, like for the
+         * faults checked after every instruction
+         */
+        reg_addr = fault->params.instruction;
+        before = FIESER_helper_read_cpu_register(env, reg_addr);
+
+        fi_info.fault_on_register = 1;
+        fi_info.mask = fault->params.mask;
+        fi_info.bit_value = fault->params.set_bit;
+        fi_info.bit_flip = fault->mode == FI_MODE_BITFLIP;
+
+        if (fault->mode == FI_MODE_NEW_VALUE)
+        {
+            fi_info.new_value = 1;
+            fi_info.bit_value = fault->params.mask;
         }
-#if defined(DEBUG_FAULT_CONTROLLER)
-        printf("pc after fault injection: 0x%08x\n", (unsigned int) *addr);
-        printf("---------------------------END--------------------------------------------\n");
-#endif
+
+        do_inject_memory_register(env, &reg_addr, fi_info);
+        incr_num_injected_faults(fault->id, FI_COMP_REGISTER, fault->type);
+
+        trace_fies_timed_register(fault->id, pc, reg_addr, before,
+                                  FIESER_helper_read_cpu_register(env, reg_addr), 1);
     }
 }
 
@@ -1292,50 +1303,15 @@ static void FIESER_controller_pc_or_time(CPUArchState *env,
  * @param[in] access_type - if the access-operation is a write, read or execute.
  */
 static void FIESER_helper_log_cell_operations_register(CPUArchState *env, FaultList *fault, hwaddr *addr,
-                                                       uint32_t *value, AccessType access_type)
+                                                       uint64_t *value, AccessType access_type)
 {
-    unsigned memword = 0, mask = 0, set_bit, bit_pos = 0, id = 0;
-
     /**
      * only a write access can trigger a dynamic fault
      */
     if (access_type == write_access_type)
     {
-        memword = FIESER_helper_read_cpu_register(env, *addr);
-        mask = fault->params.mask;
-
-        /**
-         * search the set bits in mask (integer)
-         */
-        while (mask)
-        {
-            /**
-             * extract least significant bit of 2s complement
-             */
-            set_bit = mask & -mask;
-
-            /**
-             * toggle the bit off
-             */
-            mask ^= set_bit;
-
-            /**
-             * determine the position of the set bit
-             */
-            bit_pos = (uint32_t) log2(set_bit);
-            id = fault->id - 1;
-
-            if (!!(memword & set_bit) == 0 && !!(*value & set_bit) == 0)
-                ops_on_register_cell[id][bit_pos] = OPs_0w0;
-            else if (!!(memword & set_bit) == 0 && !!(*value & set_bit) == 1)
-                ops_on_register_cell[id][bit_pos] = OPs_0w1;
-            else if (!!(memword & set_bit) == 1 && !!(*value & set_bit) == 0)
-                ops_on_register_cell[id][bit_pos] = OPs_1w0;
-            else if (!!(memword & set_bit) == 1 && !!(*value & set_bit) == 1)
-                ops_on_register_cell[id][bit_pos] = OPs_1w1;
-            else
-                ops_on_register_cell[id][bit_pos] = -1;
-        }
+        FIESER_history_record(fault, FIESER_helper_read_cpu_register(env, *addr),
+                              *value, UINT64_MAX);
     }
 }
 
@@ -1350,10 +1326,11 @@ static void FIESER_helper_log_cell_operations_register(CPUArchState *env, FaultL
  * @param[in] access_type - if the access-operation is a write, read or execute.
  */
 static void FIESER_controller_register_content(CPUArchState *env, hwaddr *addr,
-                                               uint32_t *value, AccessType access_type)
+                                               uint64_t *value, AccessType access_type)
 {
     FaultList *fault;
     int element = 0;
+    uint64_t before;
     FaultInjectionInfo fi_info;
 
     for (element = 0; element < getNumFaultListElements(); element++)
@@ -1384,54 +1361,24 @@ static void FIESER_controller_register_content(CPUArchState *env, hwaddr *addr,
             fi_info.fault_on_register = 1;
 
             FIESER_helper_log_cell_operations_register(env, fault, addr, value, access_type);
-
-#if defined(DEBUG_FAULT_CONTROLLER)
-            printf("-----------------------START-------------------------------\n");
-            if (access_type == read_access_type)
-                printf("value read from cell before fault injection: 0x%08x\n", *value);
-            else if (access_type == write_access_type)
-                printf("value to write into cell before fault injection: 0x%08x\n", *value);
-#endif
+            before = *value;
 
             if (fault->mode == FI_MODE_BITFLIP)
-            {
-                uint64_t value64 = *value;
-                FIESER_inject_bitflip(env, &value64, fault, fi_info, 0);
-                *value = value64;
-            }
+                FIESER_inject_bitflip(env, value, fault, fi_info, 0);
             else if (fault->mode == FI_MODE_NEW_VALUE)
-            {
-                uint64_t value64 = *value;
-                FIESER_inject_new_value(env, &value64, fault, fi_info, 0);
-                *value = value64;
-            }
+                FIESER_inject_new_value(env, value, fault, fi_info, 0);
             else if (fault->mode == FI_MODE_STATE_FAULT)
-            {
-                uint64_t value64 = *value;
-                FIESER_inject_state_register(env, &value64, fault, fi_info, 0);
-                *value = value64;
-            }
-
-#if defined(DEBUG_FAULT_CONTROLLER)
-            printf("fault status: %d (1-active, 0-inactive)\n", fault->was_triggered);
+                FIESER_inject_state_register(env, value, fault, fi_info, 0);
 
-            unsigned memword = 0;
+            trace_fies_register_content(fault->id, *addr, access_type,
+                                        before, *value, fault->was_triggered);
 
-            if (fault->params.cf_address != -1)
+            if (fault->params.cf_address != -1
+                    && trace_event_get_state_backends(TRACE_FIES_COUPLED_CELL))
             {
-                memword = FIESER_helper_read_cpu_register(env, fault->params.cf_address);
-                printf("coupled cell content after fault injection: 0x%08x\n", memword);
+                trace_fies_coupled_cell(fault->id, fault->params.cf_address,
+                                        FIESER_helper_read_cpu_register(env, fault->params.cf_address));
             }
-
-            if (access_type == read_access_type)
-                printf("value read from cell after fault injection: 0x%08x\n", *value);
-            else if (access_type == write_access_type)
-                printf("value to write into cell after fault injection: 0x%08x\n", *value);
-
-            memword = FIESER_helper_read_cpu_register(env, *addr);
-            printf("cell content after fault injection: 0x%08x\n", memword);
-            printf("-----------------------END---------------------------------\n");
-#endif
         }
     }
 }
@@ -1447,6 +1394,7 @@ static void FIESER_controller_register_address(CPUArchState *env, hwaddr *addr)
 {
     FaultList *fault;
     int element = 0;
+    hwaddr before;
     FaultInjectionInfo fi_info = {0, 0, 0, 0, 0, 0, 0};
 
     for (element = 0; element < getNumFaultListElements(); element++)
@@ -1464,10 +1412,6 @@ static void FIESER_controller_register_address(CPUArchState *env, hwaddr *addr)
         if (fault->component == FI_COMP_REGISTER
                 && fault->target == FI_TAGT_ADDRESS_DECODER)
         {
-#if defined(DEBUG_FAULT_CONTROLLER)
-            printf("-----------------------START-------------------------------\n");
-            printf("register address before fault injection: 0x%08x\n", (unsigned int) *addr);
-#endif
             /**
              *  set/reset values
              */
@@ -1475,6 +1419,7 @@ static void FIESER_controller_register_address(CPUArchState *env, hwaddr *addr)
             fi_info.bit_flip = 0;
             fi_info.fault_on_address = 1;
             fi_info.fault_on_register = 1;
+            before = *addr;
 
             if (fault->mode == FI_MODE_BITFLIP)
                 FIESER_inject_bitflip(env, addr, fault, fi_info, 0);
@@ -1483,17 +1428,14 @@ static void FIESER_controller_register_address(CPUArchState *env, hwaddr *addr)
             else if (fault->mode == FI_MODE_STATE_FAULT)
                 FIESER_inject_state_register(env, addr, fault, fi_info, 0);
 
-#if defined(DEBUG_FAULT_CONTROLLER)
-            printf("fault status: %d (1-active, 0-inactive)\n", fault->was_triggered);
-            printf("register address before fault injection: 0x%08x\n", (unsigned int) *addr);
-            printf("-----------------------END-------------------------------\n");
-#endif
+            trace_fies_register_address(fault->id, before, *addr,
+                                        fault->was_triggered);
         }
     }
 }
 
 /**
- * Implements the interface to the appropriate controller functions.
+ * Dispatches a hook invocation to the appropriate controller functions.
  *
  * @param[in] env - Reference to the information of the CPU state.
  * @param[in] addr - the address of the accessed cell.
@@ -1502,69 +1444,56 @@ static void FIESER_controller_register_address(CPUArchState *env, hwaddr *addr)
  * @param[in] access_type - if the access-operation is a write, read or execute.
  *
  */
-void FIESER_hook(CPUArchState *env, hwaddr *addr,
-                 uint32_t *value, InjectionMode injection_mode,
-                 AccessType access_type)
+static void FIESER_hook_dispatch(CPUArchState *env, hwaddr *addr,
+                                 uint32_t *value, InjectionMode injection_mode,
+                                 AccessType access_type)
 {
     FaultList *fault;
     int element = 0;
+    uint64_t value64;
     ARMCPU *cpu = arm_env_get_cpu(env);
 
-    profiler_log(env, addr, value, access_type);
-
     if (*addr == address_in_use)
         return;
 
     switch (injection_mode)
     {
     case FI_MEMORY_ADDR:
+        FIESER_dcls_mem_begin(addr, NULL, 0, access_type);
         FIESER_controller_memory_address(env, addr);
-        break;
-    case FI_MEMORY_CONTENT:
-        if (env)
-        {
-            FIESER_controller_memory_content(env, addr, value, access_type);
-            return;
-        }
-
-        /**
-         * get the CPUArchState of the current CPU (if not defined)
-         */
-        if (next_cpu == NULL)
-            next_cpu = first_cpu;
-
-        for (; next_cpu != NULL && !(next_cpu->exit_request); next_cpu = CPU_NEXT(next_cpu))
-        {
-            CPUState *cpu = next_cpu;
-            CPUArchState *env = cpu->env_ptr;
-
-            FIESER_controller_memory_content(env, addr, value, access_type);
-        }
+        FIESER_dcls_mem_end(*addr, NULL, 0);
         break;
     case FI_INSTRUCTION_VALUE_ARM:
     case FI_INSTRUCTION_VALUE_THUMB32:
     case FI_INSTRUCTION_VALUE_THUMB16:
+    case FI_INSTRUCTION_VALUE_A64:
         FIESER_controller_insn(env, addr, value, injection_mode);
         break;
     case FI_REGISTER_ADDR:
         FIESER_controller_register_address(env, addr);
         break;
     case FI_REGISTER_CONTENT:
-        FIESER_controller_register_content(env, addr, value, access_type);
+        value64 = *value;
+        FIESER_controller_register_content(env, addr, &value64, access_type);
+        *value = value64;
         break;
     case FI_TIME:
     case FI_PC_ARM:
     case FI_PC_THUMB32:
     case FI_PC_THUMB16:
+    case FI_PC_A64:
         for (element = 0; element < getNumFaultListElements(); element++)
         {
             fault = getFaultListElement(element);
 
-#if defined(DEBUG_FAULT_CONTROLLER_TLB_FLUSH)
-            printf("flushing tlb address %x\n", fault->params.address);
-#endif
-            tlb_flush_page(CPU(cpu), (target_ulong) fault->params.address);
-            tlb_flush_page(CPU(cpu), (target_ulong) fault->params.cf_address);
+            /**
+             * stores to permanent stuck-at cells are caught with TLB_FIES
+             */
+            if (FIESER_index_write_filter_fault(fault))
+                continue;
+
+            FIESER_tlb_flush_page(CPU(cpu), (target_ulong) fault->params.address);
+            FIESER_tlb_flush_page(CPU(cpu), (target_ulong) fault->params.cf_address);
         }
 
         FIESER_controller_pc_or_time(env, addr, injection_mode, access_type);
@@ -1575,14 +1504,757 @@ void FIESER_hook(CPUArchState *env, hwaddr *addr,
     }
 }
 
-void FIESER_timed_terminate_check(CPUArchState *env)
+/**
+ * Set while the permanent stuck-at faults of the fault list still have to
+ * be patched into the memory, i.e. after loading a fault library and after
+ * a system reset (which reloads ROM images into the memory).
+ */
+static bool permanent_faults_pending;
+
+/**
+ * Requests patching the permanent stuck-at faults into the memory at the
+ * next hook invocation. The patch is deferred to a hook, so that it is
+ * applied after the guest image is loaded.
+ */
+void FIESER_arm_permanent_faults(void)
+{
+    atomic_set(&permanent_faults_pending, true);
+}
+
+#if !defined(CONFIG_USER_ONLY)
+static void FIESER_reset_permanent_faults(void *opaque)
+{
+    FIESER_arm_permanent_faults();
+    FIESER_history_reset();
+}
+#endif
+
+/**
+ * Patches the stuck bits of all permanent stuck-at faults in memory cells
+ * into the memory once. Afterwards, reads of these cells run at full speed
+ * and only stores are intercepted through TLB_FIES (see
+ * FIESER_controller_write_filter), instead of forcing every access to the
+ * page into the slow path.
+ *
+ * @param[in] env - Reference to the information of the CPU state or NULL.
+ */
+static void FIESER_activate_permanent_faults(CPUArchState *env)
+{
+    FaultList *fault;
+    FaultInjectionInfo fi_info = {0, 0, 0, 0, 0, 0, 0};
+    CPUState *cpu = env ? ENV_GET_CPU(env) : (current_cpu ? current_cpu : first_cpu);
+    hwaddr addr;
+    int element;
+
+    if (!cpu || !atomic_xchg(&permanent_faults_pending, false))
+        return;
+
+    for (element = 0; element < getNumFaultListElements(); element++)
+    {
+        fault = getFaultListElement(element);
+
+        if (!FIESER_index_write_filter_fault(fault))
+            continue;
+
+        addr = (uint32_t) fault->params.address;
+        fi_info.width = fault->params.width;
+        fi_info.burst = 1;
+
+        FIESER_inject_mask(cpu->env_ptr, &addr, fault, fi_info, FI_TYPE_PERMANENT);
+        fault->was_triggered = 1;
+
+        trace_fies_permanent_fault(fault->id, addr);
+    }
+
+    /**
+     * refill the TLB entries with TLB_FIES for the faulty pages
+     * and the pages of coupling faults
+     */
+    CPU_FOREACH(cpu)
+    {
+        tlb_flush(cpu);
+    }
+}
+
+/**
+ * Checks if loads or stores to a page have to pass the fault controller.
+ * Stores are filtered, if the page contains the memory cell of a permanent
+ * stuck-at fault. Loads and stores are evaluated, if the page contains the
+ * victim or aggressor cell of a coupling fault or holds ECC check bits.
+ * In DCLS mode, all stores are logged and hence pass the slow path.
+ *
+ * @param[in] vaddr - an address within the page.
+ * @param[in] is_write - if the TLB entry is used for stores or loads.
+ * @param[out] - true if the TLB entry of the page needs TLB_FIES.
+ */
+bool FIESER_tlb_filtered(target_ulong vaddr, bool is_write)
+{
+    hwaddr page = vaddr & TARGET_PAGE_MASK;
+
+    if (is_write && fies_dcls)
+        return true;
+
+    if (unlikely(fies_ecc_tracking) && FIESER_ecc_page_tracked(page))
+        return true;
+
+    if (is_write && FIESER_index_lookup(FI_INDEX_WRITE_FILTER, page,
+                                        TARGET_PAGE_SIZE) >= 0)
+        return true;
+
+    return FIESER_index_lookup(FI_INDEX_COUPLING, page, TARGET_PAGE_SIZE) >= 0;
+}
+
+/**
+ * Checks if an instruction decoder or execution fault is armed at an address.
+ * The translator gives such an instruction a TB of its own, which is never
+ * chained to, so that every execution of the instruction passes cpu_exec.
+ *
+ * @param[in] pc - the address of the instruction.
+ * @param[out] - true if an instruction fault is armed at pc.
+ */
+bool FIESER_insn_armed(target_ulong pc)
+{
+    return FIESER_index_lookup(FI_INDEX_INSN, pc, 1) >= 0;
+}
+
+/**
+ * Checks if an access-triggered register fault is armed for a register. The
+ * A64 translator emits the register hooks only for such registers.
+ *
+ * @param[in] regno - the register number.
+ * @param[out] - true if a register fault is armed for regno.
+ */
+bool FIESER_register_armed(int regno)
+{
+    return FIESER_index_lookup(FI_INDEX_REGISTER, regno, 1) >= 0;
+}
+
+/**
+ * Checks if an access-triggered register fault is armed for one of count
+ * consecutive registers, e.g. for the SPSRs of all banks.
+ *
+ * @param[in] regno - the first register number.
+ * @param[in] count - the number of registers.
+ * @param[out] - true if a register fault is armed for one of them.
+ */
+bool FIESER_register_range_armed(int regno, int count)
+{
+    return FIESER_index_lookup(FI_INDEX_REGISTER, regno, count) >= 0;
+}
+
+/**
+ * Checks if an access to a register of the floating-point and SIMD register
+ * file or the FPSCR has to call the fault controller. The AArch32 translator
+ * emits the VFP and NEON register hooks only for such accesses. Faults in
+ * the D and Q registers covering an accessed S register and in the S
+ * registers covered by an accessed D register are taken into account.
+ *
+ * @param[in] regno - the accessed S or D register or the FPSCR.
+ * @param[out] - true if a register fault is armed for the accessed bits.
+ */
+bool FIESER_vfp_register_armed(int regno)
+{
+    int d;
+
+    if (regno == FI_REG_FPSCR)
+        return FIESER_register_armed(regno);
+
+    if (regno < FI_REG_VFP_D0)
+    {
+        d = (regno - FI_REG_VFP_S0) / 2;
+        if (FIESER_register_armed(regno))
+            return true;
+    }
+    else
+    {
+        d = regno - FI_REG_VFP_D0;
+        if (FIESER_index_lookup(FI_INDEX_REGISTER, FI_REG_VFP_S0 + 2 * d, 2) >= 0)
+            return true;
+    }
+
+    return FIESER_register_armed(FI_REG_VFP_D0 + d)
+            || FIESER_register_armed(FI_REG_VFP_Q0 + d / 2);
+}
+
+/**
+ * Checks if a PC-triggered fault is armed at an address. The A64 translator
+ * emits the PC hook only in front of such addresses.
+ *
+ * @param[in] pc - the address of the instruction.
+ * @param[out] - true if a PC-triggered fault is armed at pc.
+ */
+bool FIESER_pc_armed(target_ulong pc)
+{
+    return FIESER_index_lookup(FI_INDEX_PC, pc, 1) >= 0;
+}
+
+/**
+ * Checks if any time-triggered fault is armed. The A64 translator then emits
+ * the timer hook at the start of each TB.
+ *
+ * @param[out] - true if the fault list holds time-triggered faults.
+ */
+bool FIESER_time_armed(void)
+{
+    return FIESER_index_size(FI_INDEX_TIME) > 0;
+}
+
+/**
+ * Checks if any fault is injected by the memory hooks. In user mode, the
+ * translator then routes all guest loads and stores through the hooks, as
+ * they access the host memory directly.
+ *
+ * @param[out] - true if the fault list holds access-triggered memory faults.
+ */
+bool FIESER_mem_armed(void)
+{
+    return FIESER_index_size(FI_INDEX_ACCESS) > 0
+            || FIESER_index_size(FI_INDEX_WRITE_FILTER) > 0
+            || FIESER_index_size(FI_INDEX_COUPLING) > 0;
+}
+
+/**
+ * Checks if an access to a range of memory has to pass the memory hooks.
+ * Used by the user mode atomic helpers, which fall back to a serial
+ * load and store for such accesses (see atomic_mmu_lookup).
+ *
+ * @param[in] addr - the first accessed address.
+ * @param[in] len - the length of the access in bytes.
+ * @param[out] - true if a memory fault overlaps the access.
+ */
+bool FIESER_mem_range_armed(target_ulong addr, target_ulong len)
+{
+    return FIESER_index_lookup(FI_INDEX_ACCESS, addr, len) >= 0
+            || FIESER_index_lookup(FI_INDEX_WRITE_FILTER, addr, len) >= 0
+            || FIESER_index_lookup(FI_INDEX_COUPLING, addr, len) >= 0;
+}
+
+/**
+ * Checks if an instruction fault armed at an address is active at the current
+ * time, or if a look-up error is pending for it. The faulty variant of the
+ * instruction is then translated into a single-use TB (CF_NOCACHE), while the
+ * clean TB stays cached. Hence, transient and intermittent faults revert as
+ * soon as they become inactive.
+ *
+ * @param[in] pc - the address of the instruction.
+ * @param[out] - true if the faulty variant of the instruction has to run.
+ */
+bool FIESER_insn_fault_active(target_ulong pc)
+{
+    FaultList *fault;
+    int pos;
+
+    if (unlikely(lookup_error.pending)
+            && (lookup_error.any_pc || lookup_error.pc == pc))
+        return true;
+
+    pos = FIESER_index_lookup(FI_INDEX_INSN, pc, 1);
+
+    while ((fault = FIESER_index_next(FI_INDEX_INSN, pc, &pos)))
+    {
+        /**
+         * PC-triggered faults are pending look-up errors when active
+         */
+        if (fault->trigger != FI_TRGR_ACCESS)
+            continue;
+
+        /**
+         * decoder faults are triggered on every access to their address
+         */
+        if (fault->target == FI_TAGT_INSTRUCTION_DECODER
+                || FIESER_fault_active(fault))
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * Invalidates the TBs covering an instruction (see breakpoint_invalidate).
+ *
+ * @param[in] cpu - the CPU, through which the address is translated.
+ * @param[in] pc - the address of the instruction.
+ */
+static void FIESER_insn_invalidate(CPUState *cpu, target_ulong pc)
+{
+#if defined(CONFIG_USER_ONLY)
+    mmap_lock();
+    tb_lock();
+    tb_invalidate_phys_page_range(pc, pc + 1, 0);
+    tb_unlock();
+    mmap_unlock();
+#else
+    MemTxAttrs attrs;
+    hwaddr phys = cpu_get_phys_page_attrs_debug(cpu, pc, &attrs);
+    int asidx = cpu_asidx_from_attrs(cpu, attrs);
+
+    if (phys != -1)
+    {
+        tb_invalidate_phys_addr(cpu->cpu_ases[asidx].as,
+                                phys | (pc & ~TARGET_PAGE_MASK));
+    }
+#endif
+}
+
+static void FIESER_insn_invalidate_work(CPUState *cpu, run_on_cpu_data data)
+{
+    GArray *pcs = data.host_ptr;
+    int i;
+
+    for (i = 0; i < pcs->len; i++)
+        FIESER_insn_invalidate(cpu, g_array_index(pcs, target_ulong, i));
+
+    g_array_free(pcs, true);
+}
+
+/**
+ * Installs the fault controller shims on the coprocessor registers of all
+ * CPUs, for which an access-triggered fault is armed, and removes them from
+ * the others. The translations are flushed in the same exclusive section,
+ * if a shim was removed or installed, because the translator emits direct
+ * loads and stores of the registers without shim.
+ */
+static void FIESER_cpreg_work(CPUState *cpu, run_on_cpu_data data)
+{
+    CPUState *cs;
+    bool changed = false;
+
+    CPU_FOREACH(cs)
+        changed |= arm_fies_update_cpregs(ARM_CPU(cs));
+
+    if (changed)
+        tb_flush_exclusive(cpu);
+}
+
+/**
+ * Schedules the invalidation of the TBs covering the instructions of all
+ * armed instruction faults. Has to be called before the fault list is
+ * replaced and after it was loaded, so that the TBs are split at the armed
+ * instructions of the new fault list only. The TBs of all other instructions
+ * stay cached, unless the fault list arms registers, PCs or the timer, for
+ * which the A64 translator emits hooks anywhere in the code, or memory faults
+ * in user mode, for which all loads and stores are instrumented.
+ */
+void FIESER_invalidate_insn_faults(void)
+{
+    FaultList *fault;
+    GArray *pcs;
+    target_ulong pc;
+    int element;
+
+    lookup_error.pending = false;
+
+    if (first_cpu)
+        async_safe_run_on_cpu(first_cpu, FIESER_cpreg_work, RUN_ON_CPU_NULL);
+
+#if defined(CONFIG_USER_ONLY)
+    if (first_cpu && FIESER_mem_armed())
+    {
+        tb_flush(first_cpu);
+        return;
+    }
+#endif
+
+    if (first_cpu && (FIESER_index_size(FI_INDEX_REGISTER)
+                      || FIESER_index_size(FI_INDEX_PC)
+                      || FIESER_index_size(FI_INDEX_TIME)))
+    {
+        tb_flush(first_cpu);
+        return;
+    }
+
+    pcs = g_array_new(false, false, sizeof(target_ulong));
+
+    for (element = 0; element < getNumFaultListElements(); element++)
+    {
+        fault = getFaultListElement(element);
+
+        if (!FIESER_index_insn_fault(fault))
+            continue;
+
+        pc = (uint32_t) fault->params.address;
+        g_array_append_val(pcs, pc);
+    }
+
+    if (!pcs->len || !first_cpu)
+    {
+        g_array_free(pcs, true);
+        return;
+    }
+
+    async_safe_run_on_cpu(first_cpu, FIESER_insn_invalidate_work,
+                          RUN_ON_CPU_HOST_PTR(pcs));
+}
+
+/**
+ * Implements the interface to the appropriate controller functions
+ * and accounts the overhead of each invocation. Only called through
+ * FIESER_hook() while fies_enabled is set.
+ *
+ * @param[in] env - Reference to the information of the CPU state.
+ * @param[in] addr - the address of the accessed cell.
+ * @param[in] value -  the value or buffer, which should be written to register or memory.
+ * @param[in] injection_mode - defines the location, where the function is called from.
+ * @param[in] access_type - if the access-operation is a write, read or execute.
+ * @param[in] site - the QEMU function the hook is called from.
+ *
+ */
+void FIESER_do_hook(CPUArchState *env, hwaddr *addr,
+                    uint32_t *value, InjectionMode injection_mode,
+                    AccessType access_type, FIESCallSite site)
+{
+    int64_t start, profiled;
+    uint64_t tlb_flush_before;
+
+    /**
+     * the CPU of the shadow context of DCLS mode is fault-free, but it sees
+     * the same faulty RAM as the faulted context
+     */
+    if (unlikely(fies_dcls_shadow))
+    {
+        if (injection_mode == FI_MEMORY_ADDR)
+            FIESER_dcls_mem_begin(addr, NULL, 0, access_type);
+        return;
+    }
+
+    if (unlikely(atomic_read(&permanent_faults_pending)))
+        FIESER_activate_permanent_faults(env);
+
+    FIESER_stats_count_hook(injection_mode);
+    FIESER_overhead_count(site, injection_mode);
+
+    if (likely(!profile_hook_overhead))
+    {
+        profiler_log(env, addr, value, access_type);
+        FIESER_hook_dispatch(env, addr, value, injection_mode, access_type);
+        return;
+    }
+
+    start = cpu_get_host_ticks();
+    profiler_log(env, addr, value, access_type);
+    profiled = cpu_get_host_ticks();
+
+    tlb_flush_before = fies_overhead_phase_cycles[FI_OVERHEAD_TLB_FLUSH];
+    FIESER_hook_dispatch(env, addr, value, injection_mode, access_type);
+
+    FIESER_overhead_account(site, injection_mode, start, profiled,
+                            tlb_flush_before);
+}
+
+/**
+ * Implements the interface to the fault controller for the memory hook sites,
+ * which transfer a buffer, and accounts the overhead of each invocation. Only
+ * called through FIESER_hook_mem_buf() while fies_enabled is set.
+ *
+ * @param[in] env - Reference to the information of the CPU state or NULL.
+ * @param[in] addr - the first accessed address.
+ * @param[in] buf - the accessed bytes in guest memory order.
+ * @param[in] len - the length of the access in bytes.
+ * @param[in] access_type - if the access-operation is a write, read or execute.
+ * @param[in] site - the QEMU function the hook is called from.
+ */
+void FIESER_do_hook_mem_buf(CPUArchState *env, hwaddr addr,
+                            uint8_t *buf, hwaddr len, AccessType access_type,
+                            FIESCallSite site)
+{
+    int64_t start, profiled;
+    uint64_t tlb_flush_before;
+    uint32_t value = 0;
+
+    if (unlikely(FIESER_dcls_mem_begin(&addr, buf, len, access_type)))
+        return;
+
+    if (unlikely(atomic_read(&permanent_faults_pending)))
+        FIESER_activate_permanent_faults(env);
+
+    FIESER_stats_count_hook(FI_MEMORY_CONTENT);
+    FIESER_overhead_count(site, FI_MEMORY_CONTENT);
+
+    /**
+     * the profiler logs the first word of the access
+     */
+    memcpy(&value, buf, MIN(len, sizeof(value)));
+
+    if (likely(!profile_hook_overhead))
+    {
+        profiler_log(env, &addr, &value, access_type);
+        FIESER_controller_memory_content(env, addr, buf, len, access_type);
+        FIESER_dcls_mem_end(addr, buf, len);
+        return;
+    }
+
+    start = cpu_get_host_ticks();
+    profiler_log(env, &addr, &value, access_type);
+    profiled = cpu_get_host_ticks();
+
+    tlb_flush_before = fies_overhead_phase_cycles[FI_OVERHEAD_TLB_FLUSH];
+    FIESER_controller_memory_content(env, addr, buf, len, access_type);
+    FIESER_dcls_mem_end(addr, buf, len);
+
+    FIESER_overhead_account(site, FI_MEMORY_CONTENT, start, profiled,
+                            tlb_flush_before);
+}
+
+/**
+ * Implements the interface to the fault controller for the register hook
+ * sites, which access a register of up to 64 bits (the A64 registers), and
+ * accounts the overhead of each invocation. Only called through
+ * FIESER_hook_reg() while fies_enabled is set.
+ *
+ * @param[in] env - Reference to the information of the CPU state.
+ * @param[in] regno - the register number.
+ * @param[in] value - the value, which is read from or written to the register.
+ * @param[in] access_type - if the access-operation is a write, read or execute.
+ * @param[in] site - the QEMU function the hook is called from.
+ * @param[out] - the value after the injection.
+ */
+uint64_t FIESER_do_hook_reg(CPUArchState *env, hwaddr regno,
+                            uint64_t value, AccessType access_type,
+                            FIESCallSite site)
 {
+    int64_t start, profiled;
+    uint64_t tlb_flush_before;
+    uint32_t value32 = value;
+
+    if (unlikely(fies_dcls_shadow))
+        return value;
+
+    if (unlikely(atomic_read(&permanent_faults_pending)))
+        FIESER_activate_permanent_faults(env);
+
+    FIESER_stats_count_hook(FI_REGISTER_CONTENT);
+    FIESER_overhead_count(site, FI_REGISTER_CONTENT);
+
+    if (likely(!profile_hook_overhead))
+    {
+        if (profile_registers)
+            profiler_log_register_access(env, &regno, &value32, access_type);
+        FIESER_controller_register_content(env, &regno, &value, access_type);
+        return value;
+    }
+
+    start = cpu_get_host_ticks();
+    if (profile_registers)
+        profiler_log_register_access(env, &regno, &value32, access_type);
+    profiled = cpu_get_host_ticks();
+
+    tlb_flush_before = fies_overhead_phase_cycles[FI_OVERHEAD_TLB_FLUSH];
+    FIESER_controller_register_content(env, &regno, &value, access_type);
+
+    FIESER_overhead_account(site, FI_REGISTER_CONTENT, start, profiled,
+                            tlb_flush_before);
+
+    return value;
+}
+
+/**
+ * Redirects an access to a register of the floating-point and SIMD register
+ * file, if the address decoder of the register file has a fault for it. A
+ * read returns the content of the decoded register, a write stores into
+ * the decoded register and leaves the accessed one unchanged.
+ *
+ * @param[in] env - Reference to the information of the CPU state.
+ * @param[in,out] regno - the accessed S or D register, the decoded one after
+ *                        the call.
+ * @param[in,out] value - the value, which is read from or written to regno.
+ * @param[in] access_type - if the access-operation is a write or read.
+ */
+static void FIESER_controller_vfp_address(CPUArchState *env, hwaddr *regno,
+                                          uint64_t *value, AccessType access_type)
+{
+    hwaddr decoded = *regno;
+
+    FIESER_controller_register_address(env, &decoded);
+
+    /**
+     * the decoded register has to have the width of the accessed one
+     */
+    if (decoded == *regno
+            || !do_inject_is_vfp_register(decoded)
+            || (decoded < FI_REG_VFP_D0) != (*regno < FI_REG_VFP_D0)
+            || decoded >= FI_REG_VFP_Q0)
+        return;
+
+    if (access_type == write_access_type)
+    {
+        do_inject_write_vfp_register(env, decoded, *value);
+        *value = do_inject_read_vfp_register(env, *regno);
+    }
+    else
+    {
+        *value = do_inject_read_vfp_register(env, decoded);
+    }
+
+    *regno = decoded;
+}
+
+/**
+ * Injects the register cell faults of the floating-point and SIMD register
+ * file into an accessed S or D register. The faults in the covering D and Q
+ * registers (S accesses) or the covered S registers (D accesses) are
+ * injected into the accessed bits as well.
+ *
+ * @param[in] env - Reference to the information of the CPU state.
+ * @param[in] regno - the accessed S or D register.
+ * @param[in] value - the value, which is read from or written to regno.
+ * @param[in] access_type - if the access-operation is a write or read.
+ * @param[out] - the value after the injection.
+ */
+static uint64_t FIESER_controller_vfp_content(CPUArchState *env, hwaddr regno,
+                                              uint64_t value, AccessType access_type)
+{
+    int d, half, first, last;
+    uint64_t dreg, sreg;
+    hwaddr cell;
+
+    if (regno < FI_REG_VFP_D0)
+    {
+        d = (regno - FI_REG_VFP_S0) / 2;
+        first = last = (regno - FI_REG_VFP_S0) & 1;
+        dreg = deposit64(do_inject_read_vfp_register(env, FI_REG_VFP_D0 + d),
+                         32 * first, 32, value);
+    }
+    else
+    {
+        d = regno - FI_REG_VFP_D0;
+        first = 0;
+        last = 1;
+        dreg = value;
+    }
 
+    for (half = first; half <= last; half++)
+    {
+        cell = FI_REG_VFP_S0 + 2 * d + half;
+        sreg = extract64(dreg, 32 * half, 32);
+        FIESER_controller_register_content(env, &cell, &sreg, access_type);
+        dreg = deposit64(dreg, 32 * half, 32, sreg);
+    }
+
+    cell = FI_REG_VFP_D0 + d;
+    FIESER_controller_register_content(env, &cell, &dreg, access_type);
+    cell = FI_REG_VFP_Q0 + d / 2;
+    FIESER_controller_register_content(env, &cell, &dreg, access_type);
+
+    return regno < FI_REG_VFP_D0 ? extract64(dreg, 32 * first, 32) : dreg;
+}
+
+/**
+ * Injects the faults of the floating-point and SIMD register file into an
+ * access to a S or D register or the FPSCR.
+ *
+ * @param[in] env - Reference to the information of the CPU state.
+ * @param[in] regno - the accessed S or D register or the FPSCR.
+ * @param[in,out] value - the value, which is read from or written to the register.
+ * @param[in] access_type - if the access-operation is a write or read.
+ */
+static void FIESER_controller_vfp_register(CPUArchState *env, hwaddr regno,
+                                           uint64_t *value, AccessType access_type)
+{
+    if (regno == FI_REG_FPSCR)
+    {
+        FIESER_controller_register_content(env, &regno, value, access_type);
+        return;
+    }
+
+    FIESER_controller_vfp_address(env, &regno, value, access_type);
+    *value = FIESER_controller_vfp_content(env, regno, *value, access_type);
+}
+
+/**
+ * Implements the interface to the fault controller for the VFP and NEON
+ * register hook sites, which access a S or D register or the FPSCR. The
+ * translator emits them only for accesses FIESER_vfp_register_armed()
+ * selects, hence this is only called while fies_enabled is set.
+ *
+ * @param[in] env - Reference to the information of the CPU state.
+ * @param[in] regno - the accessed S or D register or the FPSCR.
+ * @param[in] value - the value, which is read from or written to the register.
+ * @param[in] access_type - if the access-operation is a write or read.
+ * @param[in] site - the QEMU function the hook is called from.
+ * @param[out] - the value after the injection.
+ */
+uint64_t FIESER_do_hook_vfp(CPUArchState *env, hwaddr regno,
+                            uint64_t value, AccessType access_type,
+                            FIESCallSite site)
+{
+    int64_t start;
+    uint64_t tlb_flush_before;
+
+    if (unlikely(fies_dcls_shadow))
+        return value;
+
+    if (unlikely(atomic_read(&permanent_faults_pending)))
+        FIESER_activate_permanent_faults(env);
+
+    FIESER_stats_count_hook(FI_REGISTER_CONTENT);
+    FIESER_overhead_count(site, FI_REGISTER_CONTENT);
+
+    if (likely(!profile_hook_overhead))
+    {
+        FIESER_controller_vfp_register(env, regno, &value, access_type);
+        return value;
+    }
+
+    start = cpu_get_host_ticks();
+    tlb_flush_before = fies_overhead_phase_cycles[FI_OVERHEAD_TLB_FLUSH];
+    FIESER_controller_vfp_register(env, regno, &value, access_type);
+
+    FIESER_overhead_account(site, FI_REGISTER_CONTENT, start, start,
+                            tlb_flush_before);
+
+    return value;
+}
+
+/**
+ * Implements the interface to the fault controller for the memory hook sites,
+ * which access a single value of 1, 2, 4 or 8 bytes. Only called through
+ * FIESER_hook_mem() while fies_enabled is set.
+ *
+ * @param[in] env - Reference to the information of the CPU state or NULL.
+ * @param[in] addr - the accessed address.
+ * @param[in] value - the value, which is read from or written to memory.
+ * @param[in] size - the size of the access in bytes.
+ * @param[in] big_endian - if the access is big-endian.
+ * @param[in] access_type - if the access-operation is a write, read or execute.
+ * @param[in] site - the QEMU function the hook is called from.
+ * @param[out] - the value after the injection.
+ */
+uint64_t FIESER_do_hook_mem(CPUArchState *env, hwaddr addr,
+                            uint64_t value, unsigned size, bool big_endian,
+                            AccessType access_type, FIESCallSite site)
+{
+    uint8_t buf[8];
+#if defined(HOST_WORDS_BIGENDIAN)
+    bool swap = !big_endian && size > 1;
+#else
+    bool swap = big_endian && size > 1;
+#endif
+
+    /* buf holds the accessed bytes in guest memory order */
+    if (swap)
+    {
+        value = bswap64(value) >> (64 - size * 8);
+    }
+    do_inject_memory_store(buf, size, value);
+    FIESER_do_hook_mem_buf(env, addr, buf, size, access_type, site);
+    value = do_inject_memory_load(buf, size);
+
+    return swap ? bswap64(value) >> (64 - size * 8) : value;
+}
+
+void FIESER_timed_terminate_check(CPUArchState *env)
+{
+#if !defined(CONFIG_USER_ONLY)
     CPUState *cpu;
 
     //if (sbst_cycle_count_value > SBST_CYCLES_BEFORE_EXIT && !shutting_down)
     if (unlikely(shutting_down))
     {
+        FIESER_stats_set_phase(FIES_PHASE_TERMINATING);
+        FIESER_stats_experiment_completed();
+        trace_fies_experiment_end(FIESER_timer_get(),
+                                  get_num_injected_faults(),
+                                  get_num_detected_faults());
 
         hmp_info_faults(qemu_serial_monitor, NULL);
 
@@ -1594,8 +2266,28 @@ void FIESER_timed_terminate_check(CPUArchState *env)
 
         qmp_quit(NULL);
     }
+#endif
 }
 
+/**
+ * Turns on the hook sites and the instrumentation of translated code.
+ * Blocks translated before are flushed, so that they are retranslated
+ * with the fault controller helpers.
+ */
+void FIESER_enable(void)
+{
+    if (fies_enabled)
+        return;
+
+    fies_enabled = true;
+
+    if (first_cpu)
+        tb_flush(first_cpu);
+}
+
+/**
+ * Loads the fault library given with -fi, once the machine is set up.
+ */
 void FIESER_init(void)
 {
     static int already_set = false;
@@ -1605,5 +2297,14 @@ void FIESER_init(void)
 
     already_set = true;
 
-    hmp_fault_reload(NULL, NULL);
+#if defined(CONFIG_USER_ONLY)
+    if (fault_library_name)
+        qmp_fault_reload(NULL, fault_library_name, &error_fatal);
+#else
+    qemu_register_reset(FIESER_reset_permanent_faults, NULL);
+    FIESER_dcls_init();
+
+    if (fault_library_name)
+        hmp_fault_reload(NULL, NULL);
+#endif
 }
@@ -20,23 +20,130 @@
 #include "exec/exec-all.h"
 
 #include "fault-injection-infrastructure.h"
+#include "fault-injection-config.h"
 
 /**
  * see corresponding c-file for documentation
  */
-extern void FIESER_hook(CPUArchState *env, hwaddr *addr,
+extern void FIESER_do_hook(CPUArchState *env, hwaddr *addr,
         uint32_t *value, InjectionMode injection_mode,
-        AccessType access_type);
+        AccessType access_type, FIESCallSite site);
+
+/**
+ * Interface of the fault controller for all hook sites in QEMU.
+ * Without fault injection or profiling this is a single predicted
+ * branch, so the same binary runs golden runs at full speed.
+ */
+static inline void FIESER_hook(CPUArchState *env, hwaddr *addr,
+        uint32_t *value, InjectionMode injection_mode,
+        AccessType access_type, FIESCallSite site)
+{
+    if (unlikely(fies_enabled))
+        FIESER_do_hook(env, addr, value, injection_mode, access_type, site);
+}
+
+/**
+ * see corresponding c-file for documentation
+ */
+extern uint64_t FIESER_do_hook_mem(CPUArchState *env, hwaddr addr,
+        uint64_t value, unsigned size, bool big_endian,
+        AccessType access_type, FIESCallSite site);
+extern void FIESER_do_hook_mem_buf(CPUArchState *env, hwaddr addr,
+        uint8_t *buf, hwaddr len, AccessType access_type,
+        FIESCallSite site);
+
+/**
+ * Interface of the fault controller for the memory hook sites, which
+ * access the memory with a single load or store of 1, 2, 4 or 8 bytes.
+ * The accessed value is passed and returned by value, so it is
+ * independent of the type the hook site holds it in. big_endian gives
+ * the byte order of the access, which maps the value to the addressed
+ * bytes. size is a constant at all hook sites, hence this is
+ * specialized per access size when inlined.
+ */
+static inline uint64_t FIESER_hook_mem(CPUArchState *env, hwaddr addr,
+        uint64_t value, unsigned size, bool big_endian,
+        AccessType access_type, FIESCallSite site)
+{
+    if (unlikely(fies_enabled))
+        return FIESER_do_hook_mem(env, addr, value, size, big_endian,
+                                  access_type, site);
+
+    return value;
+}
+
+/**
+ * Interface of the fault controller for the hook sites, which transfer
+ * a buffer of arbitrary length (e.g. DMA), in guest memory order.
+ */
+static inline void FIESER_hook_mem_buf(CPUArchState *env, hwaddr addr,
+        uint8_t *buf, hwaddr len, AccessType access_type,
+        FIESCallSite site)
+{
+    if (unlikely(fies_enabled))
+        FIESER_do_hook_mem_buf(env, addr, buf, len, access_type, site);
+}
+
+/**
+ * see corresponding c-file for documentation
+ */
+extern uint64_t FIESER_do_hook_reg(CPUArchState *env, hwaddr regno,
+        uint64_t value, AccessType access_type, FIESCallSite site);
+
+/**
+ * Interface of the fault controller for the register hook sites,
+ * which access registers of up to 64 bits. The accessed value is
+ * passed and returned by value, like for FIESER_hook_mem().
+ */
+static inline uint64_t FIESER_hook_reg(CPUArchState *env, hwaddr regno,
+        uint64_t value, AccessType access_type, FIESCallSite site)
+{
+    if (unlikely(fies_enabled))
+        return FIESER_do_hook_reg(env, regno, value, access_type, site);
+
+    return value;
+}
+
+/**
+ * see corresponding c-file for documentation
+ */
+extern uint64_t FIESER_do_hook_vfp(CPUArchState *env, hwaddr regno,
+        uint64_t value, AccessType access_type, FIESCallSite site);
+
+/**
+ * Interface of the fault controller for the VFP and NEON register hook
+ * sites (see FIESER_hook_reg()).
+ */
+static inline uint64_t FIESER_hook_vfp(CPUArchState *env, hwaddr regno,
+        uint64_t value, AccessType access_type, FIESCallSite site)
+{
+    if (unlikely(fies_enabled))
+        return FIESER_do_hook_vfp(env, regno, value, access_type, site);
+
+    return value;
+}
+
+extern void FIESER_arm_permanent_faults(void);
+extern void FIESER_controller_scheduled(CPUArchState *env, FaultList *fault, bool active);
+extern bool FIESER_tlb_filtered(target_ulong vaddr, bool is_write);
+extern bool FIESER_fault_active(FaultList *fault);
+extern bool FIESER_insn_armed(target_ulong pc);
+extern bool FIESER_register_armed(int regno);
+extern bool FIESER_register_range_armed(int regno, int count);
+extern bool FIESER_vfp_register_armed(int regno);
+extern bool FIESER_pc_armed(target_ulong pc);
+extern bool FIESER_time_armed(void);
+extern bool FIESER_mem_armed(void);
+extern bool FIESER_mem_range_armed(target_ulong addr, target_ulong len);
+extern bool FIESER_insn_fault_active(target_ulong pc);
+extern void FIESER_invalidate_insn_faults(void);
 extern int64_t FIESER_timer_get(void);
 extern int64_t FIESER_normalize_time_to_int64(const char* val, int* success);
 extern void FIESER_timer_init(void);
-extern void FIESER_helper_init_ops_on_cell(int size);
-extern void FIESER_helper_destroy_ops_on_cell(void);
 extern int FIESER_helper_ends_with(const char *string, const char *ending);
 extern int FIESER_timer_to_int(const char *string);
 
 extern void FIESER_timed_terminate_check(CPUArchState *env);
-extern void FIESER_init(void);
 extern void FIESER_setMonitor(Monitor *mon);
 
 //void fault_reload_arg();
@@ -0,0 +1,321 @@
+/*
+ * fault-injection-coupling.c
+ *
+ *  FIESer by Christian M. Fuchs 2017/2018
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+#include "qemu/range.h"
+
+#include "fault-injection-coupling.h"
+#include "fault-injection-controller.h"
+#include "fault-injection-injector.h"
+#include "fault-injection-data-analyzer.h"
+#include "fault-injection-index.h"
+#include "trace-root.h"
+
+/**
+ * The view of one memory cell of a coupling fault during an access:
+ * its content in memory before the access, the value it holds after
+ * the access (the written or the returned value) and the bits of the
+ * cell, which are transferred by the access.
+ */
+typedef struct {
+    hwaddr addr;
+    bool accessed;
+    uint64_t memory;
+    uint64_t value;
+    uint64_t covered;
+} CouplingCell;
+
+/**
+ * Checks if all bits selected by mask are in the given state.
+ */
+static inline bool FIESER_coupling_in_state(uint64_t value, uint64_t mask,
+                                            int state)
+{
+    return (value & mask) == (state ? mask : 0);
+}
+
+/**
+ * Returns the bits selected by mask, which are in the given state.
+ */
+static inline uint64_t FIESER_coupling_bits_in_state(uint64_t value,
+                                                     uint64_t mask, int state)
+{
+    return (state ? value : ~value) & mask;
+}
+
+/**
+ * Returns value with the bits selected by mask forced to the given state.
+ */
+static inline uint64_t FIESER_coupling_force(uint64_t value, uint64_t mask,
+                                             int state)
+{
+    return state ? value | mask : value & ~mask;
+}
+
+/**
+ * Reads a cell of a coupling fault and merges the bytes of the access into
+ * it. The memory is accessed without passing the memory hooks.
+ *
+ * @param[in] cpu - the CPU, through which the memory is accessed.
+ * @param[out] cell - the view of the cell.
+ * @param[in] cell_addr - the address of the cell.
+ * @param[in] size - the width of the cell in bytes.
+ * @param[in] addr - the first accessed address.
+ * @param[in] buf - the accessed bytes in guest memory order.
+ * @param[in] len - the length of the access in bytes.
+ */
+static void FIESER_coupling_cell_load(CPUState *cpu, CouplingCell *cell,
+                                      hwaddr cell_addr, unsigned size,
+                                      hwaddr addr, const uint8_t *buf,
+                                      hwaddr len)
+{
+    uint8_t bytes[8] = {0}, mask[8] = {0};
+    hwaddr lo, hi;
+
+    cell->addr = cell_addr;
+    cell->accessed = ranges_overlap(cell_addr, size, addr, len);
+
+    cpu_memory_rw_debug(cpu, cell_addr, bytes, size, 0);
+    cell->memory = do_inject_memory_load(bytes, size);
+
+    if (cell->accessed)
+    {
+        lo = MAX(cell_addr, addr);
+        hi = MIN(cell_addr + size, addr + len);
+        memcpy(bytes + (lo - cell_addr), buf + (lo - addr), hi - lo);
+        memset(mask + (lo - cell_addr), 0xff, hi - lo);
+    }
+
+    cell->value = do_inject_memory_load(bytes, size);
+    cell->covered = do_inject_memory_load(mask, size);
+}
+
+/**
+ * Writes the faulty state of the victim cell back to the memory and, if
+ * the victim is accessed, to the bytes of the access.
+ *
+ * @param[in] cpu - the CPU, through which the memory is accessed.
+ * @param[in] cell - the view of the victim cell.
+ * @param[in] size - the width of the cell in bytes.
+ * @param[in] memory - the new content of the cell in memory.
+ * @param[in] value - the new value of the cell as seen by the access.
+ * @param[in] addr - the first accessed address.
+ * @param[in] buf - the accessed bytes in guest memory order.
+ * @param[in] len - the length of the access in bytes.
+ */
+static void FIESER_coupling_cell_store(CPUState *cpu, CouplingCell *cell,
+                                       unsigned size, uint64_t memory,
+                                       uint64_t value, hwaddr addr,
+                                       uint8_t *buf, hwaddr len)
+{
+    uint8_t bytes[8];
+    hwaddr lo, hi;
+
+    if (memory != cell->memory)
+    {
+        do_inject_memory_store(bytes, size, memory);
+        cpu_memory_rw_debug(cpu, cell->addr, bytes, size, 1);
+    }
+
+    if (cell->accessed && value != cell->value)
+    {
+        lo = MAX(cell->addr, addr);
+        hi = MIN(cell->addr + size, addr + len);
+        do_inject_memory_store(bytes, size, value);
+        memcpy(buf + (lo - addr), bytes + (lo - cell->addr), hi - lo);
+    }
+}
+
+/**
+ * Evaluates a coupling fault for an access, which touches its victim or
+ * aggressor cell (or both). The victim bits are <mask> of the cell at
+ * <address>, the aggressor bits <set_bit> (or <mask>) of the cell at
+ * <cf_address>. On writes, the victim is evaluated after the access (the
+ * written value), the aggressor before and after it. On reads, the read
+ * value and the content of the victim in memory may differ, which models
+ * the destructive and deceptive reads.
+ *
+ * @param[in] cpu - the CPU, through which the memory is accessed.
+ * @param[in] fault - pointer to the linked list entry.
+ * @param[in] addr - the first accessed address.
+ * @param[in] buf - the accessed bytes in guest memory order.
+ * @param[in] len - the length of the access in bytes.
+ * @param[in] access_type - if the access-operation is a write, read or execute.
+ */
+static void FIESER_coupling_fault(CPUState *cpu, FaultList *fault,
+                                  hwaddr addr, uint8_t *buf, hwaddr len,
+                                  AccessType access_type)
+{
+    struct coupling *cf = &fault->coupling;
+    unsigned size = fault->params.width / 8;
+    uint64_t vmask = fault->params.mask;
+    uint64_t amask = fault->params.set_bit ? fault->params.set_bit : vmask;
+    bool is_write = access_type == write_access_type;
+    CouplingCell victim, aggressor;
+    uint64_t memory, value, bits;
+    bool sensitized;
+
+    FIESER_coupling_cell_load(cpu, &victim, (uint32_t) fault->params.address,
+                              size, addr, buf, len);
+
+    if ((uint32_t) fault->params.cf_address == victim.addr)
+        aggressor = victim;
+    else
+        FIESER_coupling_cell_load(cpu, &aggressor,
+                                  (uint32_t) fault->params.cf_address,
+                                  size, addr, buf, len);
+
+    /**
+     * the state of the victim after the access, in memory and as seen
+     * by the access (a read returns victim.value, a write stores it)
+     */
+    memory = is_write ? victim.value : victim.memory;
+    value = victim.value;
+
+    /**
+     * the aggressor is sensitizing after the access
+     */
+    sensitized = FIESER_coupling_in_state(is_write ? aggressor.value : aggressor.memory,
+                                          amask, cf->aggressor_state);
+
+    switch (cf->kind)
+    {
+    case FI_CF_STATE:
+        /**
+         * while the aggressor is in state a, the victim is stuck at v
+         */
+        if (sensitized)
+        {
+            memory = FIESER_coupling_force(memory, vmask, cf->victim_state);
+            value = FIESER_coupling_force(value, vmask, cf->victim_state);
+        }
+        break;
+    case FI_CF_TRANSITION:
+        /**
+         * a write to the victim fails to make the transition v -> !v
+         */
+        if (sensitized && is_write && victim.accessed)
+        {
+            bits = FIESER_coupling_bits_in_state(victim.memory, vmask & victim.covered,
+                                                 cf->victim_state)
+                    & ~FIESER_coupling_bits_in_state(victim.value, vmask,
+                                                     cf->victim_state);
+            memory = value = cf->victim_state ? memory | bits : memory & ~bits;
+        }
+        break;
+    case FI_CF_WRITE_DESTRUCTIVE:
+        /**
+         * a non-transition write of v to the victim flips it
+         */
+        if (sensitized && is_write && victim.accessed)
+        {
+            bits = FIESER_coupling_bits_in_state(victim.memory, vmask & victim.covered,
+                                                 cf->victim_state)
+                    & FIESER_coupling_bits_in_state(victim.value, vmask,
+                                                    cf->victim_state);
+            memory = value = memory ^ bits;
+        }
+        break;
+    case FI_CF_READ_DESTRUCTIVE:
+    case FI_CF_INCORRECT_READ:
+    case FI_CF_DECEPTIVE_READ:
+        /**
+         * a read of v from the victim returns !v (RD, IR) and flips the
+         * cell (RD, DR)
+         */
+        if (sensitized && !is_write && victim.accessed)
+        {
+            bits = FIESER_coupling_bits_in_state(victim.memory, vmask & victim.covered,
+                                                 cf->victim_state);
+            if (cf->kind != FI_CF_DECEPTIVE_READ)
+                value ^= bits;
+            if (cf->kind != FI_CF_INCORRECT_READ)
+                memory ^= bits;
+        }
+        break;
+    case FI_CF_DISTURB:
+        /**
+         * an operation on the aggressor in state a flips the victim,
+         * if it is in state v
+         */
+        if (!aggressor.accessed || (aggressor.covered & amask) != amask
+                || !FIESER_coupling_in_state(aggressor.memory, amask,
+                                             cf->aggressor_state))
+            break;
+
+        if (cf->aggressor_op == FI_CF_OP_READ && is_write)
+            break;
+
+        if (cf->aggressor_op != FI_CF_OP_READ
+                && (!is_write || !FIESER_coupling_in_state(aggressor.value, amask,
+                                                           cf->aggressor_op)))
+            break;
+
+        bits = FIESER_coupling_bits_in_state(memory, vmask, cf->victim_state);
+        memory ^= bits;
+        if (is_write)
+            value = memory;
+        break;
+    default:
+        return;
+    }
+
+    if (memory == victim.memory && value == victim.value)
+        return;
+
+    FIESER_coupling_cell_store(cpu, &victim, size, memory, value,
+                               addr, buf, len);
+
+    incr_num_injected_faults(fault->id, FI_COMP_RAM, fault->type == FI_TYPE_PERMANENT
+                             ? FI_TYPE_PERMANENT : FI_TYPE_TRANSIENT);
+    fault->was_triggered = 1;
+
+    trace_fies_coupling_fault(fault->id, cf->name, victim.addr, access_type,
+                              victim.memory, memory, value);
+}
+
+/**
+ * Looks up the coupling faults, whose victim or aggressor cell overlaps the
+ * accessed range, in the address index and evaluates them. Only the pages of
+ * these cells are routed to the memory hooks (see FIESER_tlb_filtered), so
+ * accesses to other pages are not slowed down by coupling faults.
+ *
+ * @param[in] env - Reference to the information of the CPU state.
+ * @param[in] addr - the first accessed address.
+ * @param[in] buf - the accessed bytes in guest memory order.
+ * @param[in] len - the length of the access in bytes.
+ * @param[in] access_type - if the access-operation is a write, read or execute.
+ */
+void FIESER_coupling_access(CPUArchState *env, hwaddr addr, uint8_t *buf,
+                            hwaddr len, AccessType access_type)
+{
+    FaultList *fault;
+    hwaddr cell;
+    int pos = FIESER_index_lookup(FI_INDEX_COUPLING, addr, len);
+
+    while ((fault = FIESER_index_next_cell(FI_INDEX_COUPLING, addr, &pos, &cell)))
+    {
+        /**
+         * an access covering both cells is evaluated once, at the victim
+         */
+        if (cell != (uint32_t) fault->params.address
+                && ranges_overlap((uint32_t) fault->params.address,
+                                  fault->params.width / 8, addr, len))
+            continue;
+
+        if (!FIESER_fault_active(fault))
+            continue;
+
+        FIESER_coupling_fault(ENV_GET_CPU(env), fault, addr, buf, len,
+                              access_type);
+    }
+}
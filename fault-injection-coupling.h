@@ -0,0 +1,27 @@
+/*
+ * fault-injection-coupling.h
+ *
+ *  FIESer by Christian M. Fuchs 2017/2018
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#ifndef FAULT_INJECTION_COUPLING_H_
+#define FAULT_INJECTION_COUPLING_H_
+
+#include "qemu/osdep.h"
+#include "cpu.h"
+
+#include "fault-injection-infrastructure.h"
+
+/**
+ * see corresponding c-file for documentation
+ */
+void FIESER_coupling_access(CPUArchState *env, hwaddr addr, uint8_t *buf,
+                            hwaddr len, AccessType access_type);
+
+#endif /* FAULT_INJECTION_COUPLING_H_ */
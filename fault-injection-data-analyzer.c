@@ -14,6 +14,8 @@
 #include "fault-injection-controller.h"
 #include "fault-injection-config.h"
 #include "fault-injection-library.h"
+#include "fault-injection-stats.h"
+#include "trace-root.h"
 
 
 /**
@@ -28,6 +30,11 @@ static int num_injected_faults_cpu_perm = 0;
 static int num_injected_faults_register_trans = 0;
 static int num_injected_faults_register_perm = 0;
 
+/**
+ * The number of faults detected by QEMU itself, e.g. in DCLS mode.
+ */
+static int num_detected_faults = 0;
+
 static CPUState *next_cpu;
 /**
  * The id array decides, if the number of fault should be
@@ -54,6 +61,8 @@ void incr_num_injected_faults(int id, enum FaultComponent target, enum FaultType
         return;
 
     num_injected_faults++;
+    FIESER_stats_count_activation();
+    trace_fies_fault_activated(id + 1, target, type);
 
     if (FI_COMP_CPU)
     {
@@ -155,7 +164,15 @@ for (; next_cpu != NULL; next_cpu = CPU_NEXT(next_cpu))
     }
 
     return memword;*/
-    return 0;
+    return num_detected_faults;
+}
+
+/**
+ * Increments the number of detected faults.
+ */
+void incr_num_detected_faults(void)
+{
+    num_detected_faults++;
 }
 
 /**
@@ -167,6 +184,8 @@ for (; next_cpu != NULL; next_cpu = CPU_NEXT(next_cpu))
  */
 void set_num_detected_faults(int num)
 {
+    num_detected_faults = num;
+
     /*uint8_t *membytes = (uint8_t *)&num;
 
 if (next_cpu == NULL)
@@ -23,6 +23,7 @@ void set_num_injected_faults(int num);
 void set_input_file_to_use(int num);
 int get_num_injected_faults(void);
 int get_num_detected_faults(void);
+void incr_num_detected_faults(void);
 void set_num_detected_faults(int num);
 void set_num_injected_faults_ram_trans(int num);
 void set_num_injected_faults_ram_perm(int num);
@@ -0,0 +1,839 @@
+/*
+ * fault-injection-dcls.c
+ *
+ *  FIESer by Christian M. Fuchs 2017/2018
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+#include "qemu/log.h"
+#include "qemu/error-report.h"
+#include "qemu/bitops.h"
+#include "qemu/main-loop.h"
+#include "sysemu/sysemu.h"
+
+#include "fault-injection-dcls.h"
+#include "fault-injection-data-analyzer.h"
+#include "trace-root.h"
+
+/**
+ * Set by -fi-dcls. Every TB is then executed twice, once by the faulted
+ * context and once by a fault-free shadow context, and the results of both
+ * are compared, like a dual-core lockstep (DCLS) processor compares the
+ * outputs of its cores.
+ */
+bool fies_dcls;
+
+__thread bool fies_dcls_active;
+__thread bool fies_dcls_shadow;
+
+#if !defined(CONFIG_USER_ONLY)
+
+/**
+ * The buffers of a context mirror CPUArchState, but only hold the ranges
+ * of the architectural state.
+ */
+#define FIES_DCLS_STATE offsetof(CPUArchState, end_reset_fields)
+
+typedef struct {
+    uint32_t offset;
+    uint32_t size;
+} FIESDclsRange;
+
+#define FIES_DCLS_FIELD(field) \
+    ((FIESDclsRange) { offsetof(CPUArchState, field), \
+                       sizeof(typeof_field(CPUArchState, field)) })
+
+/**
+ * The ranges of the architectural state, which are swapped between the
+ * faulted and the shadow context and hashed: the register file and flags,
+ * the M-profile special registers, the pending exception, the exclusive
+ * monitor and, as last range, the VFP/NEON registers, which are only
+ * swapped for TBs accessing them. The system registers and all other
+ * state are shared by both contexts.
+ */
+static FIESDclsRange fies_dcls_ranges[5];
+static int fies_dcls_num_ranges;
+
+/**
+ * A logged store to RAM: the stored bytes before (old) and after (new) the
+ * store.
+ */
+typedef struct {
+    uint8_t *host;
+    unsigned size;
+    uint8_t old[8];
+    uint8_t new[8];
+} FIESDclsStore;
+
+/**
+ * A logged device access (MMIO or a coprocessor register with side
+ * effects) and the changes it made to the architectural state, which are
+ * the deltas [delta, delta + count).
+ */
+typedef struct {
+    uint64_t addr;
+    unsigned size;
+    bool is_write;
+    uint64_t val;
+    guint delta;
+    guint count;
+} FIESDclsIo;
+
+typedef struct {
+    uint32_t offset;
+    uint8_t value;
+} FIESDclsDelta;
+
+/**
+ * A memory hook of the faulted context, i.e. an access, which the RAM
+ * faults may change: the accessed address, the address after the hook and
+ * the accessed bytes before (pre) and after (post) the hook, which are kept
+ * at these offsets of the byte log. done is set, once the hook returned.
+ */
+typedef struct {
+    uint64_t addr;
+    uint64_t new_addr;
+    uint64_t len;
+    AccessType access_type;
+    guint pre;
+    guint post;
+    bool done;
+} FIESDclsMem;
+
+/**
+ * The lockstep state of a CPU. shadow is the start state of the shadow
+ * context. While pinned is set, i.e. after a fault was injected, shadow is
+ * kept fault-free and only advanced by the changes to the faulted context
+ * since baseline, which are not made by TBs.
+ */
+typedef struct {
+    uint8_t *env;
+    uint8_t *shadow;
+    uint8_t *baseline;
+    uint8_t *primary;
+    uint8_t *io_pre;
+    bool pinned;
+    int ranges;
+
+    GArray *stores;
+    GArray *io;
+    GArray *deltas;
+    guint io_pos;
+    bool io_diverged;
+    GArray *mem;
+    GByteArray *mem_data;
+    guint mem_pos;
+    uint64_t hash;
+
+    tcg_target_ulong ret;
+    bool primary_raised;
+    int primary_exception;
+    uint64_t primary_hash;
+    guint primary_stores;
+    TranslationBlock *shadow_tb;
+    bool checked;
+} FIESDclsCpu;
+
+static FIESDclsCpu **fies_dcls_cpus;
+static __thread FIESDclsCpu *fies_dcls_current;
+
+/**
+ * The number of injected faults at the last detection. A fault is counted
+ * as detected once, however often its effects make the contexts diverge.
+ */
+static int fies_dcls_injected;
+
+/**
+ * Sets up the lockstep state. Called by FIESER_init().
+ */
+void FIESER_dcls_init(void)
+{
+    if (!fies_dcls)
+        return;
+
+    /**
+     * the other CPUs would see the stores of a TB undone and redone
+     */
+    if (smp_cpus > 1 && qemu_tcg_mttcg_enabled())
+    {
+        error_report("-fi-dcls with %d CPUs requires -accel tcg,thread=single",
+                     smp_cpus);
+        exit(1);
+    }
+
+    fies_dcls_num_ranges = 0;
+    fies_dcls_ranges[fies_dcls_num_ranges++] =
+        (FIESDclsRange) { 0, offsetof(CPUArchState, cp15) };
+    if (first_cpu && arm_feature(&ARM_CPU(first_cpu)->env, ARM_FEATURE_M))
+        fies_dcls_ranges[fies_dcls_num_ranges++] = FIES_DCLS_FIELD(v7m);
+    fies_dcls_ranges[fies_dcls_num_ranges++] = FIES_DCLS_FIELD(exception);
+    fies_dcls_ranges[fies_dcls_num_ranges++] =
+        (FIESDclsRange) { offsetof(CPUArchState, exclusive_addr),
+                          offsetof(CPUArchState, iwmmxt)
+                          - offsetof(CPUArchState, exclusive_addr) };
+    fies_dcls_ranges[fies_dcls_num_ranges++] = FIES_DCLS_FIELD(vfp);
+
+    fies_dcls_cpus = g_new0(FIESDclsCpu *, max_cpus);
+}
+
+/**
+ * Returns the lockstep state of a CPU, which is allocated on first use.
+ *
+ * @param[in] cpu - the CPU.
+ * @param[out] - the lockstep state or NULL, if DCLS was not set up.
+ */
+static FIESDclsCpu *FIESER_dcls_cpu(CPUState *cpu)
+{
+    FIESDclsCpu *d;
+
+    if (!fies_dcls_cpus || cpu->cpu_index >= max_cpus)
+        return NULL;
+
+    d = fies_dcls_cpus[cpu->cpu_index];
+    if (!d)
+    {
+        d = g_new0(FIESDclsCpu, 1);
+        d->env = cpu->env_ptr;
+        d->shadow = g_malloc0(FIES_DCLS_STATE);
+        d->baseline = g_malloc0(FIES_DCLS_STATE);
+        d->primary = g_malloc0(FIES_DCLS_STATE);
+        d->io_pre = g_malloc0(FIES_DCLS_STATE);
+        d->stores = g_array_new(false, false, sizeof(FIESDclsStore));
+        d->io = g_array_new(false, false, sizeof(FIESDclsIo));
+        d->deltas = g_array_new(false, false, sizeof(FIESDclsDelta));
+        d->mem = g_array_new(false, false, sizeof(FIESDclsMem));
+        d->mem_data = g_byte_array_new();
+        fies_dcls_cpus[cpu->cpu_index] = d;
+    }
+
+    return d;
+}
+
+/**
+ * Copies the first ranges of the architectural state.
+ *
+ * @param[in] dst - the state copied to.
+ * @param[in] src - the state copied from.
+ * @param[in] ranges - the number of ranges.
+ */
+static void FIESER_dcls_copy(uint8_t *dst, const uint8_t *src, int ranges)
+{
+    int n;
+
+    for (n = 0; n < ranges; n++)
+        memcpy(dst + fies_dcls_ranges[n].offset,
+               src + fies_dcls_ranges[n].offset, fies_dcls_ranges[n].size);
+}
+
+/**
+ * Mixes a value into the hash of the results of a context.
+ */
+static inline uint64_t FIESER_dcls_mix(uint64_t hash, uint64_t value)
+{
+    hash ^= value * 0x9e3779b97f4a7c15ULL;
+    return rol64(hash, 31) * 0xff51afd7ed558ccdULL;
+}
+
+/**
+ * Mixes the first ranges of the architectural state into the hash of the
+ * stores of a context, so that the results of both contexts are compared
+ * in one go.
+ *
+ * @param[in] hash - the hash of the stores.
+ * @param[in] env - the state.
+ * @param[in] ranges - the number of ranges.
+ * @param[out] - the hash of the results.
+ */
+static uint64_t FIESER_dcls_hash_state(uint64_t hash, const uint8_t *env,
+                                       int ranges)
+{
+    const FIESDclsRange *range;
+    uint64_t word;
+    uint32_t i;
+    int n;
+
+    for (n = 0; n < ranges; n++)
+    {
+        range = &fies_dcls_ranges[n];
+
+        for (i = 0; i < range->size; i += sizeof(word))
+        {
+            word = 0;
+            memcpy(&word, env + range->offset + i,
+                   MIN(sizeof(word), range->size - i));
+            hash = FIESER_dcls_mix(hash, word);
+        }
+    }
+
+    return hash;
+}
+
+/**
+ * Records the bytes of the architectural state, which differ between env
+ * and a copy of it, in the deltas of the lockstep state.
+ *
+ * @param[in] d - the lockstep state.
+ * @param[in] copy - the copy.
+ */
+static void FIESER_dcls_diff(FIESDclsCpu *d, const uint8_t *copy)
+{
+    const FIESDclsRange *range;
+    FIESDclsDelta delta;
+    uint32_t i;
+    int n;
+
+    for (n = 0; n < d->ranges; n++)
+    {
+        range = &fies_dcls_ranges[n];
+
+        if (!memcmp(d->env + range->offset, copy + range->offset, range->size))
+            continue;
+
+        for (i = range->offset; i < range->offset + range->size; i++)
+        {
+            if (d->env[i] != copy[i])
+            {
+                delta.offset = i;
+                delta.value = d->env[i];
+                g_array_append_val(d->deltas, delta);
+            }
+        }
+    }
+}
+
+/**
+ * Logs a store to RAM of the running context and hashes its address, size
+ * and value, before the store is performed. Called for all stores of a TB
+ * in lockstep, as FIESER_tlb_filtered() routes them through the slow path.
+ *
+ * @param[in] addr - the virtual address of the store.
+ * @param[in] val - the stored value.
+ * @param[in] size - the size of the store in bytes.
+ * @param[in] host - the host address of the stored bytes.
+ */
+void FIESER_dcls_do_store(target_ulong addr, uint64_t val, unsigned size,
+                          void *host)
+{
+    FIESDclsCpu *d = fies_dcls_current;
+    FIESDclsStore store;
+
+    g_assert(size <= sizeof(store.old));
+
+    d->hash = FIESER_dcls_mix(d->hash, (uint64_t) addr << 4 | size);
+    d->hash = FIESER_dcls_mix(d->hash, val);
+
+    store.host = host;
+    store.size = size;
+    memcpy(store.old, host, size);
+    g_array_append_val(d->stores, store);
+}
+
+/**
+ * Undoes the logged stores from the last one back to the first-th one.
+ *
+ * @param[in] d - the lockstep state.
+ * @param[in] first - the first store, which is undone.
+ * @param[in] keep - if the stored bytes are kept for FIESER_dcls_redo().
+ */
+static void FIESER_dcls_undo(FIESDclsCpu *d, guint first, bool keep)
+{
+    FIESDclsStore *store;
+    guint i;
+
+    for (i = d->stores->len; i > first; i--)
+    {
+        store = &g_array_index(d->stores, FIESDclsStore, i - 1);
+
+        if (keep)
+            memcpy(store->new, store->host, store->size);
+        memcpy(store->host, store->old, store->size);
+    }
+}
+
+/**
+ * Performs the first count logged stores again.
+ */
+static void FIESER_dcls_redo(FIESDclsCpu *d, guint count)
+{
+    FIESDclsStore *store;
+    guint i;
+
+    for (i = 0; i < count; i++)
+    {
+        store = &g_array_index(d->stores, FIESDclsStore, i);
+        memcpy(store->host, store->new, store->size);
+    }
+}
+
+/**
+ * Is called before a device access of a TB in lockstep. The faulted context
+ * performs the access, the shadow context is not allowed to touch devices:
+ * its access is checked against the one the faulted context made at the
+ * same point and replayed from the log, including the changes the access
+ * made to the architectural state.
+ *
+ * @param[in] addr - the address of the access.
+ * @param[in] size - the size of the access in bytes.
+ * @param[in,out] val - the written value or the read value, if replayed.
+ * @param[in] is_write - if the access is a write.
+ * @param[out] - true if the access was replayed and must not be performed.
+ */
+bool FIESER_dcls_io_begin(uint64_t addr, unsigned size, uint64_t *val,
+                          bool is_write)
+{
+    FIESDclsCpu *d = fies_dcls_current;
+    FIESDclsDelta *delta;
+    FIESDclsIo *io = NULL;
+    guint i;
+
+    if (!fies_dcls_shadow)
+    {
+        FIESER_dcls_copy(d->io_pre, d->env, d->ranges);
+        return false;
+    }
+
+    if (d->io_pos < d->io->len)
+        io = &g_array_index(d->io, FIESDclsIo, d->io_pos);
+
+    if (!io || io->addr != addr || io->size != size
+            || io->is_write != is_write || (is_write && io->val != *val))
+    {
+        d->io_diverged = true;
+        if (!is_write)
+            *val = 0;
+        return true;
+    }
+
+    d->io_pos++;
+    if (!is_write)
+        *val = io->val;
+
+    for (i = 0; i < io->count; i++)
+    {
+        delta = &g_array_index(d->deltas, FIESDclsDelta, io->delta + i);
+        d->env[delta->offset] = delta->value;
+    }
+
+    return true;
+}
+
+/**
+ * Is called after a device access of the faulted context and logs it.
+ *
+ * @param[in] addr - the address of the access.
+ * @param[in] size - the size of the access in bytes.
+ * @param[in] val - the written or read value.
+ * @param[in] is_write - if the access is a write.
+ */
+void FIESER_dcls_io_end(uint64_t addr, unsigned size, uint64_t val,
+                        bool is_write)
+{
+    FIESDclsCpu *d = fies_dcls_current;
+    FIESDclsIo io;
+
+    if (fies_dcls_shadow)
+        return;
+
+    io.addr = addr;
+    io.size = size;
+    io.is_write = is_write;
+    io.val = val;
+    io.delta = d->deltas->len;
+
+    FIESER_dcls_diff(d, d->io_pre);
+
+    io.count = d->deltas->len - io.delta;
+    g_array_append_val(d->io, io);
+}
+
+/**
+ * Is called before a memory hook of a TB in lockstep. The faulted context
+ * runs the hook, i.e. injects the RAM faults, and logs the access. The
+ * shadow context runs no hook, but is given the effects the hook had on the
+ * same access of the faulted context, so both contexts see the same faulty
+ * memory. An access of the shadow context, which transfers other bytes than
+ * the faulted one, is left untouched, as the contexts diverged already, and
+ * accesses only the faulted context made (e.g. the page table walk of a TLB
+ * fill) are skipped.
+ *
+ * @param[in,out] addr - the accessed address or the address after the hook,
+ *                       if replayed.
+ * @param[in,out] buf - the accessed bytes in guest memory order or NULL.
+ * @param[in] len - the length of the access in bytes.
+ * @param[in] access_type - if the access-operation is a write, read or execute.
+ * @param[out] - true if the hook was replayed and must not be run.
+ */
+bool FIESER_dcls_do_mem_begin(hwaddr *addr, uint8_t *buf, hwaddr len,
+                              AccessType access_type)
+{
+    FIESDclsCpu *d = fies_dcls_current;
+    FIESDclsMem mem, *m;
+    guint i;
+
+    if (!fies_dcls_shadow)
+    {
+        mem.addr = *addr;
+        mem.new_addr = *addr;
+        mem.len = len;
+        mem.access_type = access_type;
+        mem.pre = d->mem_data->len;
+        mem.post = mem.pre;
+        mem.done = false;
+
+        if (len)
+            g_byte_array_append(d->mem_data, buf, len);
+        g_array_append_val(d->mem, mem);
+        return false;
+    }
+
+    for (i = d->mem_pos; i < d->mem->len; i++)
+    {
+        m = &g_array_index(d->mem, FIESDclsMem, i);
+
+        if (!m->done || m->addr != *addr || m->len != len
+                || m->access_type != access_type
+                || (len && memcmp(d->mem_data->data + m->pre, buf, len)))
+            continue;
+
+        d->mem_pos = i + 1;
+        *addr = m->new_addr;
+        if (len)
+            memcpy(buf, d->mem_data->data + m->post, len);
+        break;
+    }
+
+    return true;
+}
+
+/**
+ * Is called after a memory hook of the faulted context and logs its effects.
+ * Hooks nest, if the fault controller accesses the memory itself, so the
+ * innermost hook, which did not return yet, is completed.
+ *
+ * @param[in] addr - the address after the hook.
+ * @param[in] buf - the accessed bytes after the hook or NULL.
+ * @param[in] len - the length of the access in bytes.
+ */
+void FIESER_dcls_do_mem_end(hwaddr addr, const uint8_t *buf, hwaddr len)
+{
+    FIESDclsCpu *d = fies_dcls_current;
+    FIESDclsMem *m;
+    guint i = d->mem->len;
+
+    do
+    {
+        m = &g_array_index(d->mem, FIESDclsMem, --i);
+    } while (m->done && i > 0);
+
+    m->new_addr = addr;
+    m->post = d->mem_data->len;
+    m->done = true;
+
+    if (len)
+        g_byte_array_append(d->mem_data, buf, len);
+}
+
+/**
+ * Pins the shadow context to the state before a fault is injected into a
+ * CPU by the scheduler. Called with the CPU outside of its TBs.
+ */
+void FIESER_dcls_inject_begin(CPUState *cpu)
+{
+    FIESDclsCpu *d;
+
+    if (!fies_dcls || !(d = FIESER_dcls_cpu(cpu)) || d->pinned)
+        return;
+
+    FIESER_dcls_copy(d->shadow, d->env, fies_dcls_num_ranges);
+    d->pinned = true;
+}
+
+/**
+ * Takes the state after the injection as baseline, so that the injected
+ * changes are not passed on to the shadow context.
+ */
+void FIESER_dcls_inject_end(CPUState *cpu)
+{
+    FIESDclsCpu *d;
+
+    if (!fies_dcls || !(d = FIESER_dcls_cpu(cpu)) || !d->pinned)
+        return;
+
+    FIESER_dcls_copy(d->baseline, d->env, fies_dcls_num_ranges);
+}
+
+/**
+ * Passes the changes made to the faulted context outside of TBs since
+ * baseline, e.g. by taking an interrupt, on to the pinned shadow context.
+ */
+static void FIESER_dcls_advance(FIESDclsCpu *d)
+{
+    const FIESDclsRange *range;
+    uint32_t i;
+    int n;
+
+    for (n = 0; n < fies_dcls_num_ranges; n++)
+    {
+        range = &fies_dcls_ranges[n];
+
+        for (i = range->offset; i < range->offset + range->size; i++)
+            if (d->env[i] != d->baseline[i])
+                d->shadow[i] = d->env[i];
+    }
+
+    FIESER_dcls_copy(d->baseline, d->env, fies_dcls_num_ranges);
+}
+
+/**
+ * Reports a divergence of the contexts.
+ *
+ * @param[in] cpu - the CPU.
+ * @param[in] tb - the TB, after which the contexts diverged.
+ * @param[in] what - the part of the results, which differs.
+ */
+static void FIESER_dcls_report(CPUState *cpu, TranslationBlock *tb,
+                               const char *what)
+{
+    int injected = get_num_injected_faults();
+
+    trace_fies_dcls_divergence(cpu->cpu_index, tb->pc, what);
+
+    if (injected == fies_dcls_injected)
+        return;
+
+    fies_dcls_injected = injected;
+    incr_num_detected_faults();
+
+    qemu_log("FIESER: fault detected by DCLS on CPU %d in the TB at 0x"
+             TARGET_FMT_lx ": the %s differ\n", cpu->cpu_index, tb->pc, what);
+}
+
+/**
+ * Compares the results of the shadow context, which is loaded, with those
+ * of the faulted context.
+ */
+static void FIESER_dcls_compare(CPUState *cpu, TranslationBlock *tb,
+                                FIESDclsCpu *d)
+{
+    if (cpu->exception_index != d->primary_exception)
+        FIESER_dcls_report(cpu, tb, "exceptions");
+    else if (FIESER_dcls_hash_state(d->hash, d->env, d->ranges) != d->primary_hash)
+        FIESER_dcls_report(cpu, tb, "registers or stores");
+    else if (d->io_diverged || d->io_pos != d->io->len)
+        FIESER_dcls_report(cpu, tb, "device accesses");
+}
+
+/**
+ * Releases the locks a context held, when it left its TB through
+ * cpu_loop_exit(), like the sigsetjmp() handler of cpu_exec() does.
+ */
+static void FIESER_dcls_unwind(CPUState *cpu)
+{
+    cpu->can_do_io = 1;
+    tb_lock_reset();
+    if (qemu_mutex_iothread_locked())
+        qemu_mutex_unlock_iothread();
+}
+
+/**
+ * Translates a TB for the shadow context once more, as a faulty TB of the
+ * instruction faults is not fault-free.
+ */
+static TranslationBlock *FIESER_dcls_clean_tb(CPUState *cpu,
+                                              TranslationBlock *tb)
+{
+    TranslationBlock *clean;
+
+    mmap_lock();
+    tb_lock();
+    clean = tb_gen_code(cpu, tb->pc, tb->cs_base, tb->flags, tb->cflags);
+    clean->orig_tb = tb->orig_tb;
+    tb_unlock();
+    mmap_unlock();
+
+    return clean;
+}
+
+/**
+ * Executes a TB in lockstep. The faulted context runs the TB first, its
+ * stores are then undone and the shadow context runs the TB from its own
+ * start state. The hashes of the architectural state and the stores, the
+ * exception and the device accesses of both are compared, before the
+ * results of the faulted context are restored. The shadow context sees the
+ * same memory, including the effects of the RAM faults on the accesses of
+ * the faulted context, so only faults of the CPU make the contexts diverge;
+ * TBs, which the shadow context cannot run to their end like the faulted
+ * one, are not checked.
+ *
+ * @param[in] cpu - the CPU.
+ * @param[in] tb - the TB.
+ * @param[in] exec - executes a TB once.
+ * @param[out] - the TB exit of the faulted context.
+ */
+tcg_target_ulong FIESER_dcls_tb_exec(CPUState *cpu, TranslationBlock *tb,
+                                     FIESDclsExec exec)
+{
+    FIESDclsCpu *d = FIESER_dcls_cpu(cpu);
+    sigjmp_buf outer;
+    int start_exception;
+    uint16_t exit_request, icount;
+
+    if (!d || fies_dcls_active)
+        return exec(cpu, tb);
+
+    /**
+     * the VFP/NEON registers are left to TBs, which access them, unless a
+     * fault injected into them is pending
+     */
+    d->ranges = tb->fies_vfp || d->pinned ? fies_dcls_num_ranges
+                                          : fies_dcls_num_ranges - 1;
+
+    if (d->pinned)
+        FIESER_dcls_advance(d);
+    else
+        FIESER_dcls_copy(d->shadow, d->env, d->ranges);
+
+    memcpy(outer, cpu->jmp_env, sizeof(outer));
+    start_exception = cpu->exception_index;
+
+    g_array_set_size(d->stores, 0);
+    g_array_set_size(d->io, 0);
+    g_array_set_size(d->deltas, 0);
+    g_array_set_size(d->mem, 0);
+    g_byte_array_set_size(d->mem_data, 0);
+    d->io_pos = 0;
+    d->mem_pos = 0;
+    d->io_diverged = false;
+    d->hash = 0;
+    d->ret = 0;
+    d->primary_raised = false;
+    d->shadow_tb = NULL;
+    d->checked = false;
+
+    fies_dcls_current = d;
+    fies_dcls_active = true;
+
+    if (sigsetjmp(cpu->jmp_env, 0) == 0)
+        d->ret = exec(cpu, tb);
+    else
+    {
+        FIESER_dcls_unwind(cpu);
+        d->primary_raised = true;
+    }
+
+    /**
+     * a TB, which was left before it started, has no results
+     */
+    if (d->primary_raised || (d->ret & TB_EXIT_MASK) <= TB_EXIT_IDX1)
+    {
+        d->primary_exception = cpu->exception_index;
+        d->primary_hash = FIESER_dcls_hash_state(d->hash, d->env, d->ranges);
+        d->primary_stores = d->stores->len;
+        icount = cpu->icount_decr.u16.low;
+        FIESER_dcls_copy(d->primary, d->env, d->ranges);
+
+        FIESER_dcls_undo(d, 0, true);
+        FIESER_dcls_copy(d->env, d->shadow, d->ranges);
+        cpu->exception_index = start_exception;
+        d->hash = 0;
+
+        exit_request = atomic_xchg(&cpu->icount_decr.u16.high, 0);
+        fies_dcls_shadow = true;
+
+        if (sigsetjmp(cpu->jmp_env, 0) == 0)
+        {
+            d->shadow_tb = tb->cflags & CF_NOCACHE ? FIESER_dcls_clean_tb(cpu, tb) : tb;
+            d->checked = (exec(cpu, d->shadow_tb) & TB_EXIT_MASK) <= TB_EXIT_IDX1;
+        }
+        else
+        {
+            FIESER_dcls_unwind(cpu);
+            d->checked = d->shadow_tb != NULL;
+        }
+
+        fies_dcls_shadow = false;
+        if (exit_request)
+            atomic_set(&cpu->icount_decr.u16.high, exit_request);
+        cpu->icount_decr.u16.low = icount;
+
+        if (d->checked)
+            FIESER_dcls_compare(cpu, tb, d);
+
+        if (d->shadow_tb && d->shadow_tb != tb
+                && !(d->shadow_tb->cflags & CF_INVALID))
+        {
+            tb_lock();
+            tb_phys_invalidate(d->shadow_tb, -1);
+            tb_remove(d->shadow_tb);
+            tb_unlock();
+        }
+
+        FIESER_dcls_undo(d, d->primary_stores, false);
+        FIESER_dcls_redo(d, d->primary_stores);
+        FIESER_dcls_copy(d->env, d->primary, d->ranges);
+        cpu->exception_index = d->primary_exception;
+    }
+
+    fies_dcls_active = false;
+    fies_dcls_current = NULL;
+    memcpy(cpu->jmp_env, outer, sizeof(outer));
+
+    if (d->checked)
+        d->pinned = false;
+
+    if (d->primary_raised)
+        cpu_loop_exit(cpu);
+
+    return d->ret;
+}
+#else
+void FIESER_dcls_init(void)
+{
+}
+
+tcg_target_ulong FIESER_dcls_tb_exec(CPUState *cpu, TranslationBlock *tb,
+                                     FIESDclsExec exec)
+{
+    return exec(cpu, tb);
+}
+
+void FIESER_dcls_do_store(target_ulong addr, uint64_t val, unsigned size,
+                          void *host)
+{
+}
+
+bool FIESER_dcls_io_begin(uint64_t addr, unsigned size, uint64_t *val,
+                          bool is_write)
+{
+    return false;
+}
+
+void FIESER_dcls_io_end(uint64_t addr, unsigned size, uint64_t val,
+                        bool is_write)
+{
+}
+
+bool FIESER_dcls_do_mem_begin(hwaddr *addr, uint8_t *buf, hwaddr len,
+                              AccessType access_type)
+{
+    return false;
+}
+
+void FIESER_dcls_do_mem_end(hwaddr addr, const uint8_t *buf, hwaddr len)
+{
+}
+
+void FIESER_dcls_inject_begin(CPUState *cpu)
+{
+}
+
+void FIESER_dcls_inject_end(CPUState *cpu)
+{
+}
+#endif
@@ -0,0 +1,101 @@
+/*
+ * fault-injection-dcls.h
+ *
+ *  FIESer by Christian M. Fuchs 2017/2018
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#ifndef FAULT_INJECTION_DCLS_H_
+#define FAULT_INJECTION_DCLS_H_
+
+#include "qemu/osdep.h"
+#include "cpu.h"
+#include "exec/exec-all.h"
+#include "tcg/tcg.h"
+
+#include "fault-injection-config.h"
+#include "fault-injection-enums.h"
+
+/**
+ * Is set while a TB runs in lockstep on the calling thread, i.e. while the
+ * stores and device accesses of the TB are logged.
+ */
+extern __thread bool fies_dcls_active;
+
+/**
+ * Is set while the shadow context runs. The fault controller injects no
+ * faults into the shadow context, its device accesses are replayed and its
+ * memory accesses see the RAM faults of the faulted context.
+ */
+extern __thread bool fies_dcls_shadow;
+
+/**
+ * Executes a TB once, i.e. cpu_tb_exec() without lockstep.
+ */
+typedef tcg_target_ulong (*FIESDclsExec)(CPUState *cpu, TranslationBlock *tb);
+
+/**
+ * see corresponding c-file for documentation
+ */
+void FIESER_dcls_init(void);
+tcg_target_ulong FIESER_dcls_tb_exec(CPUState *cpu, TranslationBlock *tb,
+                                     FIESDclsExec exec);
+void FIESER_dcls_do_store(target_ulong addr, uint64_t val, unsigned size,
+                          void *host);
+bool FIESER_dcls_io_begin(uint64_t addr, unsigned size, uint64_t *val,
+                          bool is_write);
+void FIESER_dcls_io_end(uint64_t addr, unsigned size, uint64_t val,
+                        bool is_write);
+bool FIESER_dcls_do_mem_begin(hwaddr *addr, uint8_t *buf, hwaddr len,
+                              AccessType access_type);
+void FIESER_dcls_do_mem_end(hwaddr addr, const uint8_t *buf, hwaddr len);
+void FIESER_dcls_inject_begin(CPUState *cpu);
+void FIESER_dcls_inject_end(CPUState *cpu);
+
+/**
+ * Logs a store to RAM of a TB running in lockstep, before it is performed.
+ *
+ * @param[in] addr - the virtual address of the store.
+ * @param[in] val - the stored value.
+ * @param[in] size - the size of the store in bytes.
+ * @param[in] host - the host address of the stored bytes.
+ */
+static inline void FIESER_dcls_store(target_ulong addr, uint64_t val,
+                                     unsigned size, void *host)
+{
+    if (unlikely(fies_dcls_active))
+        FIESER_dcls_do_store(addr, val, size, host);
+}
+
+/**
+ * Is called before a memory hook. While a TB runs in lockstep, the access
+ * of the faulted context is logged and the one of the shadow context is
+ * given the effects of the RAM faults on the faulted context.
+ *
+ * @param[out] - true if the hook was replayed and must not be run.
+ */
+static inline bool FIESER_dcls_mem_begin(hwaddr *addr, uint8_t *buf,
+                                         hwaddr len, AccessType access_type)
+{
+    if (unlikely(fies_dcls_active))
+        return FIESER_dcls_do_mem_begin(addr, buf, len, access_type);
+
+    return false;
+}
+
+/**
+ * Is called after a memory hook, which was not replayed.
+ */
+static inline void FIESER_dcls_mem_end(hwaddr addr, const uint8_t *buf,
+                                       hwaddr len)
+{
+    if (unlikely(fies_dcls_active))
+        FIESER_dcls_do_mem_end(addr, buf, len);
+}
+
+#endif /* FAULT_INJECTION_DCLS_H_ */
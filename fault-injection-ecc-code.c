@@ -0,0 +1,170 @@
+/*
+ * fault-injection-ecc-code.c
+ *
+ *  FIESer by Christian M. Fuchs 2017/2018
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+#include "qemu/host-utils.h"
+#include "qemu/bswap.h"
+
+#include "fault-injection-ecc-code.h"
+
+/**
+ * The Hamming positions of the data bits, summed up per byte of a word,
+ * the data bit at each position (plus one, 0 for the check bits) and the
+ * GF(2^8) tables of the Reed-Solomon code.
+ */
+static uint8_t secded_table[FIES_ECC_WORD][256];
+static uint8_t secded_bit[128];
+static uint8_t gf_exp[512];
+static uint8_t gf_log[256];
+static uint8_t rs_table[FIES_ECC_WORD][256];
+static bool fies_ecc_tables;
+
+/**
+ * Computes the tables of both codes once. The data bits take the Hamming
+ * positions 3 to 71, which are no power of two, and the check symbols of
+ * the Reed-Solomon code are the sum of the bytes d_i and of d_i * a^i in
+ * GF(2^8) with the polynomial 0x11d.
+ */
+void FIESER_ecc_init_tables(void)
+{
+    int i, v, pos = 2, x = 1;
+
+    if (fies_ecc_tables)
+        return;
+
+    for (i = 0; i < 64; i++)
+    {
+        do
+        {
+            pos++;
+        } while (!(pos & (pos - 1)));
+
+        secded_bit[pos] = i + 1;
+
+        for (v = 0; v < 256; v++)
+        {
+            if (v & (1 << (i % 8)))
+                secded_table[i / 8][v] ^= pos;
+        }
+    }
+
+    for (i = 0; i < 255; i++)
+    {
+        gf_exp[i] = x;
+        gf_log[x] = i;
+        x <<= 1;
+        if (x & 0x100)
+            x ^= 0x11d;
+    }
+
+    for (i = 255; i < 512; i++)
+        gf_exp[i] = gf_exp[i - 255];
+
+    for (i = 0; i < FIES_ECC_WORD; i++)
+    {
+        for (v = 1; v < 256; v++)
+            rs_table[i][v] = gf_exp[gf_log[v] + i];
+    }
+
+    fies_ecc_tables = true;
+}
+
+/**
+ * Computes the check bits of a word: the 7 Hamming check bits and the
+ * overall parity in bit 7 for SECDED, the two check bytes for CHIPKILL.
+ *
+ * @param[in] code - the code of the region.
+ * @param[in] word - the word in guest memory order.
+ * @param[out] - the check bits.
+ */
+uint16_t FIESER_ecc_encode(FIESEccCode code, const uint8_t *word)
+{
+    uint8_t c = 0, p0 = 0, p1 = 0;
+    int i;
+
+    if (code == FIES_ECC_SECDED)
+    {
+        for (i = 0; i < FIES_ECC_WORD; i++)
+            c ^= secded_table[i][word[i]];
+
+        return c | ((ctpop64(ldq_le_p(word)) ^ ctpop8(c)) & 1) << 7;
+    }
+
+    for (i = 0; i < FIES_ECC_WORD; i++)
+    {
+        p0 ^= word[i];
+        p1 ^= rs_table[i][word[i]];
+    }
+
+    return p0 | p1 << 8;
+}
+
+/**
+ * Checks a word against its stored check bits and corrects it, if the
+ * error is correctable: a single flipped bit for SECDED, the bits of a
+ * single byte for CHIPKILL. Errors in the check bits are corrected
+ * without changing the word. Errors beyond the capabilities of the
+ * code may be miscorrected, as by the hardware.
+ *
+ * @param[in] code - the code of the region.
+ * @param[in,out] word - the stored word, which is corrected.
+ * @param[in] check - the stored check bits.
+ * @param[out] syndrome - the syndrome of the word.
+ * @param[out] - if the word is correct, corrected or uncorrectable.
+ */
+FIESEccResult FIESER_ecc_decode(FIESEccCode code, uint8_t *word,
+                                uint16_t check, uint32_t *syndrome)
+{
+    uint16_t diff = FIESER_ecc_encode(code, word) ^ check;
+    uint8_t s, s0, s1;
+    int overall, j;
+
+    if (code == FIES_ECC_SECDED)
+    {
+        /**
+         * the parity of the whole received codeword
+         */
+        s = diff & 0x7f;
+        overall = ((diff >> 7) ^ ctpop8(s)) & 1;
+        *syndrome = s | overall << 7;
+
+        if (!overall)
+            return s ? FIES_ECC_UNCORRECTABLE : FIES_ECC_OK;
+
+        if (!(s & (s - 1)))
+            return FIES_ECC_CORRECTED;
+
+        if (!secded_bit[s])
+            return FIES_ECC_UNCORRECTABLE;
+
+        j = secded_bit[s] - 1;
+        word[j / 8] ^= 1 << (j % 8);
+        return FIES_ECC_CORRECTED;
+    }
+
+    s0 = diff;
+    s1 = diff >> 8;
+    *syndrome = diff;
+
+    if (!s0 && !s1)
+        return FIES_ECC_OK;
+
+    if (!s0 || !s1)
+        return FIES_ECC_CORRECTED;
+
+    j = (gf_log[s1] - gf_log[s0] + 255) % 255;
+    if (j >= FIES_ECC_WORD)
+        return FIES_ECC_UNCORRECTABLE;
+
+    word[j] ^= s0;
+    return FIES_ECC_CORRECTED;
+}
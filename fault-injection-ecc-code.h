@@ -0,0 +1,47 @@
+/*
+ * fault-injection-ecc-code.h
+ *
+ *  FIESer by Christian M. Fuchs 2017/2018
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#ifndef FAULT_INJECTION_ECC_CODE_H_
+#define FAULT_INJECTION_ECC_CODE_H_
+
+/**
+ * The protected words are 64 bits wide.
+ */
+#define FIES_ECC_WORD 8
+
+/**
+ * The codes of an ECC-protected RAM region. Both protect 64-bit words:
+ * SECDED with an (72,64) extended Hamming code, which corrects single-bit
+ * and detects double-bit errors, and CHIPKILL with two check bytes of a
+ * Reed-Solomon code over the bytes of a word, which corrects the errors
+ * of a single byte (a x8 memory chip).
+ */
+typedef enum {
+    FIES_ECC_SECDED,
+    FIES_ECC_CHIPKILL,
+} FIESEccCode;
+
+typedef enum {
+    FIES_ECC_OK,
+    FIES_ECC_CORRECTED,
+    FIES_ECC_UNCORRECTABLE,
+} FIESEccResult;
+
+/**
+ * see corresponding c-file for documentation
+ */
+void FIESER_ecc_init_tables(void);
+uint16_t FIESER_ecc_encode(FIESEccCode code, const uint8_t *word);
+FIESEccResult FIESER_ecc_decode(FIESEccCode code, uint8_t *word,
+                                uint16_t check, uint32_t *syndrome);
+
+#endif /* FAULT_INJECTION_ECC_CODE_H_ */
@@ -0,0 +1,723 @@
+/*
+ * fault-injection-ecc.c
+ *
+ *  FIESer by Christian M. Fuchs 2017/2018
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+#include "qemu/log.h"
+#include "qemu/main-loop.h"
+#include "qemu/rcu.h"
+#include "cpu.h"
+#include "exec/exec-all.h"
+
+#include "fault-injection-ecc.h"
+#include "fault-injection-irq.h"
+#include "fault-injection-library.h"
+#include "trace-root.h"
+
+bool fies_ecc_tracking;
+
+#if !defined(CONFIG_USER_ONLY)
+#include "exec/memory.h"
+#include "exec/address-spaces.h"
+#include "qemu/bitmap.h"
+#include "qemu/error-report.h"
+#include "qemu/main-loop.h"
+#include "qemu/timer.h"
+#include "sysemu/sysemu.h"
+
+#define FIES_ECC_WORDS_PER_PAGE (TARGET_PAGE_SIZE / FIES_ECC_WORD)
+
+/**
+ * The syndrome registers of a region, modelled after the fault status and
+ * address registers of hw/misc/eccmemctl.c. STATUS is write-one-to-clear,
+ * the counters are cleared by writing 0.
+ */
+#define FIES_ECC_CTRL           0x00
+#define FIES_ECC_STATUS         0x04
+#define FIES_ECC_ADDR_LO        0x08
+#define FIES_ECC_ADDR_HI        0x0c
+#define FIES_ECC_SYNDROME       0x10
+#define FIES_ECC_CE_COUNT       0x14
+#define FIES_ECC_UE_COUNT       0x18
+#define FIES_ECC_CODE           0x1c
+#define FIES_ECC_REGS_SIZE      0x20
+
+#define FIES_ECC_CTRL_CE_IRQ    (1 << 0)
+#define FIES_ECC_CTRL_UE_IRQ    (1 << 1)
+#define FIES_ECC_CTRL_CORRECT   (1 << 2)
+#define FIES_ECC_CTRL_MASK      0x7
+
+#define FIES_ECC_STATUS_CE      (1 << 0)
+#define FIES_ECC_STATUS_UE      (1 << 1)
+#define FIES_ECC_STATUS_OVERFLOW (1 << 2)
+
+/**
+ * An ECC-protected region and the state of its syndrome registers. The
+ * scrubber of the region only visits the pages, which are set in pending,
+ * i.e. into which a fault was injected since the last scrub pass. Bit n of
+ * pending stands for the n-th page from first_page on.
+ */
+typedef struct {
+    struct rcu_head rcu;
+    FIESEccConfig config;
+    MemoryRegion iomem;
+    bool mapped;
+    qemu_irq irq;
+    uint32_t ctrl;
+    uint32_t status;
+    uint32_t syndrome;
+    uint32_t ce_count;
+    uint32_t ue_count;
+    uint64_t error_addr;
+    QEMUTimer *scrub_timer;
+    bool scrub_due;
+    unsigned long *pending;
+    hwaddr first_page;
+    long num_pages;
+} FIESEccRegion;
+
+/**
+ * The check bits of the protected words of a page. They are only computed
+ * for pages, into which a fault is injected, from the content of the page
+ * right before the first injection.
+ */
+typedef struct {
+    hwaddr addr;
+    uint16_t check[];
+} FIESEccPage;
+
+static GArray *fies_ecc_configs;
+static GPtrArray *fies_ecc_regions;
+static GHashTable *fies_ecc_pages;
+static bool fies_ecc_scrub_queued;
+
+/**
+ * Returns the region, which protects a word.
+ *
+ * @param[in] addr - the address of the word.
+ * @param[out] - the region or NULL, if the word is not protected.
+ */
+static FIESEccRegion *FIESER_ecc_region(hwaddr addr)
+{
+    FIESEccRegion *r;
+    int i;
+
+    for (i = 0; i < fies_ecc_regions->len; i++)
+    {
+        r = g_ptr_array_index(fies_ecc_regions, i);
+
+        if (addr >= r->config.address && addr - r->config.address < r->config.size)
+            return r;
+    }
+
+    return NULL;
+}
+
+/**
+ * Checks if a range overlaps a protected region.
+ *
+ * @param[in] addr - the first address of the range.
+ * @param[in] len - the length of the range in bytes.
+ * @param[out] - true if a word of the range is protected.
+ */
+static bool FIESER_ecc_overlaps(hwaddr addr, hwaddr len)
+{
+    FIESEccRegion *r;
+    int i;
+
+    for (i = 0; i < fies_ecc_regions->len; i++)
+    {
+        r = g_ptr_array_index(fies_ecc_regions, i);
+
+        if (addr < r->config.address + r->config.size
+                && r->config.address < addr + len)
+            return true;
+    }
+
+    return false;
+}
+
+static void FIESER_ecc_update_irq(FIESEccRegion *r)
+{
+    if (r->irq)
+        qemu_set_irq(r->irq,
+                     ((r->status & FIES_ECC_STATUS_CE) && (r->ctrl & FIES_ECC_CTRL_CE_IRQ))
+                     || ((r->status & FIES_ECC_STATUS_UE) && (r->ctrl & FIES_ECC_CTRL_UE_IRQ)));
+}
+
+/**
+ * Latches an error in the syndrome registers of its region and raises the
+ * interrupt, if it is enabled. May be called from the CPU without the BQL.
+ *
+ * @param[in] r - the region.
+ * @param[in] addr - the address of the word.
+ * @param[in] syndrome - the syndrome of the word.
+ * @param[in] uncorrectable - if the error is uncorrectable.
+ */
+static void FIESER_ecc_report(FIESEccRegion *r, hwaddr addr, uint32_t syndrome,
+                              bool uncorrectable)
+{
+    uint32_t bit = uncorrectable ? FIES_ECC_STATUS_UE : FIES_ECC_STATUS_CE;
+    bool locked = qemu_mutex_iothread_locked();
+
+    if (!locked)
+        qemu_mutex_lock_iothread();
+
+    if (r->status & bit)
+        r->status |= FIES_ECC_STATUS_OVERFLOW;
+
+    r->status |= bit;
+    r->error_addr = addr;
+    r->syndrome = syndrome;
+
+    if (uncorrectable)
+        r->ue_count++;
+    else
+        r->ce_count++;
+
+    trace_fies_ecc_error(addr, syndrome, uncorrectable);
+    FIESER_ecc_update_irq(r);
+
+    if (!locked)
+        qemu_mutex_unlock_iothread();
+}
+
+static uint64_t FIESER_ecc_reg_read(void *opaque, hwaddr offset, unsigned size)
+{
+    FIESEccRegion *r = opaque;
+
+    switch (offset)
+    {
+    case FIES_ECC_CTRL:
+        return r->ctrl;
+    case FIES_ECC_STATUS:
+        return r->status;
+    case FIES_ECC_ADDR_LO:
+        return (uint32_t) r->error_addr;
+    case FIES_ECC_ADDR_HI:
+        return r->error_addr >> 32;
+    case FIES_ECC_SYNDROME:
+        return r->syndrome;
+    case FIES_ECC_CE_COUNT:
+        return r->ce_count;
+    case FIES_ECC_UE_COUNT:
+        return r->ue_count;
+    case FIES_ECC_CODE:
+        return r->config.code;
+    default:
+        qemu_log_mask(LOG_GUEST_ERROR, "FIESER: ECC register read at 0x%" HWADDR_PRIx "\n",
+                      offset);
+        return 0;
+    }
+}
+
+static void FIESER_ecc_reg_write(void *opaque, hwaddr offset, uint64_t value,
+                                 unsigned size)
+{
+    FIESEccRegion *r = opaque;
+
+    switch (offset)
+    {
+    case FIES_ECC_CTRL:
+        r->ctrl = value & FIES_ECC_CTRL_MASK;
+        break;
+    case FIES_ECC_STATUS:
+        r->status &= ~value;
+        break;
+    case FIES_ECC_CE_COUNT:
+        r->ce_count = value;
+        break;
+    case FIES_ECC_UE_COUNT:
+        r->ue_count = value;
+        break;
+    default:
+        qemu_log_mask(LOG_GUEST_ERROR, "FIESER: ECC register write at 0x%" HWADDR_PRIx "\n",
+                      offset);
+        return;
+    }
+
+    FIESER_ecc_update_irq(r);
+}
+
+static const MemoryRegionOps fies_ecc_ops = {
+    .read = FIESER_ecc_reg_read,
+    .write = FIESER_ecc_reg_write,
+    .endianness = DEVICE_NATIVE_ENDIAN,
+    .valid = {
+        .min_access_size = 4,
+        .max_access_size = 4,
+    },
+};
+
+/**
+ * Computes the check bits of a page from its current content and routes
+ * the accesses to the page through the memory hooks (see
+ * FIESER_tlb_filtered).
+ *
+ * @param[in] cpu - the CPU, whose MMU translates the address.
+ * @param[in] page - the address of the page.
+ */
+static void FIESER_ecc_track(CPUState *cpu, hwaddr page)
+{
+    FIESEccPage *p;
+    FIESEccRegion *r;
+    CPUState *other;
+    uint8_t *content = g_malloc(TARGET_PAGE_SIZE);
+    int w;
+
+    if (cpu_memory_rw_debug(cpu, page, content, TARGET_PAGE_SIZE, 0))
+    {
+        g_free(content);
+        return;
+    }
+
+    p = g_malloc0(sizeof(FIESEccPage) + FIES_ECC_WORDS_PER_PAGE * sizeof(uint16_t));
+    p->addr = page;
+
+    for (w = 0; w < FIES_ECC_WORDS_PER_PAGE; w++)
+    {
+        r = FIESER_ecc_region(page + w * FIES_ECC_WORD);
+        if (r)
+            p->check[w] = FIESER_ecc_encode(r->config.code, content + w * FIES_ECC_WORD);
+    }
+
+    g_free(content);
+    g_hash_table_insert(fies_ecc_pages, &p->addr, p);
+    fies_ecc_tracking = true;
+    trace_fies_ecc_page(page);
+
+    CPU_FOREACH(other)
+    {
+        tlb_flush_page(other, page);
+    }
+}
+
+/**
+ * Computes the check bits of the pages of a range, which is about to be
+ * injected, unless they hold check bits already. Called by the injector
+ * before it modifies the memory cells of a fault, so that the fault hits
+ * the stored codeword, while the check bits stay the ones of the correct
+ * content.
+ *
+ * @param[in] cpu - the CPU, whose MMU translates the address.
+ * @param[in] addr - the first injected address.
+ * @param[in] len - the number of injected bytes.
+ */
+void FIESER_ecc_prepare(CPUState *cpu, hwaddr addr, hwaddr len)
+{
+    FIESEccRegion *r;
+    hwaddr page;
+    int i;
+
+    if (!fies_ecc_regions || !fies_ecc_regions->len || !len)
+        return;
+
+    for (page = addr & TARGET_PAGE_MASK; page < addr + len; page += TARGET_PAGE_SIZE)
+    {
+        if (!g_hash_table_lookup(fies_ecc_pages, &page)
+                && FIESER_ecc_overlaps(page, TARGET_PAGE_SIZE))
+            FIESER_ecc_track(cpu, page);
+
+        for (i = 0; i < fies_ecc_regions->len; i++)
+        {
+            r = g_ptr_array_index(fies_ecc_regions, i);
+
+            if (r->pending && page >= r->first_page
+                    && (page - r->first_page) / TARGET_PAGE_SIZE < r->num_pages)
+                set_bit_atomic((page - r->first_page) / TARGET_PAGE_SIZE, r->pending);
+        }
+    }
+}
+
+/**
+ * Checks if a page holds check bits.
+ *
+ * @param[in] addr - an address within the page.
+ * @param[out] - true if the accesses to the page have to pass the ECC.
+ */
+bool FIESER_ecc_page_tracked(hwaddr addr)
+{
+    hwaddr page = addr & TARGET_PAGE_MASK;
+
+    return fies_ecc_tracking && g_hash_table_lookup(fies_ecc_pages, &page);
+}
+
+/**
+ * Checks a protected word against its check bits like a memory controller:
+ * a correctable error is corrected in memory (unless the correction is
+ * disabled in CTRL), all errors are latched in the syndrome registers.
+ *
+ * @param[in] cpu - the CPU, whose MMU translates the address.
+ * @param[in] r - the region of the word.
+ * @param[in] p - the page of the word.
+ * @param[in] w - the address of the word.
+ * @param[out] stored - the word in memory after the correction.
+ * @param[out] - the result of the check or -1, if the word is not mapped.
+ */
+static int FIESER_ecc_check_word(CPUState *cpu, FIESEccRegion *r, FIESEccPage *p,
+                                 hwaddr w, uint8_t *stored)
+{
+    FIESEccResult result;
+    uint8_t word[FIES_ECC_WORD];
+    uint32_t syndrome;
+    int idx = (w & ~TARGET_PAGE_MASK) / FIES_ECC_WORD;
+
+    if (cpu_memory_rw_debug(cpu, w, stored, FIES_ECC_WORD, 0))
+        return -1;
+
+    memcpy(word, stored, FIES_ECC_WORD);
+    result = FIESER_ecc_decode(r->config.code, word, p->check[idx], &syndrome);
+
+    if (result == FIES_ECC_CORRECTED && (r->ctrl & FIES_ECC_CTRL_CORRECT))
+    {
+        memcpy(stored, word, FIES_ECC_WORD);
+        cpu_memory_rw_debug(cpu, w, stored, FIES_ECC_WORD, 1);
+        p->check[idx] = FIESER_ecc_encode(r->config.code, stored);
+    }
+
+    if (result != FIES_ECC_OK)
+        FIESER_ecc_report(r, w, syndrome, result == FIES_ECC_UNCORRECTABLE);
+
+    return result;
+}
+
+/**
+ * Passes an access to a page with check bits through the ECC. Each word of
+ * the access is checked like by a memory controller: correctable errors are
+ * corrected in memory and in the loaded value (unless the correction is
+ * disabled in CTRL), all errors are latched in the syndrome registers. A
+ * store recomputes the check bits of its words from the merged content, as
+ * by a read-modify-write.
+ *
+ * @param[in] env - Reference to the information of the CPU state or NULL, if the
+ *                  access is not performed by a CPU (e.g. DMA).
+ * @param[in] addr - the first accessed address.
+ * @param[in,out] buf - the accessed bytes in guest memory order.
+ * @param[in] len - the length of the access in bytes.
+ * @param[in] access_type - if the access-operation is a write, read or execute.
+ */
+void FIESER_ecc_access(CPUArchState *env, hwaddr addr, uint8_t *buf,
+                       hwaddr len, AccessType access_type)
+{
+    CPUState *cpu = env ? ENV_GET_CPU(env) : (current_cpu ? current_cpu : first_cpu);
+    FIESEccPage *p = NULL;
+    FIESEccRegion *r;
+    uint8_t stored[FIES_ECC_WORD];
+    hwaddr w, page = -1, lo, hi;
+    int idx, result;
+
+    if (!cpu)
+        return;
+
+    for (w = addr & ~(hwaddr) (FIES_ECC_WORD - 1); w < addr + len; w += FIES_ECC_WORD)
+    {
+        if ((w & TARGET_PAGE_MASK) != page)
+        {
+            page = w & TARGET_PAGE_MASK;
+            p = g_hash_table_lookup(fies_ecc_pages, &page);
+        }
+
+        if (!p || !(r = FIESER_ecc_region(w)))
+            continue;
+
+        idx = (w & ~TARGET_PAGE_MASK) / FIES_ECC_WORD;
+        lo = MAX(w, addr);
+        hi = MIN(w + FIES_ECC_WORD, addr + len);
+
+        result = FIESER_ecc_check_word(cpu, r, p, w, stored);
+        if (result < 0)
+            continue;
+
+        if (result == FIES_ECC_CORRECTED && (r->ctrl & FIES_ECC_CTRL_CORRECT)
+                && access_type != write_access_type)
+            memcpy(buf + (lo - addr), stored + (lo - w), hi - lo);
+
+        if (access_type == write_access_type)
+        {
+            memcpy(stored + (lo - w), buf + (lo - addr), hi - lo);
+            p->check[idx] = FIESER_ecc_encode(r->config.code, stored);
+        }
+    }
+}
+
+/**
+ * Scrubs the pending pages of a region: every protected word of a page is
+ * checked and corrected as by a read of the memory controller, then the
+ * page is cleared in the bitmap. Pages without a pending fault are not
+ * visited.
+ *
+ * @param[in] cpu - the CPU, whose MMU translates the addresses.
+ * @param[in] r - the region.
+ */
+static void FIESER_ecc_scrub_region(CPUState *cpu, FIESEccRegion *r)
+{
+    FIESEccPage *p;
+    uint8_t stored[FIES_ECC_WORD];
+    hwaddr page, w, lo, hi;
+    unsigned long n;
+    int corrected, uncorrectable, result;
+
+    for (n = find_first_bit(r->pending, r->num_pages); n < r->num_pages;
+            n = find_next_bit(r->pending, r->num_pages, n + 1))
+    {
+        clear_bit(n, r->pending);
+
+        page = r->first_page + n * TARGET_PAGE_SIZE;
+        p = g_hash_table_lookup(fies_ecc_pages, &page);
+        if (!p)
+            continue;
+
+        lo = MAX(page, r->config.address);
+        hi = MIN(page + TARGET_PAGE_SIZE, r->config.address + r->config.size);
+        corrected = uncorrectable = 0;
+
+        for (w = lo; w < hi; w += FIES_ECC_WORD)
+        {
+            result = FIESER_ecc_check_word(cpu, r, p, w, stored);
+
+            if (result == FIES_ECC_CORRECTED)
+                corrected++;
+            else if (result == FIES_ECC_UNCORRECTABLE)
+                uncorrectable++;
+        }
+
+        trace_fies_ecc_scrub(page, corrected, uncorrectable);
+    }
+}
+
+/**
+ * Runs the due scrub passes of all regions. Runs as safe work, while all
+ * CPUs are stopped, so the check bits are not updated by an access
+ * meanwhile, and with the BQL held, so the regions are not rebuilt.
+ *
+ * @param[in] cpu - the CPU executing the work.
+ * @param[in] data - unused.
+ */
+static void FIESER_ecc_scrub_work(CPUState *cpu, run_on_cpu_data data)
+{
+    FIESEccRegion *r;
+    int i;
+
+    qemu_mutex_lock_iothread();
+    atomic_set(&fies_ecc_scrub_queued, false);
+
+    for (i = 0; fies_ecc_regions && i < fies_ecc_regions->len; i++)
+    {
+        r = g_ptr_array_index(fies_ecc_regions, i);
+
+        if (!atomic_xchg(&r->scrub_due, false))
+            continue;
+
+        FIESER_ecc_scrub_region(cpu, r);
+    }
+
+    qemu_mutex_unlock_iothread();
+}
+
+/**
+ * Starts a scrub pass of a region every <scrub> of virtual time. The pass
+ * is only queued, if a page of the region is pending, so an idle scrubber
+ * costs one timer expiry per interval.
+ *
+ * @param[in] opaque - the region.
+ */
+static void FIESER_ecc_scrub_timer(void *opaque)
+{
+    FIESEccRegion *r = opaque;
+
+    timer_mod(r->scrub_timer,
+              qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL) + r->config.scrub);
+
+    if (!first_cpu || find_first_bit(r->pending, r->num_pages) >= r->num_pages)
+        return;
+
+    atomic_set(&r->scrub_due, true);
+
+    if (!atomic_xchg(&fies_ecc_scrub_queued, true))
+        async_safe_run_on_cpu(first_cpu, FIESER_ecc_scrub_work, RUN_ON_CPU_NULL);
+}
+
+static void FIESER_ecc_free(FIESEccRegion *r)
+{
+    g_free(r->pending);
+    g_free(r);
+}
+
+/**
+ * Unmaps the syndrome registers of a region and lowers its interrupt.
+ * The region is freed, once no flat view refers to its registers anymore.
+ */
+static void FIESER_ecc_remove(FIESEccRegion *r)
+{
+    if (r->mapped)
+    {
+        memory_region_del_subregion(get_system_memory(), &r->iomem);
+        object_unparent(OBJECT(&r->iomem));
+    }
+
+    if (r->irq)
+        qemu_set_irq(r->irq, 0);
+
+    if (r->scrub_timer)
+    {
+        timer_del(r->scrub_timer);
+        timer_free(r->scrub_timer);
+    }
+
+    call_rcu(r, FIESER_ecc_free, rcu);
+}
+
+/**
+ * Clears the regions of the fault library, before a new one is parsed.
+ */
+void FIESER_ecc_reset(void)
+{
+    if (fies_ecc_configs)
+        g_array_set_size(fies_ecc_configs, 0);
+}
+
+/**
+ * Adds a region, which is defined by an <ecc> element of the fault library.
+ * The region is set up by the next FIESER_ecc_build().
+ *
+ * @param[in] config - the region.
+ */
+void FIESER_ecc_add_region(const FIESEccConfig *config)
+{
+    if (!fies_ecc_configs)
+        fies_ecc_configs = g_array_new(false, true, sizeof(FIESEccConfig));
+
+    g_array_append_vals(fies_ecc_configs, config, 1);
+}
+
+/**
+ * Sets up the regions of the fault library: drops the check bits of all
+ * pages, maps the syndrome registers, connects the interrupts and starts
+ * the scrubbers. Has to be called with the BQL held, whenever the fault
+ * list is (re)loaded. The regions are refused, if several CPUs run in
+ * parallel (MTTCG).
+ */
+void FIESER_ecc_build(void)
+{
+    FIESEccConfig *config;
+    FIESEccRegion *r;
+    CPUState *cpu;
+    bool was_tracking = fies_ecc_tracking;
+    int i;
+
+    FIESER_ecc_init_tables();
+
+    if (!fies_ecc_regions)
+    {
+        fies_ecc_regions = g_ptr_array_new();
+        fies_ecc_pages = g_hash_table_new_full(g_int64_hash, g_int64_equal,
+                                               NULL, g_free);
+    }
+
+    fies_ecc_tracking = false;
+    g_hash_table_remove_all(fies_ecc_pages);
+
+    for (i = 0; i < fies_ecc_regions->len; i++)
+        FIESER_ecc_remove(g_ptr_array_index(fies_ecc_regions, i));
+
+    g_ptr_array_set_size(fies_ecc_regions, 0);
+
+    /**
+     * the pages are added to the page table by the CPU, which injects a
+     * fault, and looked up by all CPUs without a lock
+     */
+    if (fies_ecc_configs && fies_ecc_configs->len > 0
+            && smp_cpus > 1 && qemu_tcg_mttcg_enabled())
+    {
+        error_report("<ecc> with %d CPUs requires -accel tcg,thread=single, "
+                     "the ECC regions are ignored", smp_cpus);
+        g_array_set_size(fies_ecc_configs, 0);
+    }
+
+    for (i = 0; fies_ecc_configs && i < fies_ecc_configs->len; i++)
+    {
+        config = &g_array_index(fies_ecc_configs, FIESEccConfig, i);
+
+        r = g_new0(FIESEccRegion, 1);
+        r->config = *config;
+        r->ctrl = FIES_ECC_CTRL_CE_IRQ | FIES_ECC_CTRL_UE_IRQ | FIES_ECC_CTRL_CORRECT;
+
+        if (config->line_defined)
+        {
+            r->irq = FIESER_irq_input(config->device_defined ? config->device : NULL,
+                                      config->line);
+            if (!r->irq)
+                qemu_log("FIESER: ECC region 0x%" HWADDR_PRIx ": no input line %d of device %s\n",
+                         config->address, config->line,
+                         config->device_defined ? config->device : "NVIC");
+        }
+
+        if (config->registers_defined)
+        {
+            memory_region_init_io(&r->iomem, NULL, &fies_ecc_ops, r, "fies-ecc",
+                                  FIES_ECC_REGS_SIZE);
+            memory_region_add_subregion_overlap(get_system_memory(), config->registers,
+                                                &r->iomem, 1);
+            r->mapped = true;
+        }
+
+        if (config->scrub > 0)
+        {
+            r->first_page = config->address & TARGET_PAGE_MASK;
+            r->num_pages = ((config->address + config->size - 1) & TARGET_PAGE_MASK)
+                    / TARGET_PAGE_SIZE - r->first_page / TARGET_PAGE_SIZE + 1;
+            r->pending = bitmap_new(r->num_pages);
+            r->scrub_timer = timer_new_ns(QEMU_CLOCK_VIRTUAL, FIESER_ecc_scrub_timer, r);
+            timer_mod(r->scrub_timer,
+                      qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL) + config->scrub);
+        }
+
+        g_ptr_array_add(fies_ecc_regions, r);
+    }
+
+    /**
+     * the pages, which held check bits, are not routed to the hooks anymore
+     */
+    if (was_tracking)
+    {
+        CPU_FOREACH(cpu)
+        {
+            tlb_flush(cpu);
+        }
+    }
+}
+#else
+void FIESER_ecc_reset(void)
+{
+}
+
+void FIESER_ecc_add_region(const FIESEccConfig *config)
+{
+}
+
+void FIESER_ecc_build(void)
+{
+}
+
+void FIESER_ecc_prepare(CPUState *cpu, hwaddr addr, hwaddr len)
+{
+}
+
+bool FIESER_ecc_page_tracked(hwaddr addr)
+{
+    return false;
+}
+
+void FIESER_ecc_access(CPUArchState *env, hwaddr addr, uint8_t *buf,
+                       hwaddr len, AccessType access_type)
+{
+}
+#endif
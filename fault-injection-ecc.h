@@ -0,0 +1,59 @@
+/*
+ * fault-injection-ecc.h
+ *
+ *  FIESer by Christian M. Fuchs 2017/2018
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#ifndef FAULT_INJECTION_ECC_H_
+#define FAULT_INJECTION_ECC_H_
+
+#include "qemu/osdep.h"
+#include "cpu.h"
+
+#include "fault-injection-infrastructure.h"
+#include "fault-injection-ecc-code.h"
+
+/**
+ * An ECC-protected RAM region, as defined by an <ecc> element of the
+ * fault library. The syndrome registers are mapped at registers, if
+ * registers_defined is set, and raise the input line of device, if
+ * line_defined is set. A scrubber corrects the pages with injected faults
+ * every scrub ns, if scrub is set.
+ */
+typedef struct {
+    hwaddr address;
+    hwaddr size;
+    FIESEccCode code;
+    hwaddr registers;
+    int registers_defined;
+    char device[128];
+    int device_defined;
+    int line;
+    int line_defined;
+    int64_t scrub;
+} FIESEccConfig;
+
+/**
+ * Is set while a page holds check bits, i.e. once a fault was injected
+ * into an ECC-protected region.
+ */
+extern bool fies_ecc_tracking;
+
+/**
+ * see corresponding c-file for documentation
+ */
+void FIESER_ecc_reset(void);
+void FIESER_ecc_add_region(const FIESEccConfig *config);
+void FIESER_ecc_build(void);
+void FIESER_ecc_prepare(CPUState *cpu, hwaddr addr, hwaddr len);
+bool FIESER_ecc_page_tracked(hwaddr addr);
+void FIESER_ecc_access(CPUArchState *env, hwaddr addr, uint8_t *buf,
+                       hwaddr len, AccessType access_type);
+
+#endif /* FAULT_INJECTION_ECC_H_ */
@@ -21,7 +21,11 @@ enum FaultComponent{
     FI_COMP_NONE = 0,
     FI_COMP_CPU,
     FI_COMP_RAM,
-    FI_COMP_REGISTER
+    FI_COMP_REGISTER,
+    FI_COMP_NVIC,
+    FI_COMP_PERIPHERAL,
+    FI_COMP_IRQ,
+    FI_COMP_TIMER
 };
 
 enum FaultTarget{
@@ -36,7 +40,12 @@ enum FaultTarget{
     FI_TAGT_TRACE_MEMORY,
     FI_TAGT_TRACE_REGISTERS,
     FI_TAGT_TRACE_PC,
-    FI_TAGT_TRACE_CPSR
+    FI_TAGT_TRACE_CPSR,
+    FI_TAGT_NVIC_PENDING,
+    FI_TAGT_NVIC_ENABLE,
+    FI_TAGT_NVIC_PRIORITY,
+    FI_TAGT_IRQ_LINE,
+    FI_TAGT_TIMER_COUNTER
 };
 
 
@@ -50,10 +59,49 @@ enum FaultMode{
     FI_MODE_CPSR_VF,
     FI_MODE_CPSR_ZF,
     FI_MODE_CPSR_NF,
-    FI_MODE_CPSR_QF
+    FI_MODE_CPSR_QF,
+    FI_MODE_CPSR_GE,
+    FI_MODE_CPSR_IT,
+    FI_MODE_CPSR_J,
+    FI_MODE_CPSR_E,
+    FI_MODE_CPSR_A,
+    FI_MODE_CPSR_I,
+    FI_MODE_CPSR_F,
+    FI_MODE_CPSR_T,
+    FI_MODE_CPSR_M,
+    FI_MODE_XPSR_IPSR,
+    FI_MODE_DROPPED_WRITE,
+    FI_MODE_IRQ_DROPPED,
+    FI_MODE_IRQ_DELAYED,
+    FI_MODE_IRQ_SPURIOUS,
+    FI_MODE_TIMER_TICK_SKIP,
+    FI_MODE_TIMER_DRIFT,
+    FI_MODE_TIMER_STUCK
 };
 
 
+/**
+ * The kinds of coupling faults (CFxx), in which an operation on or the
+ * state of an aggressor cell affects a victim cell.
+ */
+enum CouplingFaultKind{
+    FI_CF_NONE = 0,
+    FI_CF_STATE,
+    FI_CF_TRANSITION,
+    FI_CF_WRITE_DESTRUCTIVE,
+    FI_CF_READ_DESTRUCTIVE,
+    FI_CF_INCORRECT_READ,
+    FI_CF_DECEPTIVE_READ,
+    FI_CF_DISTURB
+};
+
+/**
+ * Aggressor operation of a disturb coupling fault, which reads the
+ * aggressor cell (otherwise it is the value written to the aggressor).
+ */
+#define FI_CF_OP_READ -1
+
+
 enum FaultTrigger{
     FI_TRGR_NONE = 0,
     FI_TRGR_PC,
@@ -87,12 +135,35 @@ typedef enum {
     FI_INSTRUCTION_VALUE_ARM,
     FI_INSTRUCTION_VALUE_THUMB32,
     FI_INSTRUCTION_VALUE_THUMB16,
+    FI_INSTRUCTION_VALUE_A64,
     FI_PC_ARM,
     FI_PC_THUMB32,
     FI_PC_THUMB16,
-    FI_TIME
+    FI_PC_A64,
+    FI_TIME,
+    FI_INJECTION_MODE_MAX
 } InjectionMode;
 
+/**
+ * The declaration of the FIESCallSite, which specifies
+ * the QEMU function FIESER_hook is called from. It is
+ * only used for accounting the overhead of the hooks.
+ */
+typedef enum {
+    FI_SITE_SOFTMMU,
+    FI_SITE_MEMORY_LDST,
+    FI_SITE_ADDRESS_SPACE_READ,
+    FI_SITE_FLATVIEW_RW,
+    FI_SITE_OP_HELPER,
+    FI_SITE_TRANSLATE,
+    FI_SITE_USER_LDST,
+    FI_SITE_USER_EXEC,
+    FI_SITE_SWITCH_MODE,
+    FI_SITE_CPREG,
+    FI_SITE_V7M,
+    FI_SITE_MAX
+} FIESCallSite;
+
 /**
  * The declaration of the AccessType, which specifies
  * a read-, write- or execution-access
@@ -21,7 +21,11 @@ static const char * FaultComponent_STR[] = {
     "NONE",
     "CPU",
     "RAM",
-    "REGISTER"
+    "REGISTER",
+    "NVIC",
+    "PERIPHERAL",
+    "IRQ",
+    "TIMER"
 };
 const char * FaultTarget_STR[] = {
     "NONE", 
@@ -35,7 +39,12 @@ const char * FaultTarget_STR[] = {
     "TRACE MEMORY", 
     "TRACE REGISTERS",
     "TRACE PC", 
-    "TRACE CPSR"
+    "TRACE CPSR",
+    "PENDING",
+    "ENABLE",
+    "PRIORITY",
+    "LINE",
+    "COUNTER"
 };
 const char * FaultMode_STR[] = {
     "NONE", 
@@ -43,10 +52,28 @@ const char * FaultMode_STR[] = {
     "BITFLIP", 
     "STATE FAULT", 
     "COUPLING FAULT", 
+    "CPSR CF", 
     "CPSR VF", 
     "CPSR ZF", 
     "CPSR NF", 
-    "CPSR QF"
+    "CPSR QF", 
+    "CPSR GE", 
+    "CPSR IT", 
+    "CPSR J", 
+    "CPSR E", 
+    "CPSR A", 
+    "CPSR I", 
+    "CPSR F", 
+    "CPSR T", 
+    "CPSR M",
+    "XPSR IPSR",
+    "DROPPED WRITE",
+    "DROPPED",
+    "DELAYED",
+    "SPURIOUS",
+    "TICK SKIP",
+    "DRIFT",
+    "STUCK"
 };
 const char * FaultTrigger_STR[] = {
     "NONE",
@@ -60,6 +87,34 @@ const char * FaultType_STR[] = {
     "PERMANENT",
     "INTERMITTENT"
 };
+const char * InjectionMode_STR[] = {
+    "MEMORY ADDR",
+    "MEMORY CONTENT",
+    "REGISTER ADDR",
+    "REGISTER CONTENT",
+    "INSTRUCTION VALUE ARM",
+    "INSTRUCTION VALUE THUMB32",
+    "INSTRUCTION VALUE THUMB16",
+    "INSTRUCTION VALUE A64",
+    "PC ARM",
+    "PC THUMB32",
+    "PC THUMB16",
+    "PC A64",
+    "TIME"
+};
+const char * FIESCallSite_STR[] = {
+    "softmmu",
+    "memory_ldst",
+    "address_space_read",
+    "flatview_rw",
+    "op_helper",
+    "translate",
+    "cpu_ldst_useronly",
+    "user-exec",
+    "switch_mode",
+    "cpreg",
+    "v7m"
+};
 
 #ifdef __cplusplus
 }
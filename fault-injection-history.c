@@ -0,0 +1,117 @@
+/*
+ * fault-injection-history.c
+ *
+ *  FIESer by Christian M. Fuchs 2017/2018
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+
+#include "fault-injection-history.h"
+#include "fault-injection-library.h"
+#include "fault-injection-config.h"
+
+/**
+ * The previous write operation on the bits of a fault's cell. Each bit of
+ * the cell has a 2-bit history (the state before and after the last write),
+ * which is kept in two bit planes, so a write records all bits of the mask
+ * at once. The history is only valid if generation is the current one.
+ * A plane is a single word, which holds a cell of any width up to
+ * MAX_CELL_WIDTH, hence all slots have the same size.
+ */
+typedef struct {
+    uint64_t generation;
+    uint64_t valid;
+    uint64_t before;
+    uint64_t after;
+} FaultHistory;
+
+/**
+ * The history of all faults with a <mask>, allocated in a single arena
+ * when the fault list is (re)loaded.
+ */
+static FaultHistory *history_arena;
+
+/**
+ * The current generation of the history arena. Incrementing it discards
+ * the history of all faults at once.
+ */
+static uint64_t history_generation = 1;
+
+/**
+ * Allocates the history arena for the fault list and assigns each fault
+ * with a <mask> in a RAM or register cell its slot. Has to be called
+ * whenever the fault list is (re)loaded.
+ */
+void FIESER_history_build(void)
+{
+    FaultList *fault;
+    int element, n = 0;
+
+    g_free(history_arena);
+    history_arena = NULL;
+
+    for (element = 0; element < getNumFaultListElements(); element++)
+    {
+        fault = getFaultListElement(element);
+
+        if ((fault->component == FI_COMP_RAM || fault->component == FI_COMP_REGISTER)
+                && fault->params.mask)
+            fault->history = n++;
+        else
+            fault->history = -1;
+    }
+
+    QEMU_BUILD_BUG_ON(MAX_CELL_WIDTH > 64);
+
+    if (n)
+        history_arena = g_new0(FaultHistory, n);
+
+    FIESER_history_reset();
+}
+
+/**
+ * Discards the previous operations of all faults, e.g. between two
+ * experiments, without touching the arena.
+ */
+void FIESER_history_reset(void)
+{
+    history_generation++;
+}
+
+/**
+ * Stores the previous write operation on the bits of a fault's cell. This
+ * information is used for deciding, if a dynamic fault should be triggered
+ * or not.
+ *
+ * @param[in] fault - pointer to the linked list entry.
+ * @param[in] before - the content of the cell before the write.
+ * @param[in] after - the value written to the cell.
+ * @param[in] bits - the written bits of the cell, which are recorded.
+ */
+void FIESER_history_record(FaultList *fault, uint64_t before, uint64_t after,
+                           uint64_t bits)
+{
+    FaultHistory *history;
+
+    if (fault->history < 0)
+        return;
+
+    history = &history_arena[fault->history];
+    bits &= fault->params.mask;
+
+    if (history->generation != history_generation)
+    {
+        history->generation = history_generation;
+        history->valid = 0;
+    }
+
+    history->valid |= bits;
+    history->before = (history->before & ~bits) | (before & bits);
+    history->after = (history->after & ~bits) | (after & bits);
+}
@@ -0,0 +1,28 @@
+/*
+ * fault-injection-history.h
+ *
+ *  FIESer by Christian M. Fuchs 2017/2018
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#ifndef FAULT_INJECTION_HISTORY_H_
+#define FAULT_INJECTION_HISTORY_H_
+
+#include "qemu/osdep.h"
+
+#include "fault-injection-infrastructure.h"
+
+/**
+ * see corresponding c-file for documentation
+ */
+void FIESER_history_build(void);
+void FIESER_history_reset(void);
+void FIESER_history_record(FaultList *fault, uint64_t before, uint64_t after,
+                           uint64_t bits);
+
+#endif /* FAULT_INJECTION_HISTORY_H_ */
@@ -0,0 +1,388 @@
+/*
+ * fault-injection-index.c
+ *
+ *  FIESer by Christian M. Fuchs 2017/2018
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+#include "cpu.h"
+
+#include "fault-injection-index.h"
+#include "fault-injection-library.h"
+
+/**
+ * An entry of an address index, covering the memory cells
+ * [start, end) of one access-triggered memory fault (a coupling
+ * fault has an entry for each of its two cells). max_end
+ * is the largest end of all entries up to and including this
+ * one, so that overlapping entries are found by walking down
+ * from a single binary search.
+ */
+typedef struct {
+    hwaddr start;
+    hwaddr end;
+    hwaddr max_end;
+    FaultList *fault;
+} FaultIndexEntry;
+
+/**
+ * An address index, sorted by the start address of its entries.
+ */
+typedef struct {
+    FaultIndexEntry *entries;
+    int num_entries;
+} FaultIndex;
+
+static FaultIndex fault_index[FI_INDEX_MAX];
+
+static int FIESER_index_compare(const void *a, const void *b)
+{
+    const FaultIndexEntry *ea = a, *eb = b;
+
+    if (ea->start != eb->start)
+        return ea->start < eb->start ? -1 : 1;
+
+    return 0;
+}
+
+/**
+ * Checks if a fault is a permanent stuck-at fault in a memory cell. These
+ * faults are patched into the memory once at activation and afterwards
+ * only writes to the cell have to be intercepted to keep the cell stuck.
+ *
+ * @param[in] fault - pointer to the linked list entry.
+ * @param[out] - true if the fault belongs to the write filter index.
+ */
+bool FIESER_index_write_filter_fault(FaultList *fault)
+{
+    return fault->trigger == FI_TRGR_ACCESS
+            && fault->component == FI_COMP_RAM
+            && fault->target == FI_TAGT_MEMORY_CELL
+            && fault->mode == FI_MODE_STATE_FAULT
+            && fault->type == FI_TYPE_PERMANENT;
+}
+
+/**
+ * Checks if a fault is injected into the memory cells on every access by
+ * the memory hooks (access-triggered RAM cell and read/write logic faults).
+ *
+ * @param[in] fault - pointer to the linked list entry.
+ * @param[out] - true if the fault belongs to the access index.
+ */
+static bool FIESER_index_access_fault(FaultList *fault)
+{
+    return fault->trigger == FI_TRGR_ACCESS
+            && fault->component == FI_COMP_RAM
+            && (fault->target == FI_TAGT_MEMORY_CELL
+                || fault->target == FI_TAGT_RW_LOGIC)
+            && fault->mode != FI_MODE_COUPLING_FAULT
+            && !FIESER_index_write_filter_fault(fault);
+}
+
+/**
+ * Checks if a fault is a coupling fault, which is evaluated by the
+ * coupling fault engine on accesses to its victim or aggressor cell.
+ *
+ * @param[in] fault - pointer to the linked list entry.
+ * @param[out] - true if the fault belongs to the coupling index.
+ */
+static bool FIESER_index_coupling_fault(FaultList *fault)
+{
+    return fault->trigger == FI_TRGR_ACCESS
+            && fault->component == FI_COMP_RAM
+            && fault->target == FI_TAGT_MEMORY_CELL
+            && fault->mode == FI_MODE_COUPLING_FAULT;
+}
+
+/**
+ * Checks if a fault is an access- or PC-triggered instruction decoder or
+ * execution fault, which is injected when its instruction is translated.
+ *
+ * @param[in] fault - pointer to the linked list entry.
+ * @param[out] - true if the fault belongs to the instruction index.
+ */
+bool FIESER_index_insn_fault(FaultList *fault)
+{
+    return (fault->trigger == FI_TRGR_ACCESS || fault->trigger == FI_TRGR_PC)
+            && fault->component == FI_COMP_CPU
+            && (fault->target == FI_TAGT_INSTRUCTION_DECODER
+                || fault->target == FI_TAGT_INSTRUCTION_EXECUTION);
+}
+
+/**
+ * Checks if a fault is an access-triggered fault in a register cell or the
+ * register address decoder, which is injected when its register is accessed.
+ *
+ * @param[in] fault - pointer to the linked list entry.
+ * @param[out] - true if the fault belongs to the register index.
+ */
+static bool FIESER_index_register_fault(FaultList *fault)
+{
+    return fault->trigger == FI_TRGR_ACCESS
+            && fault->component == FI_COMP_REGISTER
+            && (fault->target == FI_TAGT_REGISTER_CELL
+                || fault->target == FI_TAGT_ADDRESS_DECODER);
+}
+
+/**
+ * Checks if a fault is PC-triggered.
+ *
+ * @param[in] fault - pointer to the linked list entry.
+ * @param[out] - true if the fault belongs to the PC index.
+ */
+static bool FIESER_index_pc_fault(FaultList *fault)
+{
+    return fault->trigger == FI_TRGR_PC;
+}
+
+/**
+ * Checks if a time-triggered fault is applied at its activation edges by
+ * the scheduler instead of being checked after every instruction. These
+ * are all NVIC, IRQ and TIMER faults and, on M-profile CPUs, the faults in
+ * the condition flags, the xPSR fields and the register cells.
+ *
+ * @param[in] fault - pointer to the linked list entry.
+ * @param[out] - true if the fault is scheduled.
+ */
+bool FIESER_index_scheduled_fault(FaultList *fault)
+{
+#if defined(CONFIG_USER_ONLY)
+    return false;
+#else
+    if (fault->trigger != FI_TRGR_TIME)
+        return false;
+
+    if (fault->component == FI_COMP_NVIC || fault->component == FI_COMP_IRQ
+            || fault->component == FI_COMP_TIMER)
+        return true;
+
+    return first_cpu && arm_feature(&ARM_CPU(first_cpu)->env, ARM_FEATURE_M)
+            && ((fault->component == FI_COMP_CPU && fault->target == FI_TAGT_CONDITION_FLAGS)
+                || (fault->component == FI_COMP_REGISTER && fault->target == FI_TAGT_REGISTER_CELL));
+#endif
+}
+
+/**
+ * Checks if a fault is time-triggered and not scheduled.
+ *
+ * @param[in] fault - pointer to the linked list entry.
+ * @param[out] - true if the fault belongs to the time index.
+ */
+static bool FIESER_index_time_fault(FaultList *fault)
+{
+    return fault->trigger == FI_TRGR_TIME && !FIESER_index_scheduled_fault(fault);
+}
+
+/**
+ * Checks if a fault is a State Fault in the NVIC, which holds its bits of
+ * the exception state while it is active.
+ *
+ * @param[in] fault - pointer to the linked list entry.
+ * @param[out] - true if the fault belongs to the NVIC index.
+ */
+static bool FIESER_index_nvic_fault(FaultList *fault)
+{
+    return fault->component == FI_COMP_NVIC
+            && fault->mode == FI_MODE_STATE_FAULT;
+}
+
+/**
+ * Checks if a fault is injected into the accesses to a device register by
+ * the peripheral interposer.
+ *
+ * @param[in] fault - pointer to the linked list entry.
+ * @param[out] - true if the fault belongs to the peripheral index.
+ */
+bool FIESER_index_peripheral_fault(FaultList *fault)
+{
+    return fault->trigger == FI_TRGR_ACCESS
+            && fault->component == FI_COMP_PERIPHERAL
+            && fault->target == FI_TAGT_REGISTER_CELL;
+}
+
+/**
+ * Rebuilds an address index from the fault list.
+ *
+ * @param[in] index - the index to rebuild.
+ * @param[in] filter - selects the faults, which are indexed.
+ */
+static void FIESER_index_build_one(FaultIndex *index,
+                                   bool (*filter)(FaultList *fault))
+{
+    FaultIndexEntry *entries;
+    FaultList *fault;
+    hwaddr max_end = 0;
+    int element, n = 0;
+
+    g_free(index->entries);
+    entries = g_new(FaultIndexEntry, 2 * getNumFaultListElements() + 1);
+
+    for (element = 0; element < getNumFaultListElements(); element++)
+    {
+        fault = getFaultListElement(element);
+
+        if (!filter(fault))
+            continue;
+
+        /**
+         * access-triggered memory and device register faults always cover
+         * a single cell (no burst), all other faults only their instruction
+         * or register
+         */
+        entries[n].start = (uint32_t) fault->params.address;
+        if ((fault->component != FI_COMP_RAM && fault->component != FI_COMP_PERIPHERAL)
+                || fault->trigger != FI_TRGR_ACCESS)
+            entries[n].end = entries[n].start + 1;
+        else
+            entries[n].end = entries[n].start + fault->params.width / 8;
+        entries[n].fault = fault;
+        n++;
+
+        /**
+         * the aggressor cell of a coupling fault, if it is another cell
+         */
+        if (fault->mode == FI_MODE_COUPLING_FAULT
+                && (uint32_t) fault->params.cf_address != entries[n - 1].start)
+        {
+            entries[n].start = (uint32_t) fault->params.cf_address;
+            entries[n].end = entries[n].start + fault->params.width / 8;
+            entries[n].fault = fault;
+            n++;
+        }
+    }
+
+    qsort(entries, n, sizeof(*entries), FIESER_index_compare);
+
+    for (element = 0; element < n; element++)
+    {
+        max_end = MAX(max_end, entries[element].end);
+        entries[element].max_end = max_end;
+    }
+
+    index->entries = entries;
+    index->num_entries = n;
+}
+
+/**
+ * Rebuilds the address indices from the fault list. Has to be
+ * called whenever the fault list is (re)loaded.
+ */
+void FIESER_index_build(void)
+{
+    FIESER_index_build_one(&fault_index[FI_INDEX_ACCESS],
+                           FIESER_index_access_fault);
+    FIESER_index_build_one(&fault_index[FI_INDEX_WRITE_FILTER],
+                           FIESER_index_write_filter_fault);
+    FIESER_index_build_one(&fault_index[FI_INDEX_COUPLING],
+                           FIESER_index_coupling_fault);
+    FIESER_index_build_one(&fault_index[FI_INDEX_INSN],
+                           FIESER_index_insn_fault);
+    FIESER_index_build_one(&fault_index[FI_INDEX_REGISTER],
+                           FIESER_index_register_fault);
+    FIESER_index_build_one(&fault_index[FI_INDEX_PC],
+                           FIESER_index_pc_fault);
+    FIESER_index_build_one(&fault_index[FI_INDEX_TIME],
+                           FIESER_index_time_fault);
+    FIESER_index_build_one(&fault_index[FI_INDEX_NVIC],
+                           FIESER_index_nvic_fault);
+    FIESER_index_build_one(&fault_index[FI_INDEX_PERIPHERAL],
+                           FIESER_index_peripheral_fault);
+}
+
+/**
+ * Returns the number of entries of an index.
+ *
+ * @param[in] kind - the index.
+ * @param[out] - the number of entries.
+ */
+int FIESER_index_size(FaultIndexKind kind)
+{
+    return fault_index[kind].num_entries;
+}
+
+/**
+ * Checks with one binary search, if any indexed fault overlaps
+ * the accessed range [addr, addr + len).
+ *
+ * @param[in] kind - the index to search.
+ * @param[in] addr - the first accessed address.
+ * @param[in] len - the length of the access in bytes.
+ * @param[out] - the position to start FIESER_index_next() at,
+ *               or -1 if no fault overlaps the access.
+ */
+int FIESER_index_lookup(FaultIndexKind kind, hwaddr addr, hwaddr len)
+{
+    FaultIndexEntry *entries = fault_index[kind].entries;
+    int lo = 0, hi = fault_index[kind].num_entries;
+
+    /**
+     * find the first entry, which starts behind the access
+     */
+    while (lo < hi)
+    {
+        int mid = lo + (hi - lo) / 2;
+
+        if (entries[mid].start < addr + len)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo == 0 || entries[lo - 1].max_end <= addr)
+        return -1;
+
+    return lo - 1;
+}
+
+/**
+ * Returns the next fault overlapping the accessed range, which
+ * starts at addr and was passed to FIESER_index_lookup(), and
+ * the address of the overlapping cell of the fault.
+ *
+ * @param[in] kind - the index to search.
+ * @param[in] addr - the first accessed address.
+ * @param[in,out] pos - the position returned by FIESER_index_lookup().
+ * @param[out] cell - the address of the overlapping cell.
+ * @param[out] - the fault or NULL, if there are no more overlapping faults.
+ */
+FaultList *FIESER_index_next_cell(FaultIndexKind kind, hwaddr addr, int *pos,
+                                  hwaddr *cell)
+{
+    FaultIndexEntry *entries = fault_index[kind].entries;
+
+    while (*pos >= 0 && entries[*pos].max_end > addr)
+    {
+        FaultIndexEntry *entry = &entries[(*pos)--];
+
+        if (entry->end > addr)
+        {
+            *cell = entry->start;
+            return entry->fault;
+        }
+    }
+
+    *pos = -1;
+    return NULL;
+}
+
+/**
+ * Returns the next fault overlapping the accessed range, which
+ * starts at addr and was passed to FIESER_index_lookup().
+ *
+ * @param[in] kind - the index to search.
+ * @param[in] addr - the first accessed address.
+ * @param[in,out] pos - the position returned by FIESER_index_lookup().
+ * @param[out] - the fault or NULL, if there are no more overlapping faults.
+ */
+FaultList *FIESER_index_next(FaultIndexKind kind, hwaddr addr, int *pos)
+{
+    hwaddr cell;
+
+    return FIESER_index_next_cell(kind, addr, pos, &cell);
+}
@@ -0,0 +1,62 @@
+/*
+ * fault-injection-index.h
+ *
+ *  FIESer by Christian M. Fuchs 2017/2018
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#ifndef FAULT_INJECTION_INDEX_H_
+#define FAULT_INJECTION_INDEX_H_
+
+#include "qemu/osdep.h"
+#include "exec/hwaddr.h"
+
+#include "fault-injection-infrastructure.h"
+
+/**
+ * The address indices of the memory faults. The access index
+ * holds the faults injected on every access to their cell, the
+ * write filter index the permanent stuck-at faults, which are
+ * only re-applied when their cell is written. The coupling index
+ * holds the victim and the aggressor cell of each coupling fault,
+ * the instruction index the addresses of instruction faults. The
+ * register index holds the register numbers of access-triggered
+ * register faults, the PC index the trigger addresses of PC-triggered
+ * faults and the time index all time-triggered faults, which are not
+ * scheduled. The NVIC index holds the exception numbers of the State
+ * Faults in the NVIC, the peripheral index the physical addresses of
+ * the faulted device registers.
+ */
+typedef enum {
+    FI_INDEX_ACCESS,
+    FI_INDEX_WRITE_FILTER,
+    FI_INDEX_COUPLING,
+    FI_INDEX_INSN,
+    FI_INDEX_REGISTER,
+    FI_INDEX_PC,
+    FI_INDEX_TIME,
+    FI_INDEX_NVIC,
+    FI_INDEX_PERIPHERAL,
+    FI_INDEX_MAX
+} FaultIndexKind;
+
+/**
+ * see corresponding c-file for documentation
+ */
+void FIESER_index_build(void);
+bool FIESER_index_write_filter_fault(FaultList *fault);
+bool FIESER_index_insn_fault(FaultList *fault);
+bool FIESER_index_scheduled_fault(FaultList *fault);
+bool FIESER_index_peripheral_fault(FaultList *fault);
+int FIESER_index_size(FaultIndexKind kind);
+int FIESER_index_lookup(FaultIndexKind kind, hwaddr addr, hwaddr len);
+FaultList *FIESER_index_next(FaultIndexKind kind, hwaddr addr, int *pos);
+FaultList *FIESER_index_next_cell(FaultIndexKind kind, hwaddr addr, int *pos,
+                                  hwaddr *cell);
+
+#endif /* FAULT_INJECTION_INDEX_H_ */
@@ -73,8 +73,10 @@ struct parameters {
      * In case, that the  fault mode is "NEW VALUE",
      * the mask contains the new value, which should
      * be  written to a specified target.
+     * Masks are up to 64 bits wide and are applied to
+     * a cell in a single operation.
      */
-    int mask;
+    uint64_t mask;
     int mask_defined;
 
     /**
@@ -96,8 +98,96 @@ struct parameters {
      * set or rest at that position (is only used for State
      * Faults or Condition Flag Faults).
      */
-    int set_bit;
+    uint64_t set_bit;
     int set_bit_defined;
+
+    /**
+     * The width of a memory cell in bits (8, 16, 32 or 64),
+     * defaults to MEMORY_WIDTH.
+     */
+    int width;
+    int width_defined;
+
+    /**
+     * The number of consecutive memory cells, starting at
+     * the victim address, which are injected with the mask
+     * at once. Defaults to a single cell.
+     */
+    int burst;
+    int burst_defined;
+
+    /**
+     * The bit interleaving factor of the memory array, i.e.
+     * the number of cells sharing a physical row, for
+     * multi-cell upsets. Physical column c of a row holds
+     * bit c / interleave of cell c % interleave. Defaults
+     * to a single cell per row.
+     */
+    int interleave;
+    int interleave_defined;
+
+    /**
+     * The physical column of the first bit of the mask
+     * within a row, for multi-cell upsets. Defaults to 0.
+     */
+    int column;
+    int column_defined;
+
+    /**
+     * The QOM path of the device, whose input line is
+     * faulted by an IRQ fault. Defaults to the NVIC of
+     * M-profile CPUs.
+     */
+    char device[128];
+    int device_defined;
+
+    /**
+     * The time in ns, by which an IRQ fault delays the
+     * assertions of its line.
+     */
+    int64_t delay;
+    int delay_defined;
+
+    /**
+     * The deviation of the period of a timer in parts
+     * per million, while a TIMER DRIFT fault is active.
+     */
+    int64_t drift;
+    int drift_defined;
+};
+
+/**
+ * The declaration of a coupling fault (mode FI_MODE_COUPLING_FAULT).
+ * The victim cell is given by <address> and <mask>, the aggressor
+ * cell by <cf_address> and <set_bit> (or <mask>, if <set_bit> is 0).
+ */
+struct coupling {
+    /**
+     * The kind of the coupling fault.
+     */
+    enum CouplingFaultKind kind;
+
+    /**
+     * The state (0 or 1) of the aggressor bits, which sensitizes
+     * the fault.
+     */
+    int aggressor_state;
+
+    /**
+     * For disturb coupling faults, the operation on the aggressor:
+     * the value written (0 or 1) or FI_CF_OP_READ.
+     */
+    int aggressor_op;
+
+    /**
+     * The state (0 or 1) of the victim bits, which are affected.
+     */
+    int victim_state;
+
+    /**
+     * The mode as given in the XML file (e.g. CFST01).
+     */
+    char name[12];
 };
 
 struct Fault {
@@ -123,6 +213,12 @@ struct Fault {
      * the appropriate keywords.
      */
     enum FaultMode mode;
+
+    /**
+     * Defines the coupling fault, if the mode is a kind
+     * of Coupling Fault (CFxx).
+     */
+    struct coupling coupling;
     
     /**
      * Defines, how a  fault should been triggered.
@@ -168,6 +264,12 @@ struct Fault {
      * Visualizes if a fault was triggered (set) or not (reset)
      */
     int was_triggered;
+
+    /**
+     * The slot of the fault in the operation history
+     * of dynamic faults, or -1 if it has none.
+     */
+    int history;
     
     /**
      * Pointer to the next entry in the linked list.
@@ -13,183 +13,499 @@
 #include "fault-injection-infrastructure.h"
 #include "fault-injection-injector.h"
 #include "fault-injection-config.h"
+#include "fault-injection-library.h"
+#include "fault-injection-ecc.h"
+
+#include "qemu/log.h"
+#include "exec/ram_addr.h"
+#include "exec/cpu_ldst.h"
+#include "internals.h"
+#include "accel/tcg/translate-all.h"
 
 /**
- * Performs a bit-flip on the content of a specified general-purpose register or
- * on the content of the CPSR-register.
+ * Applies a fault to a value in a single operation: all bits of the mask are
+ * flipped for bit-flips, set or reset according to bit_value for State Faults
+ * (SFs), or the value is replaced by bit_value for new-value faults.
  *
- * @param[in] env - Reference to the information of the CPU state.
- * @param[in] register_num - register number, on which a bit-flip should
- *                                           be performed (0-15 for general-purpose register
- *                                           r0 to r15 and  cpsr-register otherwise.)
+ * @param[in] value - the original value.
  * @param[in] fi_info - information for performing faults.
+ * @param[out] - the faulty value.
  */
-static void do_inject_register_arm_bf(CPUARMState *env, int register_num,
-                                      FaultInjectionInfo fi_info)
+static inline uint64_t do_inject_apply_mask(uint64_t value, FaultInjectionInfo fi_info)
+{
+    if (fi_info.bit_flip)
+        return value ^ fi_info.mask;
+    else if (fi_info.new_value)
+        return fi_info.bit_value;
+    else
+        return (value & ~fi_info.mask) | (fi_info.bit_value & fi_info.mask);
+}
+
+/**
+ * Checks if a register number names a register of the floating-point and
+ * SIMD register file or the FPSCR (see FI_REG_VFP_S0).
+ *
+ * @param[in] regno - the register number.
+ * @param[out] - true for S0-S63, D0-D31, Q0-Q15 and the FPSCR.
+ */
+bool do_inject_is_vfp_register(int regno)
+{
+    return (regno >= FI_REG_VFP_S0 && regno < FI_REG_VFP_D0 + 32)
+            || (regno >= FI_REG_VFP_Q0 && regno < FI_REG_VFP_END)
+            || regno == FI_REG_FPSCR;
+}
+
+/**
+ * Reads a register of the floating-point and SIMD register file or the
+ * FPSCR. A Q register is read as its lower half.
+ *
+ * @param[in] env - Reference to the information of the CPU state.
+ * @param[in] regno - the register number (see do_inject_is_vfp_register).
+ * @param[out] - the content of the register.
+ */
+uint64_t do_inject_read_vfp_register(CPUARMState *env, int regno)
 {
-    int cpsr_value = 0;
+    int n;
+
+    if (regno == FI_REG_FPSCR)
+        return vfp_get_fpscr(env);
+
+    if (regno >= FI_REG_VFP_Q0)
+        return float64_val(env->vfp.regs[2 * (regno - FI_REG_VFP_Q0)]);
 
-    if (register_num < 16)
+    if (regno >= FI_REG_VFP_D0)
+        return float64_val(env->vfp.regs[regno - FI_REG_VFP_D0]);
+
+    n = regno - FI_REG_VFP_S0;
+    return extract64(float64_val(env->vfp.regs[n / 2]), 32 * (n & 1), 32);
+}
+
+/**
+ * Writes a S or D register of the floating-point and SIMD register file
+ * or the FPSCR.
+ *
+ * @param[in] env - Reference to the information of the CPU state.
+ * @param[in] regno - the register number (see do_inject_is_vfp_register).
+ * @param[in] value - the new content of the register.
+ */
+void do_inject_write_vfp_register(CPUARMState *env, int regno, uint64_t value)
+{
+    int n;
+
+    if (regno == FI_REG_FPSCR)
     {
-        /* bit-flip in general purpose registers*/
-        if ((env->regs[register_num] >> fi_info.injected_bit) & 0x1)
-            env->regs[register_num] &= ~(1 << fi_info.injected_bit);
-        else
-            env->regs[register_num] |= (1 << fi_info.injected_bit);
+        vfp_set_fpscr(env, value);
+    }
+    else if (regno >= FI_REG_VFP_D0)
+    {
+        env->vfp.regs[regno - FI_REG_VFP_D0] = make_float64(value);
     }
     else
     {
-        /* bit-flip in CPSR*/
-        cpsr_value = cpsr_read(env);
-
-        if ((cpsr_read(env) >> fi_info.injected_bit) & 0x1)
-        {
-            cpsr_value &= ~(1 << fi_info.injected_bit);
-            cpsr_write(env, cpsr_value, 0xFFFFFFFF, CPSRWriteRaw);
-        }
-        else
-        {
-            cpsr_value |= (1 << fi_info.injected_bit);
-            cpsr_write(env, cpsr_value, 0xFFFFFFFF, CPSRWriteRaw);
-        }
+        n = regno - FI_REG_VFP_S0;
+        env->vfp.regs[n / 2] = make_float64(deposit64(float64_val(env->vfp.regs[n / 2]),
+                                                      32 * (n & 1), 32, value));
     }
 }
 
 /**
- * Sets or resets a specified bit in the content of a specified general-purpose register or
- * CPSR-register.
+ * Injects a fault into a register of the floating-point and SIMD register
+ * file or the FPSCR. A fault in a Q register is injected into both of its
+ * D registers.
  *
  * @param[in] env - Reference to the information of the CPU state.
- * @param[in] register_num - register number, on which a bit-flip should
- *                                           be performed (0-15 for general-purpose register
- *                                           r0 to r15 and  cpsr-register otherwise.)
+ * @param[in] regno - the register number (see do_inject_is_vfp_register).
  * @param[in] fi_info - information for performing faults.
  */
-static void do_inject_register_arm_rs(CPUARMState *env, int register_num,
-                                      FaultInjectionInfo fi_info)
+static void do_inject_vfp_register_arm(CPUARMState *env, int regno,
+                                       FaultInjectionInfo fi_info)
+{
+    int d;
+
+    if (regno >= FI_REG_VFP_Q0 && regno < FI_REG_VFP_END)
+    {
+        for (d = 2 * (regno - FI_REG_VFP_Q0); d < 2 * (regno - FI_REG_VFP_Q0) + 2; d++)
+            env->vfp.regs[d] = make_float64(do_inject_apply_mask(float64_val(env->vfp.regs[d]),
+                                                                 fi_info));
+        return;
+    }
+
+    do_inject_write_vfp_register(env, regno,
+                                 do_inject_apply_mask(do_inject_read_vfp_register(env, regno),
+                                                      fi_info));
+}
+
+/**
+ * Checks if a register number names a banked SP, LR or SPSR of an AArch32
+ * mode (see FI_REG_BANKED_SP).
+ *
+ * @param[in] regno - the register number.
+ * @param[out] - true for the banked registers.
+ */
+bool do_inject_is_banked_register(int regno)
+{
+    return regno >= FI_REG_BANKED_SP && regno < FI_REG_BANKED_END;
+}
+
+/**
+ * Checks if the registers of a bank are the ones held in r13, r14 and the
+ * SPSR, i.e. if the bank is the one of the current AArch32 mode.
+ *
+ * @param[in] env - Reference to the information of the CPU state.
+ * @param[in] bank - the register bank.
+ * @param[out] - true if the bank is the one of the current mode.
+ */
+static bool do_inject_current_bank(CPUARMState *env, int bank)
+{
+    if (is_a64(env) || arm_feature(env, ARM_FEATURE_M))
+        return false;
+
+    return bank_number(env->uncached_cpsr & CPSR_M) == bank;
+}
+
+/**
+ * Reads a banked SP, LR or SPSR.
+ *
+ * @param[in] env - Reference to the information of the CPU state.
+ * @param[in] regno - the register number (see do_inject_is_banked_register).
+ * @param[out] - the content of the register.
+ */
+uint64_t do_inject_read_banked_register(CPUARMState *env, int regno)
+{
+    int bank = (regno - FI_REG_BANKED_SP) % 8;
+    bool current = do_inject_current_bank(env, bank);
+
+    if (regno >= FI_REG_BANKED_SPSR)
+        return current ? env->spsr : env->banked_spsr[bank];
+
+    if (regno >= FI_REG_BANKED_LR)
+        return current ? env->regs[14] : env->banked_r14[bank];
+
+    return current ? env->regs[13] : env->banked_r13[bank];
+}
+
+/**
+ * Writes a banked SP, LR or SPSR.
+ *
+ * @param[in] env - Reference to the information of the CPU state.
+ * @param[in] regno - the register number (see do_inject_is_banked_register).
+ * @param[in] value - the new content of the register.
+ */
+void do_inject_write_banked_register(CPUARMState *env, int regno, uint64_t value)
 {
-    int cpsr_value = 0;
+    int bank = (regno - FI_REG_BANKED_SP) % 8;
+    bool current = do_inject_current_bank(env, bank);
 
-    if (register_num < 16)
+    if (regno >= FI_REG_BANKED_SPSR)
     {
-        if (fi_info.bit_value)
-            env->regs[register_num] |= (1 << fi_info.injected_bit);
+        if (current)
+            env->spsr = value;
         else
-            env->regs[register_num] &= ~(1 << fi_info.injected_bit);
+            env->banked_spsr[bank] = value;
+    }
+    else if (regno >= FI_REG_BANKED_LR)
+    {
+        if (current)
+            env->regs[14] = value;
+        else
+            env->banked_r14[bank] = value;
     }
     else
     {
-        /* bit-flip in CPSR*/
-        cpsr_value = cpsr_read(env);
-
-        if (fi_info.bit_value)
-        {
-            cpsr_value |= (1 << fi_info.injected_bit);
-            cpsr_write(env, cpsr_value, 0xFFFFFFFF, CPSRWriteRaw);
-        }
+        if (current)
+            env->regs[13] = value;
         else
-        {
-            cpsr_value &= ~(1 << fi_info.injected_bit);
-            cpsr_write(env, cpsr_value, 0xFFFFFFFF, CPSRWriteRaw);
-        }
+            env->banked_r13[bank] = value;
     }
 }
 
 /**
- * Writes a new value to a specified general-purpose register or
- * CPSR-register.
+ * Checks if a register number selects the MSP or the PSP of an M-profile
+ * CPU (see FI_REG_M_MSP).
  *
- * @param[in] env - Reference to the information of the CPU state.
- * @param[in] register_num - register number, on which a bit-flip should
- *                                           be performed (0-15 for general-purpose register
- *                                           r0 to r15 and  cpsr-register otherwise.)
- * @param[in] fi_info - information for performing faults.
+ * @param[in] regno - the register number.
+ * @param[out] - true for the M-profile stack pointers.
  */
-static void do_inject_new_register_value_arm(CPUARMState *env, int register_num,
-                                             FaultInjectionInfo fi_info)
+bool do_inject_is_m_sp_register(int regno)
 {
-    if (register_num < 16)
-        env->regs[register_num] = fi_info.bit_value;
-    else
-        cpsr_write(env, fi_info.bit_value, 0xFFFFFFFF, CPSRWriteRaw);
+    return regno >= FI_REG_M_MSP && regno < FI_REG_M_END;
 }
 
 /**
- * Decides, based on the information held by fi_info, which function should be called.
+ * Reads the MSP or the PSP of an M-profile CPU. The stack pointer in use
+ * is held in r13, the other one in v7m.other_sp.
  *
  * @param[in] env - Reference to the information of the CPU state.
- * @param[in] addr - containing the register number.
- * @param[in] fi_info - information for performing faults.
+ * @param[in] regno - the register number (see do_inject_is_m_sp_register).
+ * @param[out] - the content of the register.
  */
-static void do_inject_register_arm(CPUARMState *env, hwaddr *addr,
-                                   FaultInjectionInfo fi_info)
+uint64_t do_inject_read_m_sp_register(CPUARMState *env, int regno)
 {
-    if (fi_info.bit_flip)
-        do_inject_register_arm_bf(env, (int) *addr, fi_info);
-    else if (!fi_info.bit_flip && !fi_info.new_value)
-        do_inject_register_arm_rs(env, (int) *addr, fi_info);
-    else if (!fi_info.bit_flip && fi_info.new_value)
-        do_inject_new_register_value_arm(env, (int) *addr, fi_info);
+    if (!arm_feature(env, ARM_FEATURE_M))
+        return 0;
+
+    if ((regno == FI_REG_M_PSP) == arm_fies_v7m_using_psp(env))
+        return env->regs[13];
+
+    return env->v7m.other_sp;
 }
 
 /**
- * Overwrites the program counter to perform an look-up error.
+ * Writes the MSP or the PSP of an M-profile CPU.
  *
  * @param[in] env - Reference to the information of the CPU state.
- * @param[in] lockup_instruction - the PC-value for the new instruction.
+ * @param[in] regno - the register number (see do_inject_is_m_sp_register).
+ * @param[in] value - the new content of the register.
  */
-static void do_inject_look_up_error_arm(CPUARMState *env,
-                                        unsigned lockup_instruction,
-                                        int instruction_length)
+void do_inject_write_m_sp_register(CPUARMState *env, int regno, uint64_t value)
 {
-    static unsigned saved_pc = 0;
-    static unsigned saved_insn = 0;
-    static int saved_length = 0;
+    if (!arm_feature(env, ARM_FEATURE_M))
+        return;
 
-    CPUState *cpu = ENV_GET_CPU(env);
+    if ((regno == FI_REG_M_PSP) == arm_fies_v7m_using_psp(env))
+        env->regs[13] = value;
+    else
+        env->v7m.other_sp = value;
+}
+
+/**
+ * Injects a fault into a coprocessor or system register. The register is
+ * accessed like for migration, without the side effects of a guest access.
+ *
+ * @param[in] env - Reference to the information of the CPU state.
+ * @param[in] regno - the register number (see FI_REG_CP).
+ * @param[in] fi_info - information for performing faults.
+ */
+static void do_inject_cp_register_arm(CPUARMState *env, int regno,
+                                      FaultInjectionInfo fi_info)
+{
+    uint64_t value;
 
-    if (!saved_insn)
+    if (!arm_fies_read_cpreg(env, regno, &value))
     {
-        unsigned memword;
+        qemu_log("FIESER: register 0x%x is not a coprocessor register of the CPU\n", regno);
+        return;
+    }
 
-        // Change the instruction pointed to by PC and replace with
-        // lockup instruction
-        cpu_memory_rw_debug(cpu, env->regs[15], (uint8_t *) & memword, instruction_length, 0);
-        saved_insn = memword;
-        memword = lockup_instruction;
+    arm_fies_write_cpreg(env, regno, do_inject_apply_mask(value, fi_info));
+}
 
-        cpu_memory_rw_debug(cpu, env->regs[15], (uint8_t *) & memword, instruction_length, 1);
-        saved_pc = env->regs[15];
-        saved_length = instruction_length;
+/**
+ * Injects a fault into the content of a specified general-purpose register,
+ * the CPSR-register (the PSTATE in AArch64 state, the xPSR of M-profile
+ * CPUs), a register of the floating-point and SIMD register file, a banked
+ * register, an M-profile stack pointer or a coprocessor register.
+ *
+ * @param[in] env - Reference to the information of the CPU state.
+ * @param[in] addr - containing the register number (0-15 for general-purpose
+ *                                  register r0 to r15 and cpsr-register otherwise,
+ *                                  0-31 for x0 to x30 and SP in AArch64 state,
+ *                                  see FI_REG_VFP_S0 for the FP/SIMD registers,
+ *                                  FI_REG_BANKED_SP for the banked registers,
+ *                                  FI_REG_M_MSP for the M-profile stack pointers
+ *                                  and FI_REG_CP for the coprocessor registers).
+ * @param[in] fi_info - information for performing faults.
+ */
+static void do_inject_register_arm(CPUARMState *env, hwaddr *addr,
+                                   FaultInjectionInfo fi_info)
+{
+    int register_num = (int) *addr;
+
+    if (register_num >= FI_REG_CP)
+    {
+        do_inject_cp_register_arm(env, register_num, fi_info);
+    }
+    else if (do_inject_is_banked_register(register_num))
+    {
+        do_inject_write_banked_register(env, register_num,
+                                        do_inject_apply_mask(do_inject_read_banked_register(env, register_num),
+                                                             fi_info));
     }
+    else if (do_inject_is_m_sp_register(register_num))
+    {
+        do_inject_write_m_sp_register(env, register_num,
+                                      do_inject_apply_mask(do_inject_read_m_sp_register(env, register_num),
+                                                           fi_info));
+    }
+    else if (register_num >= FI_REG_VFP_S0)
+    {
+        if (do_inject_is_vfp_register(register_num))
+            do_inject_vfp_register_arm(env, register_num, fi_info);
+    }
+    else if (is_a64(env))
+    {
+        if (register_num < 32)
+            env->xregs[register_num] = do_inject_apply_mask(env->xregs[register_num], fi_info);
+        else
+            pstate_write(env, do_inject_apply_mask(pstate_read(env), fi_info));
+    }
+    else if (register_num < 16)
+        env->regs[register_num] = do_inject_apply_mask(env->regs[register_num], fi_info);
+    else if (arm_feature(env, ARM_FEATURE_M))
+        xpsr_write(env, do_inject_apply_mask(xpsr_read(env), fi_info), 0xFFFFFFFF);
     else
+        cpsr_write(env, do_inject_apply_mask(cpsr_read(env), fi_info), 0xFFFFFFFF, CPSRWriteRaw);
+}
+
+/**
+ * Checks if the CPU implements an AArch32 mode, i.e. if the mode can be
+ * written to the M field of the CPSR.
+ *
+ * @param[in] env - Reference to the information of the CPU state.
+ * @param[in] mode - the value of the M field.
+ * @param[out] - true if the mode is implemented.
+ */
+static bool do_inject_valid_mode(CPUARMState *env, uint32_t mode)
+{
+    switch (mode)
     {
-        // Restore PC for second hook after arm_post_translate_insn in thumb/arm_tr_translate_insn
-        if (env->regs[15] != saved_pc)
-        {
-            cpu_memory_rw_debug(cpu, saved_pc, (uint8_t *) & saved_insn, saved_length, 1);
-            saved_insn = 0;
-        }
+    case ARM_CPU_MODE_USR:
+    case ARM_CPU_MODE_SYS:
+    case ARM_CPU_MODE_SVC:
+    case ARM_CPU_MODE_ABT:
+    case ARM_CPU_MODE_UND:
+    case ARM_CPU_MODE_IRQ:
+    case ARM_CPU_MODE_FIQ:
+        return true;
+    case ARM_CPU_MODE_HYP:
+        return arm_feature(env, ARM_FEATURE_EL2);
+    case ARM_CPU_MODE_MON:
+        return arm_feature(env, ARM_FEATURE_EL3);
+    default:
+        return false;
     }
 }
 
 /**
- * Calls the appropriate function for the used CPU-model.
+ * Writes a field of the xPSR of an M-profile CPU, which is not a condition
+ * flag. Only GE, IT, T and the exception number (IPSR) exist. A fault in
+ * the IPSR switches between Thread and Handler mode and thus the stack
+ * pointer, like the exception entry and return of the hardware.
  *
  * @param[in] env - Reference to the information of the CPU state.
- * @param[in] lockup_instruction - the PC-value for the new instruction.
+ * @param[in] fault_mode - the field of the xPSR.
+ * @param[in] value - the new value of the field.
  */
-void do_inject_look_up_error(CPUArchState *env, unsigned lockup_instruction, int injection_length)
+static void do_inject_xpsr_field_arm(CPUARMState *env,
+                                     enum FaultMode fault_mode,
+                                     uint32_t value)
 {
-#if defined(TARGET_ARM)
-    do_inject_look_up_error_arm(env, lockup_instruction, injection_length);
+    switch (fault_mode)
+    {
+    case FI_MODE_CPSR_GE:
+        env->GE = value & 0xf;
+        break;
+    case FI_MODE_CPSR_IT:
+        xpsr_write(env, ((value & 0x3) << 25) | ((value & 0xfc) << 8), XPSR_IT);
+        break;
+    case FI_MODE_CPSR_T:
+        xpsr_write(env, value ? XPSR_T : 0, XPSR_T);
+        break;
+    case FI_MODE_XPSR_IPSR:
+#if !defined(CONFIG_USER_ONLY)
+        write_v7m_exception(env, value & XPSR_EXCP);
+#endif
+        break;
+    default:
+        qemu_log("FIESER: %s does not exist in the xPSR, fault not injected\n",
+                 FaultMode2STR(fault_mode));
+    }
+}
+
+/**
+ * Writes a field of the CPSR, which is not a condition flag. IT is split
+ * into IT[1:0] (bits 26:25) and IT[7:2] (bits 15:10) of the CPSR. A fault
+ * in the M field switches the banked registers to the new mode, like the
+ * mode change of the hardware. In AArch64 state only the A, I and F bits
+ * of the PSTATE exist and are written.
+ *
+ * @param[in] env - Reference to the information of the CPU state.
+ * @param[in] fault_mode - the field of the CPSR.
+ * @param[in] value - the new value of the field.
+ */
+static void do_inject_cpsr_field_arm(CPUARMState *env,
+                                     enum FaultMode fault_mode,
+                                     uint32_t value)
+{
+    uint32_t mask, val;
+
+    if (arm_feature(env, ARM_FEATURE_M))
+    {
+        do_inject_xpsr_field_arm(env, fault_mode, value);
+        return;
+    }
+
+    switch (fault_mode)
+    {
+    case FI_MODE_CPSR_GE:
+        mask = CPSR_GE;
+        val = value << 16;
+        break;
+    case FI_MODE_CPSR_IT:
+        mask = CPSR_IT;
+        val = ((value & 0x3) << 25) | ((value & 0xfc) << 8);
+        break;
+    case FI_MODE_CPSR_J:
+        mask = CPSR_J;
+        val = value ? mask : 0;
+        break;
+    case FI_MODE_CPSR_E:
+        mask = CPSR_E;
+        val = value ? mask : 0;
+        break;
+    case FI_MODE_CPSR_A:
+        mask = CPSR_A;
+        val = value ? mask : 0;
+        break;
+    case FI_MODE_CPSR_I:
+        mask = CPSR_I;
+        val = value ? mask : 0;
+        break;
+    case FI_MODE_CPSR_F:
+        mask = CPSR_F;
+        val = value ? mask : 0;
+        break;
+    case FI_MODE_CPSR_T:
+        mask = CPSR_T;
+        val = value ? mask : 0;
+        break;
+    case FI_MODE_CPSR_M:
+        mask = CPSR_M;
+        val = value & mask;
+        break;
+    default:
+        return;
+    }
+
+    if (is_a64(env))
+    {
+        if (mask & CPSR_AIF)
+            pstate_write(env, (pstate_read(env) & ~mask) | val);
+        return;
+    }
+
+    if (mask == CPSR_M)
+    {
+#if defined(CONFIG_USER_ONLY)
+        return;
 #else
-#error unsupported target CPU
+        if (!do_inject_valid_mode(env, val))
+        {
+            qemu_log("FIESER: mode 0x%x is not implemented by the CPU, CPSR M fault not injected\n", val);
+            return;
+        }
+        switch_mode(env, val);
 #endif
+    }
+
+    cpsr_write(env, val, mask, CPSRWriteRaw);
 }
 
 /**
- * Sets or resets the value of a specified condition flag.
+ * Sets or resets the value of a specified condition flag. The flags are
+ * written in the representation of CPUARMState, which is shared by the
+ * CPSR and the NZCV bits of the PSTATE, so this works in both states.
+ * The other fields of the CPSR are set to new_flag_value.
  *
  * @param[in] env - Reference to the information of the CPU state.
  * @param[in] src_flag_name - the name of the condition flag on which a
@@ -200,53 +516,39 @@ static void do_inject_condition_flags_arm(CPUARMState *env,
                                           enum FaultMode fault_mode,
                                           int new_flag_value)
 {
+    if (fault_mode >= FI_MODE_CPSR_GE)
+    {
+        do_inject_cpsr_field_arm(env, fault_mode, new_flag_value);
+        return;
+    }
+
     if (new_flag_value != 0 && new_flag_value != 1)
         return;
 
     if (fault_mode == FI_MODE_CPSR_CF)
     {
-        /* Carry flag */
-        //env->CF = new_flag_value;
-        if (new_flag_value)
-            cpsr_write(env, (1 << 29), (1 << 29), CPSRWriteRaw);
-        else
-            cpsr_write(env, 0, (1 << 29), CPSRWriteRaw);
+        /* Carry flag (bit 29) */
+        env->CF = new_flag_value;
     }
     else if (fault_mode == FI_MODE_CPSR_NF)
     {
-        /* Negative or Less than */
-        //env->NF = new_flag_value;
-        if (new_flag_value)
-            cpsr_write(env, (1 << 29), (1 << 29), CPSRWriteRaw);
-        else
-            cpsr_write(env, 0, (1 << 29), CPSRWriteRaw);
+        /* Negative or Less than (bit 31) */
+        env->NF = new_flag_value ? 0x80000000 : 0;
     }
     else if (fault_mode == FI_MODE_CPSR_QF)
     {
-        /* Sticky overflow */
-        //env->QF = new_flag_value;
-        if (new_flag_value)
-            cpsr_write(env, (1 << 27), (1 << 27), CPSRWriteRaw);
-        else
-            cpsr_write(env, 0, (1 << 27), CPSRWriteRaw);
+        /* Sticky overflow (bit 27, AArch32 only) */
+        env->QF = new_flag_value;
     }
     else if (fault_mode == FI_MODE_CPSR_VF)
     {
-        /* Overflow */
-        //env->VF = new_flag_value;
-        if (new_flag_value)
-            cpsr_write(env, (1 << 28), (1 << 28), CPSRWriteRaw);
-        else
-            cpsr_write(env, 0, (1 << 28), CPSRWriteRaw);
+        /* Overflow (bit 28) */
+        env->VF = new_flag_value ? 0x80000000 : 0;
     }
     else if (fault_mode == FI_MODE_CPSR_ZF)
     {
-        /* Zero flag */
-        //env->ZF = new_flag_value;
-        if (new_flag_value)
-            cpsr_write(env, (1 << 30), (1 << 30), CPSRWriteRaw);
-        else
-            cpsr_write(env, 0, (1 << 30), CPSRWriteRaw);
+        /* Zero flag (bit 30), set if ZF is zero */
+        env->ZF = !new_flag_value;
     }
     else
     {
@@ -301,159 +603,314 @@ void do_inject_insn(unsigned int *orig_insn,
 #endif
 }
 
+#if defined(CONFIG_USER_ONLY)
 /**
- * Performs a bit-flip on the specified address or buffer value at a specified bit-
- * position.
+ * Resolves the guest address of memory cells to their host pointer in user
+ * mode, where the guest memory is mapped into the address space of QEMU.
+ * Pages write-protected because they hold translated code are unprotected,
+ * which invalidates their TBs. Read-only mappings are not injected.
  *
- * @param[in] value - the address or the buffer, where the fault is injected.
- * @param[in] injected_bit - the position of the affected bit.
+ * @param[in] cpu - the CPU, whose MMU translates the address.
+ * @param[in] inject_address - the address of the memory cell, where
+ *                                             the fault should be injected.
+ * @param[in] len - the number of bytes, which are injected.
+ * @param[out] mr - unused in user mode.
+ * @param[out] xlat - unused in user mode.
+ * @param[out] the host pointer or NULL, if the cells are not (entirely) mapped writable.
  */
-static void do_inject_memory_buffer_arm_bf(hwaddr *value,
-                                           int injected_bit)
+static uint8_t *do_inject_memory_host_ptr(CPUState *cpu, hwaddr inject_address, hwaddr len,
+                                          MemoryRegion **mr, hwaddr *xlat)
 {
-    if ((*value >> injected_bit) & 0x1)
-        *value &= ~(1 << injected_bit);
-    else
-        *value |= (1 << injected_bit);
+    *mr = NULL;
+    *xlat = 0;
+
+    if (page_check_range(inject_address, len, PAGE_WRITE) < 0)
+        return NULL;
+
+    return g2h(inject_address);
 }
 
 /**
- * Performs a set or reset on the specified address or buffer value at a specified bit-
- * position.
- *
- * @param[in] value - the address or the buffer, where the fault is injected.
- * @param[in] fi_info - information for performing faults.
+ * Nothing to track in user mode, translated code on the modified pages was
+ * invalidated by do_inject_memory_host_ptr.
  */
-static void do_inject_memory_buffer_arm_rs(hwaddr *value,
-                                           FaultInjectionInfo fi_info)
+static void do_inject_memory_set_dirty(MemoryRegion *mr, hwaddr xlat, hwaddr len)
 {
-    if (fi_info.bit_value)
-        *value |= (1 << fi_info.injected_bit);
-    else
-        *value &= ~(1 << fi_info.injected_bit);
 }
-
+#else
 /**
- * Writes a new value to a specified address or buffer value.
+ * Resolves the guest address of memory cells to the host pointer of the
+ * RAM backing them, so that a fault is injected with a single read-modify-write.
+ * Has to be called within an RCU critical section.
  *
- * @param[in] orig_value - the address or the buffer, where the fault is injected.
- * @param[in] fi_info - information for performing faults.
+ * @param[in] cpu - the CPU, whose MMU translates the address.
+ * @param[in] inject_address - the address of the memory cell, where
+ *                                             the fault should be injected.
+ * @param[in] len - the number of bytes, which are injected.
+ * @param[out] mr - the memory region holding the memory cells.
+ * @param[out] xlat - the offset of the memory cells in mr.
+ * @param[out] the host pointer or NULL, if the cells are not (entirely) backed by RAM or ROM.
  */
-static void do_inject_new_memory_value_buffer_arm(hwaddr *orig_value,
-                                                  FaultInjectionInfo fi_info)
+static uint8_t *do_inject_memory_host_ptr(CPUState *cpu, hwaddr inject_address, hwaddr len,
+                                          MemoryRegion **mr, hwaddr *xlat)
 {
-    *orig_value = fi_info.bit_value;
+    hwaddr phys, l = len;
+    MemTxAttrs attrs;
+    int asidx;
+
+    /**
+     * a burst crossing a page may continue in another physical page
+     */
+    if ((inject_address & ~TARGET_PAGE_MASK) + len > TARGET_PAGE_SIZE)
+        return NULL;
+
+    phys = cpu_get_phys_page_attrs_debug(cpu, inject_address & TARGET_PAGE_MASK, &attrs);
+    if (phys == -1)
+        return NULL;
+
+    phys += inject_address & ~TARGET_PAGE_MASK;
+    asidx = cpu_asidx_from_attrs(cpu, attrs);
+    *mr = address_space_translate(cpu_get_address_space(cpu, asidx), phys, xlat, &l, true);
+
+    /**
+     * like cpu_memory_rw_debug, faults may also be injected into ROMs
+     */
+    if (l < len || !(memory_region_is_ram(*mr) || memory_region_is_romd(*mr)))
+        return NULL;
+
+    return qemu_map_ram_ptr((*mr)->ram_block, *xlat);
 }
 
 /**
- * Performs a bit-flip on the memory content of a specified address.
+ * Marks modified memory cells dirty for migration and display and
+ * invalidates translated code, if their page holds any.
  *
- * @param[in] env - Reference to the information of the CPU state.
- * @param[in] inject_address - the address of the memory cell, where
- *                                             the fault should be injected.
- * @param[in] injected_bit - the position of the affected bit.
+ * @param[in] mr - the memory region holding the memory cells.
+ * @param[in] xlat - the offset of the memory cells in mr.
+ * @param[in] len - the number of modified bytes.
  */
-static void do_inject_memory_arm_bf(CPUARMState *env, hwaddr inject_address,
-                                    int injected_bit)
+static void do_inject_memory_set_dirty(MemoryRegion *mr, hwaddr xlat, hwaddr len)
 {
-    CPUState *cpu = ENV_GET_CPU(env);
-
-    unsigned memword;
-    uint8_t *membytes = (uint8_t *) & memword;
+    ram_addr_t addr = memory_region_get_ram_addr(mr) + xlat;
+    uint8_t dirty_log_mask = memory_region_get_dirty_log_mask(mr);
 
-    // Read memory
-    cpu_memory_rw_debug(cpu, inject_address, membytes, (MEMORY_WIDTH / 8), 0);
+    if (dirty_log_mask)
+        dirty_log_mask = cpu_physical_memory_range_includes_clean(addr, len, dirty_log_mask);
 
-    // Flip bit and write back
-    if ((memword >> injected_bit) & 0x1)
+    /**
+     * the code dirty bit is clean only for pages TCG translated code from
+     */
+    if (dirty_log_mask & (1 << DIRTY_MEMORY_CODE))
     {
-        memword &= ~(1 << injected_bit);
-        cpu_memory_rw_debug(cpu, inject_address, membytes, (MEMORY_WIDTH / 8), 1);
+        tb_lock();
+        tb_invalidate_phys_range(addr, addr + len);
+        tb_unlock();
+        dirty_log_mask &= ~(1 << DIRTY_MEMORY_CODE);
     }
-    else
+
+    cpu_physical_memory_set_dirty_range(addr, len, dirty_log_mask);
+}
+#endif
+
+/**
+ * Reads a memory cell of the given width in host byte order.
+ *
+ * @param[in] ptr - the host pointer of the memory cell.
+ * @param[in] size - the width of the memory cell in bytes.
+ * @param[out] - the content of the memory cell.
+ */
+uint64_t do_inject_memory_load(const uint8_t *ptr, unsigned size)
+{
+    switch (size)
     {
-        memword |= (1 << injected_bit);
-        cpu_memory_rw_debug(cpu, inject_address, membytes, (MEMORY_WIDTH / 8), 1);
+    case 1:
+        return ldub_p(ptr);
+    case 2:
+        return lduw_he_p(ptr);
+    case 4:
+        return (uint32_t) ldl_he_p(ptr);
+    default:
+        return ldq_he_p(ptr);
     }
 }
 
 /**
- * Performs a set or reset on the content of a specified memory address.
+ * Writes a memory cell of the given width in host byte order.
  *
- * @param[in] env - Reference to the information of the CPU state.
- * @param[in] inject_address - the address of the memory cell, where
- *                                             the fault should be injected.
- * @param[in] injected_bit - the position of the affected bit.
+ * @param[in] ptr - the host pointer of the memory cell.
+ * @param[in] size - the width of the memory cell in bytes.
+ * @param[in] value - the new content of the memory cell.
  */
-static void do_inject_memory_arm_rs(CPUARMState *env, hwaddr inject_address,
-                                    FaultInjectionInfo fi_info)
+void do_inject_memory_store(uint8_t *ptr, unsigned size, uint64_t value)
 {
-    CPUState *cpu = ENV_GET_CPU(env);
-
-    unsigned memword;
-    uint8_t *membytes = (uint8_t *) & memword;
-
-    // Read memory
-    cpu_memory_rw_debug(cpu, inject_address, membytes, (MEMORY_WIDTH / 8), 0);
-
-    if (fi_info.bit_value)
-        memword |= (1 << fi_info.injected_bit);
-    else
-        memword &= ~(1 << fi_info.injected_bit);
-
-    cpu_memory_rw_debug(cpu, inject_address, membytes, (MEMORY_WIDTH / 8), 1);
+    switch (size)
+    {
+    case 1:
+        stb_p(ptr, value);
+        break;
+    case 2:
+        stw_he_p(ptr, value);
+        break;
+    case 4:
+        stl_he_p(ptr, value);
+        break;
+    default:
+        stq_he_p(ptr, value);
+        break;
+    }
 }
 
 /**
- * Writes a new value to the content of a specified memory address.
+ * Applies the upset masks of a row of memory cells to a range of rows, as a
+ * single pass of byte operations over the range, which the compiler can
+ * vectorize.
  *
- * @param[in] env - Reference to the information of the CPU state.
- * @param[in] inject_address - the address of the memory cell, where
- *                                             the fault should be injected.
- * @param[in] injected_bit - the position of the affected bit.
+ * @param[in,out] ptr - the first row.
+ * @param[in] len - the length of the range in bytes.
+ * @param[in] row - the length of a row in bytes.
+ * @param[in] mask - the upset bits of a row.
+ * @param[in] bits - the stuck values of the upset bits for State Faults.
+ * @param[in] bit_flip - if the upset bits are flipped instead of stuck.
  */
-static void do_inject_new_memory_value_arm(CPUARMState *env, hwaddr inject_address,
-                                           FaultInjectionInfo fi_info)
+static void do_inject_memory_rows(uint8_t *ptr, hwaddr len, unsigned row,
+                                  const uint8_t *mask, const uint8_t *bits,
+                                  bool bit_flip)
 {
-    CPUState *cpu = ENV_GET_CPU(env);
-    uint8_t *membytes = (uint8_t *) & fi_info.bit_value;
+    hwaddr i;
+    unsigned j;
 
-    cpu_memory_rw_debug(cpu, inject_address, membytes, (MEMORY_WIDTH / 8), 1);
+    for (i = 0; i < len; i += row, ptr += row)
+    {
+        if (bit_flip)
+        {
+            for (j = 0; j < row; j++)
+                ptr[j] ^= mask[j];
+        }
+        else
+        {
+            for (j = 0; j < row; j++)
+                ptr[j] = (ptr[j] & ~mask[j]) | bits[j];
+        }
+    }
 }
 
 /**
- * Decides, based on the information held by fi_info, which function should be called.
+ * Injects a multi-cell upset into a bit-interleaved memory array, starting at
+ * the row of the specified address. A row holds fi_info.interleave cells side
+ * by side, physical column c of a row holding bit c / fi_info.interleave of
+ * cell c % fi_info.interleave. The mask selects the upset columns, starting
+ * at fi_info.column, which are upset in fi_info.burst consecutive rows, so a
+ * cluster of physically adjacent bits hits several neighbouring cells.
  *
- * @param[in] addr - containing the memory address.
+ * The masks of the cells of a row are computed once. The rows are modified
+ * like a burst (see do_inject_memory_cell_arm), by a single read-modify-write
+ * over the whole range in host RAM.
+ *
+ * @param[in] env - Reference to the information of the CPU state.
+ * @param[in] inject_address - the address of the first cell of the first row.
  * @param[in] fi_info - information for performing faults.
  */
-static void do_inject_memory_buffer_arm(hwaddr *addr,
-                                        FaultInjectionInfo fi_info)
+static void do_inject_memory_cluster_arm(CPUARMState *env, hwaddr inject_address,
+                                         FaultInjectionInfo fi_info)
 {
-    if (fi_info.bit_flip)
-        do_inject_memory_buffer_arm_bf(addr, fi_info.injected_bit);
-    else if (!fi_info.bit_flip && !fi_info.new_value)
-        do_inject_memory_buffer_arm_rs(addr, fi_info);
-    else if (!fi_info.bit_flip && fi_info.new_value)
-        do_inject_new_memory_value_buffer_arm(addr, fi_info);
+    CPUState *cpu = ENV_GET_CPU(env);
+    unsigned size = fi_info.width / 8, k = MAX(fi_info.interleave, 1);
+    unsigned row = size * k, c, i;
+    hwaddr len = (hwaddr) row * fi_info.burst, xlat;
+    uint64_t cell_mask[MAX_INTERLEAVE] = { 0 }, cell_bits[MAX_INTERLEAVE] = { 0 };
+    uint8_t mask[MAX_INTERLEAVE * 8], bits[MAX_INTERLEAVE * 8], buf[MAX_INTERLEAVE * 8];
+    uint8_t *ptr;
+    MemoryRegion *mr;
+
+    for (i = 0; i < MAX_CELL_WIDTH; i++)
+    {
+        if (!(fi_info.mask & (1ULL << i)))
+            continue;
+
+        c = fi_info.column + i;
+        cell_mask[c % k] |= 1ULL << (c / k);
+        if (fi_info.bit_value & (1ULL << i))
+            cell_bits[c % k] |= 1ULL << (c / k);
+    }
+
+    for (i = 0; i < k; i++)
+    {
+        do_inject_memory_store(mask + i * size, size, cell_mask[i]);
+        do_inject_memory_store(bits + i * size, size, cell_bits[i]);
+    }
+
+    FIESER_ecc_prepare(cpu, inject_address, len);
+
+    rcu_read_lock();
+    ptr = do_inject_memory_host_ptr(cpu, inject_address, len, &mr, &xlat);
+
+    if (ptr)
+    {
+        do_inject_memory_rows(ptr, len, row, mask, bits, fi_info.bit_flip);
+        do_inject_memory_set_dirty(mr, xlat, len);
+    }
+    else
+    {
+        for (i = 0; i < fi_info.burst; i++, inject_address += row)
+        {
+            cpu_memory_rw_debug(cpu, inject_address, buf, row, 0);
+            do_inject_memory_rows(buf, row, row, mask, bits, fi_info.bit_flip);
+            cpu_memory_rw_debug(cpu, inject_address, buf, row, 1);
+        }
+    }
+    rcu_read_unlock();
 }
 
 /**
- * Decides, based on the information held by fi_info, which function should be called.
+ * Injects a fault into the content of a burst of memory cells, starting at the
+ * specified address. Each cell of the burst is injected with the whole mask in
+ * one operation (see do_inject_apply_mask).
+ *
+ * The cells are modified directly in host RAM; cells not backed by RAM (e.g.
+ * MMIO) and bursts crossing a page are modified through a single debug access
+ * per cell.
  *
  * @param[in] env - Reference to the information of the CPU state.
- * @param[in] addr - containing the memory address.
+ * @param[in] inject_address - the address of the memory cell, where
+ *                                             the fault should be injected.
  * @param[in] fi_info - information for performing faults.
  */
-static void do_inject_memory_arm(CPUARMState *env, hwaddr *addr,
-                                 FaultInjectionInfo fi_info)
+static void do_inject_memory_cell_arm(CPUARMState *env, hwaddr inject_address,
+                                      FaultInjectionInfo fi_info)
 {
-    if (fi_info.bit_flip)
-        do_inject_memory_arm_bf(env, *addr, fi_info.injected_bit);
-    else if (!fi_info.bit_flip && !fi_info.new_value)
-        do_inject_memory_arm_rs(env, *addr, fi_info);
-    else if (!fi_info.bit_flip && fi_info.new_value)
-        do_inject_new_memory_value_arm(env, *addr, fi_info);
+    CPUState *cpu = ENV_GET_CPU(env);
+    unsigned size = fi_info.width / 8, i;
+    hwaddr len = (hwaddr) size * fi_info.burst, xlat;
+    uint8_t buf[8], *ptr;
+    MemoryRegion *mr;
+
+    FIESER_ecc_prepare(cpu, inject_address, len);
+
+    rcu_read_lock();
+    ptr = do_inject_memory_host_ptr(cpu, inject_address, len, &mr, &xlat);
+
+    if (ptr)
+    {
+        for (i = 0; i < fi_info.burst; i++, ptr += size)
+            do_inject_memory_store(ptr, size,
+                                   do_inject_apply_mask(do_inject_memory_load(ptr, size), fi_info));
+
+        do_inject_memory_set_dirty(mr, xlat, len);
+    }
+    else
+    {
+        for (i = 0; i < fi_info.burst; i++, inject_address += size)
+        {
+            memset(buf, 0, sizeof(buf));
+            if (!fi_info.new_value)
+                cpu_memory_rw_debug(cpu, inject_address, buf, size, 0);
+
+            do_inject_memory_store(buf, size,
+                                   do_inject_apply_mask(do_inject_memory_load(buf, size), fi_info));
+            cpu_memory_rw_debug(cpu, inject_address, buf, size, 1);
+        }
+    }
+    rcu_read_unlock();
 }
 
 /**
@@ -469,20 +926,14 @@ void do_inject_memory_register(CPUArchState *env, hwaddr *addr,
                                FaultInjectionInfo fi_info)
 {
 #if defined(TARGET_ARM)
-    if (fi_info.fault_on_register)
-    {
-        if (fi_info.fault_on_address || fi_info.access_triggered_content_fault)
-            do_inject_memory_buffer_arm(addr, fi_info);
-        else
-            do_inject_register_arm(env, addr, fi_info);
-    }
+    if (fi_info.fault_on_address || fi_info.access_triggered_content_fault)
+        *addr = do_inject_apply_mask(*addr, fi_info);
+    else if (fi_info.fault_on_register)
+        do_inject_register_arm(env, addr, fi_info);
+    else if (fi_info.interleave > 1 || fi_info.column)
+        do_inject_memory_cluster_arm(env, *addr, fi_info);
     else
-    {
-        if (fi_info.fault_on_address || fi_info.access_triggered_content_fault)
-            do_inject_memory_buffer_arm(addr, fi_info);
-        else
-            do_inject_memory_arm(env, addr, fi_info);
-    }
+        do_inject_memory_cell_arm(env, *addr, fi_info);
 #else
 #error unsupported target CPU
 #endif
@@ -51,11 +51,12 @@ typedef struct {
     uint32_t fault_on_register;
 
     /**
-     * Defines the bit, on which a fault should be injected
+     * Defines the bits, on which a fault should be injected
      * (e.g. 0x1 defines the first bit, 0x2 defines the second
-     * bit and 0x3 defines the first two bits and so on)
+     * bit and 0x3 defines the first two bits and so on).
+     * All bits are injected in a single operation.
      */
-    uint32_t injected_bit;
+    uint64_t mask;
 
     /**
      * Defines, if a bit-flip is performed as fault injection
@@ -63,25 +64,50 @@ typedef struct {
     uint32_t bit_flip;
 
     /**
-     * Defines, if the bit should been reset or set for
-     * the State Faults (SFs) or contains the new value
-     * which should be written to the target.
+     * Defines, if the bits of the mask should been reset
+     * or set for the State Faults (SFs) or contains the new
+     * value which should be written to the target.
      */
-    uint32_t bit_value;
+    uint64_t bit_value;
 
     /**
      * Defines, if a new value should been written to
      * the specified target.
      */
     uint32_t new_value;
+
+    /**
+     * The width of an injected memory cell in bits and the
+     * number of consecutive cells injected at once (burst).
+     */
+    uint32_t width;
+    uint32_t burst;
+
+    /**
+     * The bit interleaving factor of the memory array and the
+     * physical column of the first bit of the mask, for
+     * multi-cell upsets. The burst is a number of rows then.
+     */
+    uint32_t interleave;
+    uint32_t column;
 } FaultInjectionInfo;
 
 /**
  * see corresponding c-file for documentation
  */
-void do_inject_look_up_error(CPUArchState *env, unsigned lockup_instruction, int injection_length);
 void do_inject_condition_flags(CPUARMState *env, enum FaultMode fault_mode, int new_flag_value);
 void do_inject_insn(unsigned int *orig_insn, unsigned int repl_insn);
 void do_inject_memory_register(CPUArchState *env, hwaddr *addr, FaultInjectionInfo fi_info);
+uint64_t do_inject_memory_load(const uint8_t *ptr, unsigned size);
+void do_inject_memory_store(uint8_t *ptr, unsigned size, uint64_t value);
+bool do_inject_is_vfp_register(int regno);
+uint64_t do_inject_read_vfp_register(CPUARMState *env, int regno);
+void do_inject_write_vfp_register(CPUARMState *env, int regno, uint64_t value);
+bool do_inject_is_banked_register(int regno);
+uint64_t do_inject_read_banked_register(CPUARMState *env, int regno);
+void do_inject_write_banked_register(CPUARMState *env, int regno, uint64_t value);
+bool do_inject_is_m_sp_register(int regno);
+uint64_t do_inject_read_m_sp_register(CPUARMState *env, int regno);
+void do_inject_write_m_sp_register(CPUARMState *env, int regno, uint64_t value);
 
 #endif /* FAULT_INJECTION_INJECTOR_H_ */
@@ -0,0 +1,284 @@
+/*
+ * fault-injection-irq.c
+ *
+ *  FIESer by Christian M. Fuchs 2017/2018
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+#include "qemu/log.h"
+#include "qemu/timer.h"
+#include "cpu.h"
+
+#include "fault-injection-irq.h"
+#include "fault-injection-library.h"
+#include "fault-injection-controller.h"
+#include "fault-injection-data-analyzer.h"
+#include "trace-root.h"
+
+#if !defined(CONFIG_USER_ONLY)
+#include "qom/object.h"
+
+/**
+ * An input line of a device, which is faulted by IRQ faults. The line is
+ * intercepted, so that the levels set by the source pass the interposer,
+ * and the device only sees the levels, which are delivered to the original
+ * handler. drop and delay are the state of the active faults of the line,
+ * they are updated at the activation edges of the faults.
+ */
+typedef struct {
+    qemu_irq irq;
+    qemu_irq orig;
+    QEMUTimer *delay_timer;
+    GPtrArray *faults;
+    int level;
+    int delivered;
+    bool drop;
+    int64_t delay;
+} FIESIrqLine;
+
+/**
+ * The intercepted lines, by their qemu_irq and by their faults.
+ */
+static GHashTable *fies_irq_lines;
+static GHashTable *fies_irq_faults;
+
+/**
+ * Delivers a level to the device.
+ *
+ * @param[in] line - the faulted line.
+ * @param[in] level - the level.
+ */
+static void FIESER_irq_deliver(FIESIrqLine *line, int level)
+{
+    line->delivered = level;
+    qemu_set_irq(line->orig, level);
+}
+
+/**
+ * Receives the levels set by the source of a faulted line. While a DROPPED
+ * fault is active, assertions are not delivered, while a DELAYED fault is
+ * active, they are delivered after its delay. A deassertion during the delay
+ * is delivered right after the delayed assertion.
+ */
+static void FIESER_irq_handler(void *opaque, int n, int level)
+{
+    FIESIrqLine *line = opaque;
+
+    line->level = level;
+
+    if (timer_pending(line->delay_timer))
+        return;
+
+    if (level && !line->delivered)
+    {
+        if (line->drop)
+        {
+            trace_fies_irq_level(n, level, line->delivered);
+            return;
+        }
+
+        if (line->delay)
+        {
+            timer_mod(line->delay_timer,
+                      qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL) + line->delay);
+            return;
+        }
+    }
+
+    FIESER_irq_deliver(line, level);
+}
+
+/**
+ * Delivers a delayed assertion and the level the source set meanwhile.
+ *
+ * @param[in] opaque - the faulted line.
+ */
+static void FIESER_irq_delayed(void *opaque)
+{
+    FIESIrqLine *line = opaque;
+
+    FIESER_irq_deliver(line, 1);
+
+    if (!line->level)
+        FIESER_irq_deliver(line, 0);
+}
+
+/**
+ * Returns an unnamed GPIO input line of a device.
+ *
+ * @param[in] device - the QOM path of the device or NULL for the NVIC of
+ *                     M-profile CPUs.
+ * @param[in] n - the number of the input line.
+ * @param[out] - the line or NULL, if there is no such line.
+ */
+qemu_irq FIESER_irq_input(const char *device, int n)
+{
+    Object *dev = NULL, *obj = NULL;
+    char *name;
+
+    if (device)
+        dev = object_resolve_path(device, NULL);
+    else if (first_cpu && arm_feature(&ARM_CPU(first_cpu)->env, ARM_FEATURE_M))
+        dev = OBJECT(ARM_CPU(first_cpu)->env.nvic);
+
+    if (dev)
+    {
+        name = g_strdup_printf("unnamed-gpio-in[%d]", n);
+        obj = object_resolve_path_component(dev, name);
+        g_free(name);
+    }
+
+    obj = obj ? object_dynamic_cast(obj, TYPE_IRQ) : NULL;
+    return (qemu_irq) obj;
+}
+
+/**
+ * Returns the input line of a device, which is selected by an IRQ fault:
+ * the line <address> of the unnamed GPIO inputs of the device at the QOM
+ * path <device>, or of the NVIC of M-profile CPUs.
+ *
+ * @param[in] fault - pointer to the linked list entry.
+ * @param[out] - the line or NULL, if there is no such line.
+ */
+static qemu_irq FIESER_irq_resolve(FaultList *fault)
+{
+    qemu_irq irq = FIESER_irq_input(fault->params.device_defined ? fault->params.device : NULL,
+                                    fault->params.address);
+
+    if (!irq)
+        qemu_log("FIESER: fault %d: no input line %d of device %s\n",
+                 fault->id, fault->params.address,
+                 fault->params.device_defined ? fault->params.device : "NVIC");
+
+    return irq;
+}
+
+/**
+ * Removes the interception of a line and delivers the level of its source.
+ */
+static void FIESER_irq_remove(gpointer data)
+{
+    FIESIrqLine *line = data;
+
+    timer_del(line->delay_timer);
+    timer_free(line->delay_timer);
+    qemu_irq_fies_restore(line->irq, line->orig);
+
+    if (line->level != line->delivered)
+        qemu_set_irq(line->irq, line->level);
+
+    g_ptr_array_free(line->faults, true);
+    g_free(line);
+}
+
+/**
+ * Intercepts the lines of all IRQ faults and removes the interception of
+ * all other lines. Has to be called with the BQL held, whenever the fault
+ * list is (re)loaded.
+ */
+void FIESER_irq_build(void)
+{
+    FIESIrqLine *line;
+    FaultList *fault;
+    qemu_irq irq;
+    int element;
+
+    if (!fies_irq_lines)
+    {
+        fies_irq_lines = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+                                               NULL, FIESER_irq_remove);
+        fies_irq_faults = g_hash_table_new(g_direct_hash, g_direct_equal);
+    }
+
+    g_hash_table_remove_all(fies_irq_faults);
+    g_hash_table_remove_all(fies_irq_lines);
+
+    for (element = 0; element < getNumFaultListElements(); element++)
+    {
+        fault = getFaultListElement(element);
+
+        if (fault->component != FI_COMP_IRQ || !(irq = FIESER_irq_resolve(fault)))
+            continue;
+
+        line = g_hash_table_lookup(fies_irq_lines, irq);
+        if (!line)
+        {
+            line = g_new0(FIESIrqLine, 1);
+            line->irq = irq;
+            line->orig = qemu_irq_fies_intercept(irq, FIESER_irq_handler, line);
+            line->delay_timer = timer_new_ns(QEMU_CLOCK_VIRTUAL,
+                                             FIESER_irq_delayed, line);
+            line->faults = g_ptr_array_new();
+            g_hash_table_insert(fies_irq_lines, irq, line);
+        }
+
+        g_ptr_array_add(line->faults, fault);
+        g_hash_table_insert(fies_irq_faults, fault, line);
+    }
+}
+
+/**
+ * Updates the state of a faulted line at an activation edge of one of its
+ * faults. A SPURIOUS fault pulses the line at its rising edge.
+ *
+ * @param[in] fault - pointer to the linked list entry.
+ * @param[in] active - if the fault became active or inactive.
+ */
+void FIESER_irq_scheduled(FaultList *fault, bool active)
+{
+    FIESIrqLine *line = fies_irq_faults ? g_hash_table_lookup(fies_irq_faults, fault) : NULL;
+    FaultList *other;
+    int i;
+
+    if (!line)
+        return;
+
+    line->drop = false;
+    line->delay = 0;
+
+    for (i = 0; i < line->faults->len; i++)
+    {
+        other = g_ptr_array_index(line->faults, i);
+
+        if (!FIESER_fault_active(other))
+            continue;
+
+        if (other->mode == FI_MODE_IRQ_DROPPED)
+            line->drop = true;
+        else if (other->mode == FI_MODE_IRQ_DELAYED)
+            line->delay = MAX(line->delay, other->params.delay);
+    }
+
+    trace_fies_irq(fault->id, fault->params.address, fault->mode, active);
+
+    if (!active)
+        return;
+
+    incr_num_injected_faults(fault->id, FI_COMP_IRQ, fault->type);
+
+    if (fault->mode == FI_MODE_IRQ_SPURIOUS && !line->delivered)
+    {
+        FIESER_irq_deliver(line, 1);
+        FIESER_irq_deliver(line, 0);
+    }
+}
+#else
+qemu_irq FIESER_irq_input(const char *device, int n)
+{
+    return NULL;
+}
+
+void FIESER_irq_build(void)
+{
+}
+
+void FIESER_irq_scheduled(FaultList *fault, bool active)
+{
+}
+#endif
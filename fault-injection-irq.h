@@ -0,0 +1,29 @@
+/*
+ * fault-injection-irq.h
+ *
+ *  FIESer by Christian M. Fuchs 2017/2018
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#ifndef FAULT_INJECTION_IRQ_H_
+#define FAULT_INJECTION_IRQ_H_
+
+#include "qemu/osdep.h"
+
+#include "hw/irq.h"
+
+#include "fault-injection-infrastructure.h"
+
+/**
+ * see corresponding c-file for documentation
+ */
+qemu_irq FIESER_irq_input(const char *device, int n);
+void FIESER_irq_build(void);
+void FIESER_irq_scheduled(FaultList *fault, bool active);
+
+#endif /* FAULT_INJECTION_IRQ_H_ */
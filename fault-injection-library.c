@@ -13,6 +13,7 @@
 #include "qapi/error.h"
 #include "qemu/error-report.h"
 #include "qemu/cutils.h"
+#include "qemu/host-utils.h"
 #include "qemu-common.h"
 #include "qemu/config-file.h"
 #include "monitor/monitor.h"
@@ -22,6 +23,16 @@
 #include "fault-injection-controller.h"
 #include "fault-injection-data-analyzer.h"
 #include "fault-injection-profiler.h"
+#include "fault-injection-stats.h"
+#include "fault-injection-overhead.h"
+#include "fault-injection-index.h"
+#include "fault-injection-history.h"
+#include "fault-injection-scheduler.h"
+#include "fault-injection-peripheral.h"
+#include "fault-injection-irq.h"
+#include "fault-injection-ptimer.h"
+#include "fault-injection-ecc.h"
+#include "trace-root.h"
 
 #include <libxml/xmlreader.h>
 
@@ -38,6 +49,10 @@ static FaultList *curr = NULL;
  * stored entries in the linked list.
  */
 static int num_list_elements = 0;
+/**
+ * Set while a loaded fault library is being injected
+ */
+static bool experiment_running;
 
 #include "fault-injection-enums2string.h"
 
@@ -66,6 +81,16 @@ const char * FaultType2STR(enum FaultType which)
     return FaultType_STR[which];
 }
 
+const char * InjectionMode2STR(InjectionMode which)
+{
+    return InjectionMode_STR[which];
+}
+
+const char * FIESCallSite2STR(FIESCallSite which)
+{
+    return FIESCallSite_STR[which];
+}
+
 /**
  * Allocates the size for a new entry in the linked list and parses the elements to it.
  *
@@ -125,9 +150,13 @@ static void print_fault_list(void)
         printf("interval [%s] \n", ptr->interval);
         printf("params.address [%x] \n", ptr->params.address);
         printf("params.cf_address [%x] \n", ptr->params.cf_address);
-        printf("params.mask [%x] \n", ptr->params.mask);
+        printf("params.mask [%" PRIx64 "] \n", ptr->params.mask);
         printf("params.instruction [%x] \n", ptr->params.instruction);
-        printf("params.set_bit [%x] \n", ptr->params.set_bit);
+        printf("params.set_bit [%" PRIx64 "] \n", ptr->params.set_bit);
+        printf("params.width [%d] \n", ptr->params.width);
+        printf("params.burst [%d] \n", ptr->params.burst);
+        printf("params.interleave [%d] \n", ptr->params.interleave);
+        printf("params.column [%d] \n", ptr->params.column);
         printf("is_active [%d] \n", ptr->is_active);
         ptr = ptr->next;
         printf("\n");
@@ -153,6 +182,14 @@ void delete_fault_list(void)
     }
 
     num_list_elements = 0;
+    FIESER_ecc_reset();
+    FIESER_index_build();
+    FIESER_history_build();
+    FIESER_scheduler_build();
+    FIESER_peripheral_build();
+    FIESER_irq_build();
+    FIESER_ptimer_build();
+    FIESER_ecc_build();
 }
 
 /**
@@ -179,7 +216,10 @@ FaultList* getFaultListElement(int element)
     while (ptr != NULL)
     {
         if (element == index)
+        {
             fault_element = ptr;
+            break;
+        }
 
         index++;
         ptr = ptr->next;
@@ -281,13 +321,23 @@ static int validateFaultList(void)
                 case FI_MODE_CPSR_ZF:
                 case FI_MODE_CPSR_NF:
                 case FI_MODE_CPSR_QF:
+                case FI_MODE_CPSR_GE:
+                case FI_MODE_CPSR_IT:
+                case FI_MODE_CPSR_J:
+                case FI_MODE_CPSR_E:
+                case FI_MODE_CPSR_A:
+                case FI_MODE_CPSR_I:
+                case FI_MODE_CPSR_F:
+                case FI_MODE_CPSR_T:
+                case FI_MODE_CPSR_M:
+                case FI_MODE_XPSR_IPSR:
                     break;
                 default:
-                    qemu_log(msg_template, fault->id, "<target> is CONDITION FLAGS, mode can only be VF, ZF, CF, NF, QF.");
+                    qemu_log(msg_template, fault->id, "<target> is CONDITION FLAGS, mode can only be VF, ZF, CF, NF, QF, a CPSR field GE, IT, J, E, A, I, F, T, M or the XPSR IPSR.");
                     ret = false;
                 }
 
-                // which flag to flip is stored in set_bit
+                // the new state of the flag (the value of the field) is stored in set_bit
                 if (!fault->params.set_bit_defined)
                 {
                     qemu_log(msg_template, fault->id, "target is CONDITION FLAGS but <set_bit> mask for CPSR not defined");
@@ -331,9 +381,10 @@ static int validateFaultList(void)
             case FI_MODE_NEW_VALUE:
             case FI_MODE_BITFLIP:
             case FI_MODE_STATE_FAULT:
+            case FI_MODE_COUPLING_FAULT:
                 break;
             default:
-                qemu_log(msg_template, fault->id, "<component> RAM only supports modes NEW VALUE, SF, BIT-FLIP");
+                qemu_log(msg_template, fault->id, "<component> RAM only supports modes NEW VALUE, SF, BIT-FLIP, CFxx");
                 ret = false;
             }
         }
@@ -376,9 +427,168 @@ static int validateFaultList(void)
                 ret = false;
             }
         }
+        else if (fault->component == FI_COMP_NVIC)
+        {
+            /**
+             * the exception number (16 + n for IRQ n) is in <address>
+             */
+            switch (fault->target)
+            {
+            case FI_TAGT_NVIC_PENDING:
+            case FI_TAGT_NVIC_ENABLE:
+            case FI_TAGT_NVIC_PRIORITY:
+                break;
+            default:
+                qemu_log(msg_template, fault->id, "<component> NVIC only supports targets PENDING, ENABLE, PRIORITY");
+                ret = false;
+            }
+
+            switch (fault->mode)
+            {
+            case FI_MODE_NEW_VALUE:
+            case FI_MODE_BITFLIP:
+            case FI_MODE_STATE_FAULT:
+                break;
+            default:
+                qemu_log(msg_template, fault->id, "<component> NVIC only supports modes NEW VALUE, SF, BIT-FLIP");
+                ret = false;
+            }
+
+#if defined(CONFIG_USER_ONLY)
+            qemu_log(msg_template, fault->id, "<component> NVIC is only supported in system emulation");
+            ret = false;
+#endif
+            if (fault->trigger != FI_TRGR_TIME)
+            {
+                qemu_log(msg_template, fault->id, "<component> NVIC faults are applied at their activation edges and require <trigger> TIME");
+                ret = false;
+            }
+        }
+        else if (fault->component == FI_COMP_PERIPHERAL)
+        {
+            /**
+             * the physical address of the device register is in <address>
+             */
+            if (fault->target != FI_TAGT_REGISTER_CELL)
+            {
+                qemu_log(msg_template, fault->id, "<component> PERIPHERAL only supports target REGISTER CELL");
+                ret = false;
+            }
+
+            switch (fault->mode)
+            {
+            case FI_MODE_NEW_VALUE:
+            case FI_MODE_BITFLIP:
+            case FI_MODE_STATE_FAULT:
+            case FI_MODE_DROPPED_WRITE:
+                break;
+            default:
+                qemu_log(msg_template, fault->id, "<component> PERIPHERAL only supports modes NEW VALUE, SF, BIT-FLIP, DROPPED WRITE");
+                ret = false;
+            }
+
+#if defined(CONFIG_USER_ONLY)
+            qemu_log(msg_template, fault->id, "<component> PERIPHERAL is only supported in system emulation");
+            ret = false;
+#endif
+            if (fault->trigger != FI_TRGR_ACCESS)
+            {
+                qemu_log(msg_template, fault->id, "<component> PERIPHERAL faults are injected into the register accesses and require <trigger> ACCESS");
+                ret = false;
+            }
+
+            /**
+             * device registers are 32 bits wide, unless <width> says otherwise
+             */
+            if (!fault->params.width_defined)
+                fault->params.width = 32;
+        }
+        else if (fault->component == FI_COMP_IRQ)
+        {
+            /**
+             * the number of the input line of <device> is in <address>
+             */
+            if (fault->target != FI_TAGT_IRQ_LINE)
+            {
+                qemu_log(msg_template, fault->id, "<component> IRQ only supports target LINE");
+                ret = false;
+            }
+
+            switch (fault->mode)
+            {
+            case FI_MODE_IRQ_DELAYED:
+                if (!fault->params.delay_defined || fault->params.delay <= 0)
+                {
+                    qemu_log(msg_template, fault->id, "<mode> DELAYED requires the <delay> of the assertions");
+                    ret = false;
+                }
+                break;
+            case FI_MODE_IRQ_DROPPED:
+            case FI_MODE_IRQ_SPURIOUS:
+                break;
+            default:
+                qemu_log(msg_template, fault->id, "<component> IRQ only supports modes DROPPED, DELAYED, SPURIOUS");
+                ret = false;
+            }
+        }
+        else if (fault->component == FI_COMP_TIMER)
+        {
+            /**
+             * the number of the ptimer, in the order the devices created
+             * them, is in <address>
+             */
+            if (fault->target != FI_TAGT_TIMER_COUNTER)
+            {
+                qemu_log(msg_template, fault->id, "<component> TIMER only supports target COUNTER");
+                ret = false;
+            }
+
+            switch (fault->mode)
+            {
+            case FI_MODE_TIMER_DRIFT:
+                if (!fault->params.drift_defined || fault->params.drift <= -1000000
+                        || fault->params.drift > 1000000000)
+                {
+                    qemu_log(msg_template, fault->id, "<mode> DRIFT requires the <drift> of the period in ppm, above -1000000");
+                    ret = false;
+                }
+                break;
+            case FI_MODE_TIMER_TICK_SKIP:
+            case FI_MODE_TIMER_STUCK:
+                break;
+            default:
+                qemu_log(msg_template, fault->id, "<component> TIMER only supports modes TICK SKIP, DRIFT, STUCK");
+                ret = false;
+            }
+        }
         else
         {
-            qemu_log(msg_template, fault->id, "<component> has to be CPU, RAM, REGISTER");
+            qemu_log(msg_template, fault->id, "<component> has to be CPU, RAM, REGISTER, NVIC, PERIPHERAL, IRQ, TIMER");
+            ret = false;
+        }
+
+        if (fault->component == FI_COMP_IRQ || fault->component == FI_COMP_TIMER)
+        {
+#if defined(CONFIG_USER_ONLY)
+            qemu_log(msg_template, fault->id, "<component> IRQ and TIMER are only supported in system emulation");
+            ret = false;
+#endif
+            if (fault->trigger != FI_TRGR_TIME)
+            {
+                qemu_log(msg_template, fault->id, "<component> IRQ and TIMER faults are applied at their activation edges and require <trigger> TIME");
+                ret = false;
+            }
+        }
+
+        if ((fault->params.device_defined || fault->params.delay_defined) && fault->component != FI_COMP_IRQ)
+        {
+            qemu_log(msg_template, fault->id, "<device> and <delay> are only supported for IRQ faults");
+            ret = false;
+        }
+
+        if (fault->params.drift_defined && fault->component != FI_COMP_TIMER)
+        {
+            qemu_log(msg_template, fault->id, "<drift> is only supported for TIMER faults");
             ret = false;
         }
 
@@ -413,6 +623,104 @@ static int validateFaultList(void)
             }
         }
 
+        else if (fault->mode == FI_MODE_COUPLING_FAULT)
+        {
+            /**
+             * the victim cell is selected by address and mask, the
+             * aggressor cell by cf_address and set_bit (or mask)
+             */
+            if (fault->component != FI_COMP_RAM || fault->target != FI_TAGT_MEMORY_CELL
+                    || fault->trigger != FI_TRGR_ACCESS)
+            {
+                qemu_log(msg_template, fault->id, "coupling faults (CFxx) are only supported for ACCESS triggered RAM MEMORY CELL faults");
+                ret = false;
+            }
+            if (!fault->params.cf_address_defined)
+            {
+                qemu_log(msg_template, fault->id, "coupling faults (CFxx) require the aggressor cell in <cf_address>");
+                ret = false;
+            }
+            if (!fault->params.mask_defined || !fault->params.mask)
+            {
+                qemu_log(msg_template, fault->id, "coupling faults (CFxx) require <mask> containing a bitmask of the victim bits");
+                ret = false;
+            }
+            if (fault->params.width_defined && fault->params.width < MAX_CELL_WIDTH
+                    && (fault->params.mask >> fault->params.width || fault->params.set_bit >> fault->params.width))
+            {
+                qemu_log(msg_template, fault->id, "<mask> or <set_bit> exceed the <width> of the memory cell");
+                ret = false;
+            }
+            if (fault->params.cf_address == fault->params.address
+                    && (fault->params.set_bit ? fault->params.set_bit : fault->params.mask) & fault->params.mask)
+            {
+                qemu_log(msg_template, fault->id, "the aggressor bits (<set_bit>) must not overlap the victim bits (<mask>) within a memory cell");
+                ret = false;
+            }
+        }
+
+        if (fault->params.width_defined || fault->params.burst_defined)
+        {
+            if ((fault->component != FI_COMP_RAM || fault->target != FI_TAGT_MEMORY_CELL)
+                    && (fault->component != FI_COMP_PERIPHERAL || fault->params.burst_defined))
+            {
+                qemu_log(msg_template, fault->id, "<width> and <burst> are only supported for RAM MEMORY CELL faults, <width> also for PERIPHERAL faults");
+                ret = false;
+            }
+            if (fault->params.width != 8 && fault->params.width != 16
+                    && fault->params.width != 32 && fault->params.width != MAX_CELL_WIDTH)
+            {
+                qemu_log(msg_template, fault->id, "<width> has to be 8, 16, 32 or 64 bits");
+                ret = false;
+            }
+            if (fault->params.burst < 1)
+            {
+                qemu_log(msg_template, fault->id, "<burst> has to be a positive number of memory cells");
+                ret = false;
+            }
+            if (fault->trigger == FI_TRGR_ACCESS && fault->params.burst > 1)
+            {
+                qemu_log(msg_template, fault->id, "<burst> is not supported for ACCESS triggered faults, which modify the accessed value only");
+                ret = false;
+            }
+        }
+
+        if (fault->params.interleave_defined || fault->params.column_defined)
+        {
+            /**
+             * the mask selects physical columns of a row of interleaved
+             * cells instead of the bits of a single cell
+             */
+            if (fault->component != FI_COMP_RAM || fault->target != FI_TAGT_MEMORY_CELL
+                    || fault->trigger == FI_TRGR_ACCESS
+                    || (fault->mode != FI_MODE_BITFLIP && fault->mode != FI_MODE_STATE_FAULT))
+            {
+                qemu_log(msg_template, fault->id, "<interleave> and <column> are only supported for TIME or PC triggered BIT-FLIP and SF RAM MEMORY CELL faults");
+                ret = false;
+            }
+            if (fault->params.interleave < 1 || fault->params.interleave > MAX_INTERLEAVE)
+            {
+                qemu_log(msg_template, fault->id, "<interleave> has to be between 1 and 64 cells per row");
+                ret = false;
+            }
+            else if (fault->params.column < 0 || (fault->params.mask
+                    && fault->params.column + 63 - clz64(fault->params.mask)
+                       >= fault->params.interleave * fault->params.width))
+            {
+                qemu_log(msg_template, fault->id, "<mask> shifted by <column> exceeds the <interleave> cells of a row");
+                ret = false;
+            }
+        }
+        else if (((fault->component == FI_COMP_RAM && fault->target == FI_TAGT_MEMORY_CELL
+                && fault->trigger != FI_TRGR_ACCESS && fault->params.width_defined)
+                || fault->component == FI_COMP_PERIPHERAL)
+                && fault->params.width < MAX_CELL_WIDTH
+                && (fault->params.mask >> fault->params.width || fault->params.set_bit >> fault->params.width))
+        {
+            qemu_log(msg_template, fault->id, "<mask> or <set_bit> exceed the <width> of the memory cell");
+            ret = false;
+        }
+
         if (fault->trigger == FI_TRGR_TIME || (fault->trigger == FI_TRGR_ACCESS && fault->component != FI_COMP_CPU))
         {
 
@@ -451,6 +759,88 @@ static int validateFaultList(void)
 
 #ifdef LIBXML_READER_ENABLED
 
+/**
+ * Parses the mode of a coupling fault, which follows the usual notation
+ * of March tests: CFST<a><v>, CFTR<a><v>, CFWD<a><v>, CFRD<a><v>,
+ * CFIR<a><v>, CFDR<a><v>, CFDS<a>W<d><v> and CFDS<a>R<v>, with the
+ * aggressor state <a>, the value <d> written to the aggressor and the
+ * victim state <v> (each 0 or 1). The kind is case insensitive.
+ *
+ * @param[in] key - the content of the <mode> node.
+ * @param[out] coupling - the parsed coupling fault.
+ * @param[out] - true if key is a valid coupling fault mode.
+ */
+static bool parseCouplingMode(const char *key, struct coupling *coupling)
+{
+    static const struct {
+        const char *name;
+        enum CouplingFaultKind kind;
+    } kinds[] = {
+        { "CFST", FI_CF_STATE },
+        { "CFTR", FI_CF_TRANSITION },
+        { "CFWD", FI_CF_WRITE_DESTRUCTIVE },
+        { "CFRD", FI_CF_READ_DESTRUCTIVE },
+        { "CFIR", FI_CF_INCORRECT_READ },
+        { "CFDR", FI_CF_DECEPTIVE_READ },
+        { "CFDS", FI_CF_DISTURB },
+    };
+    char *mode = g_ascii_strup(key, -1);
+    const char *p = mode + 4;
+    bool ret = false;
+    int i;
+
+    memset(coupling, 0, sizeof(*coupling));
+
+    for (i = 0; i < ARRAY_SIZE(kinds); i++)
+    {
+        if (!strncmp(mode, kinds[i].name, 4))
+            coupling->kind = kinds[i].kind;
+    }
+
+    if (coupling->kind == FI_CF_NONE || strlen(mode) >= sizeof(coupling->name))
+        goto out;
+
+    if (*p != '0' && *p != '1')
+        goto out;
+    coupling->aggressor_state = *p++ - '0';
+
+    if (coupling->kind == FI_CF_DISTURB)
+    {
+        if (*p == 'R')
+        {
+            coupling->aggressor_op = FI_CF_OP_READ;
+            p++;
+
+            /**
+             * the read value may be given as well (CFDS<a>R<a><v>)
+             */
+            if (p[0] - '0' == coupling->aggressor_state && p[1] != '\0')
+                p++;
+        }
+        else if (*p == 'W' && (p[1] == '0' || p[1] == '1'))
+        {
+            coupling->aggressor_op = p[1] - '0';
+            p += 2;
+        }
+        else
+            goto out;
+    }
+
+    if (*p != '0' && *p != '1')
+        goto out;
+    coupling->victim_state = *p++ - '0';
+
+    if (*p == '\0')
+    {
+        pstrcpy(coupling->name, sizeof(coupling->name), mode);
+        ret = true;
+    }
+
+out:
+    g_free(mode);
+    return ret;
+}
+
 /**
  * Parses the fault parameters from the XML file.
  * 
@@ -481,12 +871,27 @@ static int parseFaultFromXML(xmlDocPtr doc, xmlNodePtr cur)
     fault.params.address_defined = FI_UNDEF;
     fault.params.cf_address = 0;
     fault.params.cf_address_defined = FI_UNDEF;
+    memset(&fault.coupling, 0, sizeof(fault.coupling));
     fault.params.mask = 0;
     fault.params.mask_defined = FI_UNDEF;
     fault.params.instruction = 0;
     fault.params.instruction_defined = FI_UNDEF;
     fault.params.set_bit = 0;
     fault.params.set_bit_defined = FI_UNDEF;
+    fault.params.width = MEMORY_WIDTH;
+    fault.params.width_defined = FI_UNDEF;
+    fault.params.burst = 1;
+    fault.params.burst_defined = FI_UNDEF;
+    fault.params.interleave = 1;
+    fault.params.interleave_defined = FI_UNDEF;
+    fault.params.column = 0;
+    fault.params.column_defined = FI_UNDEF;
+    fault.params.device[0] = '\0';
+    fault.params.device_defined = FI_UNDEF;
+    fault.params.delay = 0;
+    fault.params.delay_defined = FI_UNDEF;
+    fault.params.drift = 0;
+    fault.params.drift_defined = FI_UNDEF;
     fault.was_triggered = 0;
     fault.next = NULL;
 
@@ -534,10 +939,26 @@ static int parseFaultFromXML(xmlDocPtr doc, xmlNodePtr cur)
             {
                 fault.component = FI_COMP_REGISTER;
             }
+            else if (!strcmp(key, "NVIC"))
+            {
+                fault.component = FI_COMP_NVIC;
+            }
+            else if (!strcmp(key, "PERIPHERAL"))
+            {
+                fault.component = FI_COMP_PERIPHERAL;
+            }
+            else if (!strcmp(key, "IRQ"))
+            {
+                fault.component = FI_COMP_IRQ;
+            }
+            else if (!strcmp(key, "TIMER"))
+            {
+                fault.component = FI_COMP_TIMER;
+            }
             else
             {
                 ret = false;
-                qemu_log("FIESER: fault %d syntax error: <component> has to be \"CPU, REGISTER or RAM\", was %s\n", fault.id, key);
+                qemu_log("FIESER: fault %d syntax error: <component> has to be \"CPU, REGISTER, RAM, NVIC, PERIPHERAL, IRQ or TIMER\", was %s\n", fault.id, key);
             }
             xmlFree(key);
         }
@@ -593,12 +1014,33 @@ static int parseFaultFromXML(xmlDocPtr doc, xmlNodePtr cur)
                 fault.target = FI_TAGT_TRACE_CPSR;
                 profile_condition_flags = 1;
             }
+            else if (!strcmp(key, "PENDING"))
+            {
+                fault.target = FI_TAGT_NVIC_PENDING;
+            }
+            else if (!strcmp(key, "ENABLE"))
+            {
+                fault.target = FI_TAGT_NVIC_ENABLE;
+            }
+            else if (!strcmp(key, "PRIORITY"))
+            {
+                fault.target = FI_TAGT_NVIC_PRIORITY;
+            }
+            else if (!strcmp(key, "LINE"))
+            {
+                fault.target = FI_TAGT_IRQ_LINE;
+            }
+            else if (!strcmp(key, "COUNTER"))
+            {
+                fault.target = FI_TAGT_TIMER_COUNTER;
+            }
             else
             {
                 ret = false;
                 qemu_log("FIESER: fault %d syntax error: <target> has to be \"REGISTER CELL, MEMORY CELL, "
                          "CONDITION FLAGS, INSTRUCTION EXECUTION, INSTRUCTION DECODER, "
-                         "ADDRESS DECODER, FI_TAGT_RW_LOGIC, TRACE MEM ACCESS/REGISTERS/PC/CPSR\", was %s\n", fault.id, key);
+                         "ADDRESS DECODER, FI_TAGT_RW_LOGIC, TRACE MEM ACCESS/REGISTERS/PC/CPSR, "
+                         "PENDING, ENABLE, PRIORITY, LINE, COUNTER\", was %s\n", fault.id, key);
             }
             xmlFree(key);
         }
@@ -638,6 +1080,78 @@ static int parseFaultFromXML(xmlDocPtr doc, xmlNodePtr cur)
             {
                 fault.mode = FI_MODE_CPSR_QF;
             }
+            else if (!strcmp(key, "CPSR GE"))
+            {
+                fault.mode = FI_MODE_CPSR_GE;
+            }
+            else if (!strcmp(key, "CPSR IT"))
+            {
+                fault.mode = FI_MODE_CPSR_IT;
+            }
+            else if (!strcmp(key, "CPSR J"))
+            {
+                fault.mode = FI_MODE_CPSR_J;
+            }
+            else if (!strcmp(key, "CPSR E"))
+            {
+                fault.mode = FI_MODE_CPSR_E;
+            }
+            else if (!strcmp(key, "CPSR A"))
+            {
+                fault.mode = FI_MODE_CPSR_A;
+            }
+            else if (!strcmp(key, "CPSR I"))
+            {
+                fault.mode = FI_MODE_CPSR_I;
+            }
+            else if (!strcmp(key, "CPSR F"))
+            {
+                fault.mode = FI_MODE_CPSR_F;
+            }
+            else if (!strcmp(key, "CPSR T"))
+            {
+                fault.mode = FI_MODE_CPSR_T;
+            }
+            else if (!strcmp(key, "CPSR M"))
+            {
+                fault.mode = FI_MODE_CPSR_M;
+            }
+            else if (!strcmp(key, "XPSR IPSR"))
+            {
+                fault.mode = FI_MODE_XPSR_IPSR;
+            }
+            else if (!strcmp(key, "DROPPED WRITE"))
+            {
+                fault.mode = FI_MODE_DROPPED_WRITE;
+            }
+            else if (!strcmp(key, "DROPPED"))
+            {
+                fault.mode = FI_MODE_IRQ_DROPPED;
+            }
+            else if (!strcmp(key, "DELAYED"))
+            {
+                fault.mode = FI_MODE_IRQ_DELAYED;
+            }
+            else if (!strcmp(key, "SPURIOUS"))
+            {
+                fault.mode = FI_MODE_IRQ_SPURIOUS;
+            }
+            else if (!strcmp(key, "TICK SKIP"))
+            {
+                fault.mode = FI_MODE_TIMER_TICK_SKIP;
+            }
+            else if (!strcmp(key, "DRIFT"))
+            {
+                fault.mode = FI_MODE_TIMER_DRIFT;
+            }
+            else if (!strcmp(key, "STUCK"))
+            {
+                fault.mode = FI_MODE_TIMER_STUCK;
+            }
+            else if (parseCouplingMode(key, &fault.coupling))
+            {
+                fault.mode = FI_MODE_COUPLING_FAULT;
+            }
             else
             {
                 ret = false;
@@ -753,7 +1267,7 @@ static int parseFaultFromXML(xmlDocPtr doc, xmlNodePtr cur)
                 else if (!xmlStrcmp(grandchild_node->name, (const xmlChar *) "mask"))
                 {
                     key = (char *) xmlNodeListGetString(doc, grandchild_node->xmlChildrenNode, 1);
-                    fault.params.mask = (int) strtol((char *) key, NULL, 16);
+                    fault.params.mask = strtoull((char *) key, NULL, 16);
                     fault.params.mask_defined = true;
                     xmlFree(key);
                 }
@@ -767,10 +1281,71 @@ static int parseFaultFromXML(xmlDocPtr doc, xmlNodePtr cur)
                 else if (!xmlStrcmp(grandchild_node->name, (const xmlChar *) "set_bit"))
                 {
                     key = (char *) xmlNodeListGetString(doc, grandchild_node->xmlChildrenNode, 1);
-                    fault.params.set_bit = (int) strtol((char *) key, NULL, 16);
+                    fault.params.set_bit = strtoull((char *) key, NULL, 16);
                     fault.params.set_bit_defined = true;
                     xmlFree(key);
                 }
+                else if (!xmlStrcmp(grandchild_node->name, (const xmlChar *) "width"))
+                {
+                    key = (char *) xmlNodeListGetString(doc, grandchild_node->xmlChildrenNode, 1);
+                    fault.params.width = (int) strtol((char *) key, NULL, 10);
+                    fault.params.width_defined = true;
+                    xmlFree(key);
+                }
+                else if (!xmlStrcmp(grandchild_node->name, (const xmlChar *) "burst"))
+                {
+                    key = (char *) xmlNodeListGetString(doc, grandchild_node->xmlChildrenNode, 1);
+                    fault.params.burst = (int) strtol((char *) key, NULL, 10);
+                    fault.params.burst_defined = true;
+                    xmlFree(key);
+                }
+                else if (!xmlStrcmp(grandchild_node->name, (const xmlChar *) "interleave"))
+                {
+                    key = (char *) xmlNodeListGetString(doc, grandchild_node->xmlChildrenNode, 1);
+                    fault.params.interleave = (int) strtol((char *) key, NULL, 10);
+                    fault.params.interleave_defined = true;
+                    xmlFree(key);
+                }
+                else if (!xmlStrcmp(grandchild_node->name, (const xmlChar *) "column"))
+                {
+                    key = (char *) xmlNodeListGetString(doc, grandchild_node->xmlChildrenNode, 1);
+                    fault.params.column = (int) strtol((char *) key, NULL, 10);
+                    fault.params.column_defined = true;
+                    xmlFree(key);
+                }
+                else if (!xmlStrcmp(grandchild_node->name, (const xmlChar *) "device"))
+                {
+                    key = (char *) xmlNodeListGetString(doc, grandchild_node->xmlChildrenNode, 1);
+                    pstrcpy(fault.params.device, sizeof(fault.params.device), key);
+                    fault.params.device_defined = true;
+                    xmlFree(key);
+                }
+                else if (!xmlStrcmp(grandchild_node->name, (const xmlChar *) "delay"))
+                {
+                    int ok = true;
+                    key = (char *) xmlNodeListGetString(doc, grandchild_node->xmlChildrenNode, 1);
+                    fault.params.delay = FIESER_normalize_time_to_int64(key, &ok);
+                    fault.params.delay_defined = true;
+
+                    if (!ok)
+                    {
+                        ret = false;
+                        qemu_log("FIESER: fault %d syntax error: <delay> has to be a positive integer ending in NS/MS/US, was %s\n", fault.id, key);
+                    }
+                    xmlFree(key);
+                }
+                else if (!xmlStrcmp(grandchild_node->name, (const xmlChar *) "drift"))
+                {
+                    key = (char *) xmlNodeListGetString(doc, grandchild_node->xmlChildrenNode, 1);
+                    fault.params.drift_defined = true;
+
+                    if (qemu_strtoi64(key, NULL, 10, &fault.params.drift))
+                    {
+                        ret = false;
+                        qemu_log("FIESER: fault %d syntax error: <drift> has to be an integer in ppm, was %s\n", fault.id, key);
+                    }
+                    xmlFree(key);
+                }
                 else if (grandchild_node->type != XML_TEXT_NODE)
                 {
                     qemu_log("FIESER: fault ENTRY %d syntax error in <param>: unknown element %s\n", num_list_elements, cur->name);
@@ -794,6 +1369,121 @@ static int parseFaultFromXML(xmlDocPtr doc, xmlNodePtr cur)
     return ret;
 }
 
+/**
+ * Parses an ECC-protected RAM region (<ecc>) and adds it to the ECC layer.
+ *
+ * @param[in] doc - the XML document.
+ * @param[in] cur - the <ecc> node.
+ * @param[out] - false if the region is invalid.
+ */
+static int parseEccFromXML(xmlDocPtr doc, xmlNodePtr cur)
+{
+    FIESEccConfig config;
+    int address_defined = false, size_defined = false;
+    int ret = true;
+    char *key;
+
+    memset(&config, 0, sizeof(config));
+    config.code = FIES_ECC_SECDED;
+
+    cur = cur->xmlChildrenNode;
+    while (cur != NULL)
+    {
+        if (cur->type == XML_TEXT_NODE)
+        {
+            cur = cur->next;
+            continue;
+        }
+
+        key = (char *) xmlNodeListGetString(doc, cur->xmlChildrenNode, 1);
+
+        if (!key)
+        {
+            qemu_log("FIESER: <ecc> syntax error: empty element %s\n", cur->name);
+            ret = false;
+        }
+        else if (!xmlStrcmp(cur->name, (const xmlChar *) "address"))
+        {
+            config.address = strtoull(key, NULL, 16);
+            address_defined = true;
+        }
+        else if (!xmlStrcmp(cur->name, (const xmlChar *) "size"))
+        {
+            config.size = strtoull(key, NULL, 16);
+            size_defined = true;
+        }
+        else if (!xmlStrcmp(cur->name, (const xmlChar *) "code"))
+        {
+            if (!strcmp(key, "SECDED"))
+                config.code = FIES_ECC_SECDED;
+            else if (!strcmp(key, "CHIPKILL"))
+                config.code = FIES_ECC_CHIPKILL;
+            else
+            {
+                qemu_log("FIESER: <ecc> syntax error: <code> has to be SECDED or CHIPKILL, was %s\n", key);
+                ret = false;
+            }
+        }
+        else if (!xmlStrcmp(cur->name, (const xmlChar *) "registers"))
+        {
+            config.registers = strtoull(key, NULL, 16);
+            config.registers_defined = true;
+        }
+        else if (!xmlStrcmp(cur->name, (const xmlChar *) "device"))
+        {
+            pstrcpy(config.device, sizeof(config.device), key);
+            config.device_defined = true;
+        }
+        else if (!xmlStrcmp(cur->name, (const xmlChar *) "line"))
+        {
+            config.line = (int) strtol(key, NULL, 10);
+            config.line_defined = true;
+        }
+        else if (!xmlStrcmp(cur->name, (const xmlChar *) "scrub"))
+        {
+            int ok = true;
+            config.scrub = FIESER_normalize_time_to_int64(key, &ok);
+
+            if (!ok || config.scrub <= 0)
+            {
+                qemu_log("FIESER: <ecc> syntax error: <scrub> has to be a positive integer ending in NS/MS/US, was %s\n", key);
+                ret = false;
+            }
+        }
+        else
+        {
+            qemu_log("FIESER: <ecc> syntax error: unknown element %s\n", cur->name);
+            ret = false;
+        }
+
+        xmlFree(key);
+        cur = cur->next;
+    }
+
+#if defined(CONFIG_USER_ONLY)
+    qemu_log("FIESER: <ecc> is only supported in system emulation\n");
+    ret = false;
+#endif
+
+    if (!address_defined || !size_defined || !config.size
+            || (config.address | config.size) & 7)
+    {
+        qemu_log("FIESER: <ecc> requires an <address> and a <size>, which are multiples of 8 bytes\n");
+        ret = false;
+    }
+
+    if (config.device_defined && !config.line_defined)
+    {
+        qemu_log("FIESER: <ecc> <device> requires the input <line> of the interrupt\n");
+        ret = false;
+    }
+
+    if (ret)
+        FIESER_ecc_add_region(&config);
+
+    return ret;
+}
+
 /**
  * Read the XML-file and checks the basic structure of the XML for
  * correctness. Starts the XML-parser.
@@ -834,10 +1524,13 @@ static int parseFile(const char *filename)
      * Deleting current context
      */
     if (head)
+    {
+        FIESER_invalidate_insn_faults();
         delete_fault_list();
+    }
 
     destroy_id_array();
-    FIESER_helper_destroy_ops_on_cell();
+    FIESER_ecc_reset();
 
     cur = cur->xmlChildrenNode;
     while (cur != NULL)
@@ -847,6 +1540,11 @@ static int parseFile(const char *filename)
             if (!parseFaultFromXML(doc, cur))
                 had_parser_errors++;
         }
+        else if (!xmlStrcmp(cur->name, (const xmlChar *) "ecc"))
+        {
+            if (!parseEccFromXML(doc, cur))
+                had_parser_errors++;
+        }
         else if (cur->type != XML_TEXT_NODE)
         {
             qemu_log("FIESER: Syntax error: unknown element %s\n", cur->name);
@@ -891,13 +1589,32 @@ void qmp_fault_reload(Monitor *mon, const char *filename, Error **errp)
      * between the version it was compiled for and the actual shared
      * library used.
      */
-    int max_id = 0;
+    int max_id = 0, failed;
+
+    /**
+     * A running experiment is finished by loading the next one
+     */
+    if (experiment_running)
+    {
+        FIESER_stats_experiment_completed();
+        trace_fies_experiment_end(FIESER_timer_get(),
+                                  get_num_injected_faults(),
+                                  get_num_detected_faults());
+    }
+
+    FIESER_stats_set_phase(FIES_PHASE_LOADING);
+
+    /**
+     * A library may be loaded into a run started without -fi
+     */
+    FIESER_enable();
 
     /**
      * Starting new fault injection experiment -
      * reset timer and statistics
      */
     FIESER_timer_init();
+    FIESER_overhead_reset();
     set_num_injected_faults(0);
     set_num_detected_faults(0);
     set_num_injected_faults_ram_trans(0);
@@ -909,18 +1626,39 @@ void qmp_fault_reload(Monitor *mon, const char *filename, Error **errp)
 
     LIBXML_TEST_VERSION
 
-    if (parseFile(filename))
+    failed = parseFile(filename);
+    FIESER_index_build();
+    FIESER_history_build();
+    FIESER_scheduler_build();
+    FIESER_peripheral_build();
+    FIESER_irq_build();
+    FIESER_ptimer_build();
+    FIESER_ecc_build();
+    FIESER_arm_permanent_faults();
+    FIESER_invalidate_insn_faults();
+    trace_fies_reload(filename, getNumFaultListElements(), failed);
+    experiment_running = !failed;
+
+    if (failed)
     {
+        FIESER_stats_set_phase(FIES_PHASE_IDLE);
+
+#if !defined(CONFIG_USER_ONLY)
         if (mon)
             monitor_printf(mon, "FIESER: Could not load configuration file\n");
         else
+#endif
             qemu_log("FIESER: Could not load configuration file\n");
     }
     else
     {
+        FIESER_stats_set_phase(FIES_PHASE_RUNNING);
+
+#if !defined(CONFIG_USER_ONLY)
         if (mon)
             monitor_printf(mon, "FIESER: Configuration file loaded successfully\n");
         else
+#endif
             qemu_log("FIESER: Configuration file loaded successfully\n");
     }
 #if defined(DEBUG_FAULT_LIST)
@@ -932,7 +1670,9 @@ void qmp_fault_reload(Monitor *mon, const char *filename, Error **errp)
      */
     max_id = getMaxIDInFaultList();
     init_id_array(max_id);
-    FIESER_helper_init_ops_on_cell(max_id);
+
+    if (experiment_running)
+        trace_fies_experiment_begin(getNumFaultListElements());
 
     xmlCleanupParser();
 }
@@ -944,3 +1684,27 @@ void qmp_fault_reload(Monitor *mon, const char *filename, Error **errp)
 }
 #endif
 
+/**
+ * Finishes the running experiment, when the guest terminates without
+ * the monitor (e.g. a user mode process exiting or killed by a signal).
+ *
+ * @param[in] status - the exit status or the number of the fatal signal.
+ */
+void FIESER_experiment_exit(int status)
+{
+    if (!experiment_running)
+        return;
+
+    experiment_running = false;
+
+    FIESER_stats_set_phase(FIES_PHASE_TERMINATING);
+    FIESER_stats_experiment_completed();
+    trace_fies_experiment_end(FIESER_timer_get(),
+                              get_num_injected_faults(),
+                              get_num_detected_faults());
+
+    qemu_log("FIESER: experiment ended with status %d, %d faults injected, "
+             "%d faults detected\n", status, get_num_injected_faults(),
+             get_num_detected_faults());
+}
+
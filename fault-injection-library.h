@@ -27,10 +27,13 @@ const char * FaultTarget2STR(enum FaultTarget which);
 const char * FaultMode2STR(enum FaultMode which);
 const char * FaultTrigger2STR(enum FaultTrigger which);
 const char * FaultType2STR(enum FaultType which);
+const char * InjectionMode2STR(InjectionMode which);
+const char * FIESCallSite2STR(FIESCallSite which);
 
 int getNumFaultListElements(void);
 FaultList* getFaultListElement(int element);
 void qmp_fault_reload(Monitor *mon, const char *filename, Error **errp);
+void FIESER_experiment_exit(int status);
 void delete_fault_list(void);
 int getMaxIDInFaultList(void);
 
@@ -0,0 +1,181 @@
+/*
+ * fault-injection-nvic.c
+ *
+ *  FIESer by Christian M. Fuchs 2017/2018
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+#include "qemu/log.h"
+#include "cpu.h"
+
+#include "fault-injection-nvic.h"
+#include "fault-injection-library.h"
+#include "fault-injection-controller.h"
+#include "fault-injection-data-analyzer.h"
+#include "fault-injection-index.h"
+#include "trace-root.h"
+
+#if !defined(CONFIG_USER_ONLY)
+#include "hw/intc/armv7m_nvic.h"
+
+/**
+ * Returns the NVIC of the M-profile CPU.
+ *
+ * @param[out] - the NVIC or NULL, if the CPU is not an M-profile CPU.
+ */
+static NVICState *FIESER_nvic_get(void)
+{
+    CPUARMState *env;
+
+    if (!first_cpu)
+        return NULL;
+
+    env = &ARM_CPU(first_cpu)->env;
+    return arm_feature(env, ARM_FEATURE_M) ? env->nvic : NULL;
+}
+
+/**
+ * Returns the state of the exception selected by the <address> of a
+ * fault. The pending and enable state is injected from the NMI on, the
+ * priority only for the exceptions with a configurable priority (from
+ * MemManage on). The banked exceptions are injected in their non-secure
+ * state.
+ *
+ * @param[in] s - the NVIC.
+ * @param[in] fault - pointer to the linked list entry.
+ * @param[out] - the state of the exception or NULL, if the NVIC does not
+ *               implement the exception.
+ */
+static VecInfo *FIESER_nvic_vector(NVICState *s, FaultList *fault)
+{
+    int exc = fault->params.address;
+    int first = fault->target == FI_TAGT_NVIC_PRIORITY ? ARMV7M_EXCP_MEM : ARMV7M_EXCP_NMI;
+
+    if (exc < first || exc >= s->num_irq)
+        return NULL;
+
+    return &s->vectors[exc];
+}
+
+/**
+ * Reads the state of an exception, which is the target of a fault. The
+ * priority is read as the 8-bit priority field.
+ *
+ * @param[in] vec - the state of the exception.
+ * @param[in] target - the pending, enable or priority state.
+ * @param[out] - the value of the state.
+ */
+static uint32_t FIESER_nvic_read(VecInfo *vec, enum FaultTarget target)
+{
+    switch (target)
+    {
+    case FI_TAGT_NVIC_PENDING:
+        return vec->pending;
+    case FI_TAGT_NVIC_ENABLE:
+        return vec->enabled;
+    default:
+        return (uint8_t) vec->prio;
+    }
+}
+
+/**
+ * Writes the state of an exception, which is the target of a fault.
+ *
+ * @param[in] vec - the state of the exception.
+ * @param[in] target - the pending, enable or priority state.
+ * @param[in] value - the new value of the state.
+ */
+static void FIESER_nvic_write(VecInfo *vec, enum FaultTarget target, uint32_t value)
+{
+    switch (target)
+    {
+    case FI_TAGT_NVIC_PENDING:
+        vec->pending = value & 1;
+        break;
+    case FI_TAGT_NVIC_ENABLE:
+        vec->enabled = value & 1;
+        break;
+    default:
+        vec->prio = value & 0xff;
+    }
+}
+
+/**
+ * Injects an NVIC fault at the rising edge of its activation and lets the
+ * NVIC recompute its pending exception. A cleared pending state loses the
+ * interrupt, a set one raises a spurious interrupt and a changed priority
+ * inverts the order, in which the interrupts are taken.
+ *
+ * @param[in] fault - pointer to the linked list entry.
+ */
+void FIESER_nvic_inject(FaultList *fault)
+{
+    NVICState *s = FIESER_nvic_get();
+    VecInfo *vec = s ? FIESER_nvic_vector(s, fault) : NULL;
+    uint32_t before, value;
+
+    if (!vec)
+    {
+        qemu_log("FIESER: fault %d: the NVIC does not implement the %s state of exception %d\n",
+                 fault->id, FaultTarget2STR(fault->target), fault->params.address);
+        return;
+    }
+
+    before = FIESER_nvic_read(vec, fault->target);
+
+    if (fault->mode == FI_MODE_BITFLIP)
+        value = before ^ fault->params.mask;
+    else if (fault->mode == FI_MODE_NEW_VALUE)
+        value = fault->params.mask;
+    else
+        value = (before & ~fault->params.mask) | (fault->params.set_bit & fault->params.mask);
+
+    FIESER_nvic_write(vec, fault->target, value);
+    trace_fies_nvic(fault->id, fault->params.address, fault->target, before,
+                    FIESER_nvic_read(vec, fault->target));
+    incr_num_injected_faults(fault->id, FI_COMP_NVIC, fault->type);
+
+    armv7m_nvic_fies_update(s);
+}
+
+/**
+ * Holds the bits of the active State Faults in the NVIC, whenever the NVIC
+ * recomputes its pending exception, i.e. after every change of the state of
+ * an exception by the guest or a device. Only called through
+ * FIESER_hook_nvic() while fies_enabled is set.
+ *
+ * @param[in] opaque - the NVIC.
+ */
+void FIESER_do_hook_nvic(void *opaque)
+{
+    NVICState *s = opaque;
+    FaultList *fault;
+    VecInfo *vec;
+    uint32_t value;
+    int pos;
+
+    pos = FIESER_index_lookup(FI_INDEX_NVIC, 0, s->num_irq);
+
+    while ((fault = FIESER_index_next(FI_INDEX_NVIC, 0, &pos)))
+    {
+        vec = FIESER_nvic_vector(s, fault);
+
+        if (!vec || !FIESER_fault_active(fault))
+            continue;
+
+        value = FIESER_nvic_read(vec, fault->target);
+        FIESER_nvic_write(vec, fault->target,
+                          (value & ~fault->params.mask) | (fault->params.set_bit & fault->params.mask));
+    }
+}
+#else
+void FIESER_nvic_inject(FaultList *fault)
+{
+}
+#endif
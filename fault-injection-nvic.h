@@ -0,0 +1,37 @@
+/*
+ * fault-injection-nvic.h
+ *
+ *  FIESer by Christian M. Fuchs 2017/2018
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#ifndef FAULT_INJECTION_NVIC_H_
+#define FAULT_INJECTION_NVIC_H_
+
+#include "qemu/osdep.h"
+
+#include "fault-injection-infrastructure.h"
+#include "fault-injection-config.h"
+
+/**
+ * see corresponding c-file for documentation
+ */
+void FIESER_nvic_inject(FaultList *fault);
+void FIESER_do_hook_nvic(void *opaque);
+
+/**
+ * Interface of the fault controller for the NVIC, which is called
+ * whenever the NVIC recomputes its pending exception.
+ */
+static inline void FIESER_hook_nvic(void *opaque)
+{
+    if (unlikely(fies_enabled))
+        FIESER_do_hook_nvic(opaque);
+}
+
+#endif /* FAULT_INJECTION_NVIC_H_ */
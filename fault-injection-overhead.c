@@ -0,0 +1,76 @@
+/*
+ * fault-injection-overhead.c
+ *
+ *  FIESer by Christian M. Fuchs 2017/2018
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+
+#include "fault-injection-overhead.h"
+
+static const char *FIESOverheadPhase_STR[] = {
+    "profiler",
+    "tlb-flush",
+    "fault-list"
+};
+
+/**
+ * FIESER_hook invocations and the host cycles spent in them
+ * per call site and injection mode.
+ */
+uint64_t fies_overhead_calls[FI_SITE_MAX][FI_INJECTION_MODE_MAX];
+uint64_t fies_overhead_cycles[FI_SITE_MAX][FI_INJECTION_MODE_MAX];
+
+/**
+ * Host cycles spent in the different phases of FIESER_hook,
+ * summed over all call sites.
+ */
+uint64_t fies_overhead_phase_cycles[FI_OVERHEAD_PHASE_MAX];
+
+const char *FIESOverheadPhase2STR(FIESOverheadPhase which)
+{
+    return FIESOverheadPhase_STR[which];
+}
+
+/**
+ * Resets all counters. Is called when a new fault injection
+ * experiment is started, so the results always refer to the
+ * currently loaded fault library.
+ */
+void FIESER_overhead_reset(void)
+{
+    memset(fies_overhead_calls, 0, sizeof(fies_overhead_calls));
+    memset(fies_overhead_cycles, 0, sizeof(fies_overhead_cycles));
+    memset(fies_overhead_phase_cycles, 0, sizeof(fies_overhead_phase_cycles));
+}
+
+/**
+ * Accounts the host cycles of a timed FIESER_hook invocation.
+ * TLB flushes are timed where they happen and are excluded
+ * from the fault-list phase.
+ *
+ * @param[in] site - the call site FIESER_hook was called from.
+ * @param[in] injection_mode - the mode FIESER_hook was called with.
+ * @param[in] start - the host cycle counter at hook entry.
+ * @param[in] profiled - the host cycle counter after profiler logging.
+ * @param[in] tlb_flush_before - the TLB flush cycles before dispatching.
+ */
+void FIESER_overhead_account(FIESCallSite site, InjectionMode injection_mode,
+                             int64_t start, int64_t profiled,
+                             uint64_t tlb_flush_before)
+{
+    int64_t end = cpu_get_host_ticks();
+    uint64_t tlb_flush = fies_overhead_phase_cycles[FI_OVERHEAD_TLB_FLUSH]
+                         - tlb_flush_before;
+
+    fies_overhead_cycles[site][injection_mode] += end - start;
+    fies_overhead_phase_cycles[FI_OVERHEAD_PROFILER] += profiled - start;
+    fies_overhead_phase_cycles[FI_OVERHEAD_FAULT_LIST] += end - profiled
+                                                          - tlb_flush;
+}
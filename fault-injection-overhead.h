@@ -0,0 +1,73 @@
+/*
+ * fault-injection-overhead.h
+ *
+ *  FIESer by Christian M. Fuchs 2017/2018
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#ifndef FAULT_INJECTION_OVERHEAD_H_
+#define FAULT_INJECTION_OVERHEAD_H_
+
+#include "qemu/osdep.h"
+#include "qemu/timer.h"
+
+#include "fault-injection-enums.h"
+
+/**
+ * The phases of a FIESER_hook invocation, which are timed
+ * separately. The fault-list phase covers walking the fault
+ * list and injecting, excluding any TLB flushes.
+ */
+typedef enum {
+    FI_OVERHEAD_PROFILER,
+    FI_OVERHEAD_TLB_FLUSH,
+    FI_OVERHEAD_FAULT_LIST,
+    FI_OVERHEAD_PHASE_MAX
+} FIESOverheadPhase;
+
+/**
+ * Host-cycle timing is enabled with "-profiling t", the
+ * invocation counters are always maintained.
+ */
+extern unsigned int profile_hook_overhead;
+
+extern uint64_t fies_overhead_calls[FI_SITE_MAX][FI_INJECTION_MODE_MAX];
+extern uint64_t fies_overhead_cycles[FI_SITE_MAX][FI_INJECTION_MODE_MAX];
+extern uint64_t fies_overhead_phase_cycles[FI_OVERHEAD_PHASE_MAX];
+
+/**
+ * see corresponding c-file for documentation
+ */
+void FIESER_overhead_reset(void);
+void FIESER_overhead_account(FIESCallSite site, InjectionMode injection_mode,
+                             int64_t start, int64_t profiled,
+                             uint64_t tlb_flush_before);
+const char *FIESOverheadPhase2STR(FIESOverheadPhase which);
+
+/**
+ * Counts a single FIESER_hook invocation from a call site.
+ */
+static inline void FIESER_overhead_count(FIESCallSite site,
+                                         InjectionMode injection_mode)
+{
+    fies_overhead_calls[site][injection_mode]++;
+}
+
+/**
+ * Adds host cycles to a phase, if timing is enabled.
+ *
+ * @param[in] phase - the phase the cycles were spent in.
+ * @param[in] start - the host cycle counter at the start of the phase.
+ */
+static inline void FIESER_overhead_phase_end(FIESOverheadPhase phase,
+                                             int64_t start)
+{
+    fies_overhead_phase_cycles[phase] += cpu_get_host_ticks() - start;
+}
+
+#endif /* FAULT_INJECTION_OVERHEAD_H_ */
@@ -0,0 +1,333 @@
+/*
+ * fault-injection-peripheral.c
+ *
+ *  FIESer by Christian M. Fuchs 2017/2018
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+#include "qemu/log.h"
+#include "qemu/bitops.h"
+
+#include "fault-injection-peripheral.h"
+#include "fault-injection-library.h"
+#include "fault-injection-controller.h"
+#include "fault-injection-data-analyzer.h"
+#include "fault-injection-index.h"
+#include "trace-root.h"
+
+#if !defined(CONFIG_USER_ONLY)
+#include "exec/memory.h"
+#include "exec/address-spaces.h"
+
+/**
+ * The interposer of a device region, which holds a faulted device register.
+ * The ops and opaque of the region are replaced by the ones of the
+ * interposer, which forwards all accesses to the original ops and injects
+ * the faults of the peripheral index into them. base is the physical
+ * address of the region, by which the faulted registers are looked up.
+ * All other regions keep their ops, so their accesses are dispatched as
+ * without fault injection.
+ */
+typedef struct {
+    MemoryRegion *mr;
+    const MemoryRegionOps *orig_ops;
+    void *orig_opaque;
+    MemoryRegionOps ops;
+    hwaddr base;
+    bool armed;
+} FIESPeripheral;
+
+/**
+ * The installed interposers, by their region.
+ */
+static GHashTable *fies_peripherals;
+
+/**
+ * Moves the bits of a cell to the position of the cell within an access.
+ *
+ * @param[in] bits - the bits of the cell.
+ * @param[in] shift - the offset of the cell within the access in bits, which
+ *                    is negative if the cell starts in front of the access.
+ * @param[out] - the bits within the accessed value.
+ */
+static uint64_t FIESER_peripheral_shift(uint64_t bits, int64_t shift)
+{
+    if (shift >= 64 || shift <= -64)
+        return 0;
+
+    return shift >= 0 ? bits << shift : bits >> -shift;
+}
+
+/**
+ * Returns whether the registers of a device are laid out in big-endian
+ * order, i.e. the byte at offset n of an access of size bytes holds the
+ * bits 8(size-1-n) to 8(size-1-n)+7 of the value. Otherwise it holds the
+ * bits 8n to 8n+7.
+ *
+ * @param[in] ops - the callbacks of the device region.
+ * @param[out] - true if the device is big-endian.
+ */
+static bool FIESER_peripheral_big_endian(const MemoryRegionOps *ops)
+{
+#if defined(TARGET_WORDS_BIGENDIAN)
+    return ops->endianness != DEVICE_LITTLE_ENDIAN;
+#else
+    return ops->endianness == DEVICE_BIG_ENDIAN;
+#endif
+}
+
+/**
+ * Injects the active faults of the device registers overlapping an access
+ * into the accessed value, in the byte order of the device.
+ *
+ * @param[in] addr - the physical address of the access.
+ * @param[in,out] value - the value, which is read from or written to the device.
+ * @param[in] size - the size of the access in bytes.
+ * @param[in] big_endian - if the device is big-endian.
+ * @param[in] access_type - if the access-operation is a write or a read.
+ * @param[out] - false if the write has to be dropped.
+ */
+static bool FIESER_peripheral_access(hwaddr addr, uint64_t *value, unsigned size,
+                                     bool big_endian, AccessType access_type)
+{
+    FaultList *fault;
+    hwaddr cell;
+    uint64_t before, bits, mask;
+    int64_t shift;
+    bool forward = true;
+    int pos = FIESER_index_lookup(FI_INDEX_PERIPHERAL, addr, size);
+
+    while ((fault = FIESER_index_next_cell(FI_INDEX_PERIPHERAL, addr, &pos, &cell)))
+    {
+        if (!FIESER_fault_active(fault))
+            continue;
+
+        incr_num_injected_faults(fault->id, FI_COMP_PERIPHERAL, fault->type);
+
+        if (fault->mode == FI_MODE_DROPPED_WRITE)
+        {
+            if (access_type == write_access_type)
+            {
+                trace_fies_peripheral_dropped_write(fault->id, addr, *value);
+                forward = false;
+            }
+            continue;
+        }
+
+        shift = ((int64_t) cell - (int64_t) addr) * 8;
+        if (big_endian)
+            shift = (int64_t) size * 8 - shift - fault->params.width;
+        bits = fault->params.width < MAX_CELL_WIDTH
+                ? MAKE_64BIT_MASK(0, fault->params.width) : ~0ULL;
+        bits = FIESER_peripheral_shift(bits, shift);
+        mask = FIESER_peripheral_shift(fault->params.mask, shift);
+        before = *value;
+
+        if (fault->mode == FI_MODE_BITFLIP)
+            *value ^= mask;
+        else if (fault->mode == FI_MODE_NEW_VALUE)
+            *value = (*value & ~bits) | (mask & bits);
+        else if (fault->mode == FI_MODE_STATE_FAULT)
+            *value = (*value & ~mask)
+                    | (FIESER_peripheral_shift(fault->params.set_bit, shift) & mask);
+
+        if (size < 8)
+            *value &= MAKE_64BIT_MASK(0, size * 8);
+
+        trace_fies_peripheral(fault->id, addr, access_type, before, *value);
+    }
+
+    return forward;
+}
+
+static MemTxResult FIESER_peripheral_read(void *opaque, hwaddr addr,
+                                          uint64_t *data, unsigned size,
+                                          MemTxAttrs attrs)
+{
+    FIESPeripheral *p = opaque;
+    MemTxResult r = MEMTX_OK;
+
+    if (p->orig_ops->read)
+        *data = p->orig_ops->read(p->orig_opaque, addr, size);
+    else
+        r = p->orig_ops->read_with_attrs(p->orig_opaque, addr, data, size, attrs);
+
+    FIESER_peripheral_access(p->base + addr, data, size,
+                             FIESER_peripheral_big_endian(p->orig_ops),
+                             read_access_type);
+
+    return r;
+}
+
+static MemTxResult FIESER_peripheral_write(void *opaque, hwaddr addr,
+                                           uint64_t data, unsigned size,
+                                           MemTxAttrs attrs)
+{
+    FIESPeripheral *p = opaque;
+
+    if (!FIESER_peripheral_access(p->base + addr, &data, size,
+                                  FIESER_peripheral_big_endian(p->orig_ops),
+                                  write_access_type))
+        return MEMTX_OK;
+
+    if (p->orig_ops->write)
+    {
+        p->orig_ops->write(p->orig_opaque, addr, data, size);
+        return MEMTX_OK;
+    }
+
+    if (p->orig_ops->write_with_attrs)
+        return p->orig_ops->write_with_attrs(p->orig_opaque, addr, data, size, attrs);
+
+    return MEMTX_OK;
+}
+
+static bool FIESER_peripheral_accepts(void *opaque, hwaddr addr,
+                                      unsigned size, bool is_write)
+{
+    FIESPeripheral *p = opaque;
+
+    return p->orig_ops->valid.accepts(p->orig_opaque, addr, size, is_write);
+}
+
+static void *FIESER_peripheral_request_ptr(void *opaque, hwaddr addr,
+                                           unsigned *size, unsigned *offset)
+{
+    FIESPeripheral *p = opaque;
+
+    return p->orig_ops->request_ptr(p->orig_opaque, addr, size, offset);
+}
+
+/**
+ * Installs the interposer on the device region, which holds the register
+ * at a physical address, if it has none yet.
+ *
+ * @param[in] fault - pointer to the linked list entry.
+ */
+static void FIESER_peripheral_install(FaultList *fault)
+{
+    MemoryRegionSection section;
+    FIESPeripheral *p;
+    MemoryRegion *mr;
+
+    section = memory_region_find(get_system_memory(),
+                                 (uint32_t) fault->params.address, 1);
+    mr = section.mr;
+
+    if (!mr)
+    {
+        qemu_log("FIESER: fault %d: no device is mapped at 0x%x\n",
+                 fault->id, fault->params.address);
+        return;
+    }
+
+    p = g_hash_table_lookup(fies_peripherals, mr);
+    if (p)
+    {
+        p->armed = true;
+        memory_region_unref(mr);
+        return;
+    }
+
+    /**
+     * the ops are swapped under the BQL, so the accesses to the region
+     * have to be serialized by it
+     */
+    if (memory_region_is_ram(mr) || memory_region_is_romd(mr)
+            || (!mr->ops->read && !mr->ops->read_with_attrs)
+            || !mr->global_locking)
+    {
+        qemu_log("FIESER: fault %d: the region %s at 0x%x is not a supported device region\n",
+                 fault->id, memory_region_name(mr), fault->params.address);
+        memory_region_unref(mr);
+        return;
+    }
+
+    /**
+     * the copy keeps the access constraints and the endianness of the
+     * device, the reference to the region is held until it is removed
+     */
+    p = g_new0(FIESPeripheral, 1);
+    p->mr = mr;
+    p->orig_ops = mr->ops;
+    p->orig_opaque = mr->opaque;
+    p->base = section.offset_within_address_space - section.offset_within_region;
+    p->armed = true;
+
+    memcpy(&p->ops, mr->ops, sizeof(p->ops));
+    p->ops.read = NULL;
+    p->ops.write = NULL;
+    p->ops.read_with_attrs = FIESER_peripheral_read;
+    p->ops.write_with_attrs = FIESER_peripheral_write;
+    p->ops.valid.accepts = mr->ops->valid.accepts ? FIESER_peripheral_accepts : NULL;
+    p->ops.request_ptr = mr->ops->request_ptr ? FIESER_peripheral_request_ptr : NULL;
+
+    mr->ops = &p->ops;
+    mr->opaque = p;
+
+    g_hash_table_insert(fies_peripherals, mr, p);
+    trace_fies_peripheral_interposer(memory_region_name(mr), p->base, true);
+}
+
+/**
+ * Removes an interposer, which holds no faulted register anymore, and
+ * restores the original ops of its region.
+ */
+static gboolean FIESER_peripheral_remove(gpointer key, gpointer value,
+                                         gpointer user_data)
+{
+    FIESPeripheral *p = value;
+
+    if (p->armed)
+        return false;
+
+    p->mr->ops = p->orig_ops;
+    p->mr->opaque = p->orig_opaque;
+
+    trace_fies_peripheral_interposer(memory_region_name(p->mr), p->base, false);
+    memory_region_unref(p->mr);
+    g_free(p);
+
+    return true;
+}
+
+/**
+ * Installs the interposers on the device regions, which hold a faulted
+ * register, and removes them from all others. Has to be called with the
+ * BQL held, whenever the fault list is (re)loaded.
+ */
+void FIESER_peripheral_build(void)
+{
+    GHashTableIter iter;
+    gpointer key, value;
+    FaultList *fault;
+    int element;
+
+    if (!fies_peripherals)
+        fies_peripherals = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+    g_hash_table_iter_init(&iter, fies_peripherals);
+    while (g_hash_table_iter_next(&iter, &key, &value))
+        ((FIESPeripheral *) value)->armed = false;
+
+    for (element = 0; element < getNumFaultListElements(); element++)
+    {
+        fault = getFaultListElement(element);
+
+        if (FIESER_index_peripheral_fault(fault))
+            FIESER_peripheral_install(fault);
+    }
+
+    g_hash_table_foreach_remove(fies_peripherals, FIESER_peripheral_remove, NULL);
+}
+#else
+void FIESER_peripheral_build(void)
+{
+}
+#endif
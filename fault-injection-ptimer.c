@@ -0,0 +1,112 @@
+/*
+ * fault-injection-ptimer.c
+ *
+ *  FIESer by Christian M. Fuchs 2017/2018
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+#include "qemu/log.h"
+
+#include "fault-injection-ptimer.h"
+#include "fault-injection-library.h"
+#include "fault-injection-controller.h"
+#include "fault-injection-data-analyzer.h"
+#include "trace-root.h"
+
+#if !defined(CONFIG_USER_ONLY)
+#include "hw/ptimer.h"
+
+/**
+ * Applies the active TIMER faults of a ptimer to it: TICK SKIP suppresses
+ * its expiries, STUCK holds its counter and DRIFT stretches or shrinks its
+ * period (the drifts of overlapping faults add up).
+ *
+ * @param[in] s - the ptimer.
+ * @param[in] index - the number of the ptimer.
+ */
+static void FIESER_ptimer_update(ptimer_state *s, int index)
+{
+    FaultList *fault;
+    bool skip = false, stuck = false;
+    int64_t drift = 0;
+    int element;
+
+    for (element = 0; element < getNumFaultListElements(); element++)
+    {
+        fault = getFaultListElement(element);
+
+        if (fault->component != FI_COMP_TIMER || fault->params.address != index
+                || !FIESER_fault_active(fault))
+            continue;
+
+        if (fault->mode == FI_MODE_TIMER_TICK_SKIP)
+            skip = true;
+        else if (fault->mode == FI_MODE_TIMER_STUCK)
+            stuck = true;
+        else if (fault->mode == FI_MODE_TIMER_DRIFT)
+            drift += fault->params.drift;
+    }
+
+    ptimer_fies_set(s, skip, stuck, MAX(drift, -999999));
+}
+
+/**
+ * Clears the faults of all ptimers. Has to be called with the BQL held,
+ * whenever the fault list is (re)loaded; the faults of the new fault list
+ * are applied at their activation edges, which the scheduler raises right
+ * away for faults, which are active at load time already.
+ */
+void FIESER_ptimer_build(void)
+{
+    ptimer_state *s;
+    unsigned int index;
+
+    for (index = 0; index < ptimer_fies_count(); index++)
+    {
+        s = ptimer_fies_lookup(index);
+
+        if (s)
+            ptimer_fies_set(s, false, false, 0);
+    }
+}
+
+/**
+ * Updates the ptimer of a TIMER fault at an activation edge of the fault.
+ *
+ * @param[in] fault - pointer to the linked list entry.
+ * @param[in] active - if the fault became active or inactive.
+ */
+void FIESER_ptimer_scheduled(FaultList *fault, bool active)
+{
+    ptimer_state *s = fault->params.address < 0 ? NULL
+            : ptimer_fies_lookup(fault->params.address);
+
+    if (!s)
+    {
+        qemu_log("FIESER: fault %d: there is no ptimer %d (%u ptimers)\n",
+                 fault->id, fault->params.address, ptimer_fies_count());
+        return;
+    }
+
+    trace_fies_ptimer(fault->id, fault->params.address, fault->mode, active);
+
+    if (active)
+        incr_num_injected_faults(fault->id, FI_COMP_TIMER, fault->type);
+
+    FIESER_ptimer_update(s, fault->params.address);
+}
+#else
+void FIESER_ptimer_build(void)
+{
+}
+
+void FIESER_ptimer_scheduled(FaultList *fault, bool active)
+{
+}
+#endif
@@ -0,0 +1,26 @@
+/*
+ * fault-injection-ptimer.h
+ *
+ *  FIESer by Christian M. Fuchs 2017/2018
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#ifndef FAULT_INJECTION_PTIMER_H_
+#define FAULT_INJECTION_PTIMER_H_
+
+#include "qemu/osdep.h"
+
+#include "fault-injection-infrastructure.h"
+
+/**
+ * see corresponding c-file for documentation
+ */
+void FIESER_ptimer_build(void);
+void FIESER_ptimer_scheduled(FaultList *fault, bool active);
+
+#endif /* FAULT_INJECTION_PTIMER_H_ */
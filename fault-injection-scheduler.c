@@ -0,0 +1,245 @@
+/*
+ * fault-injection-scheduler.c
+ *
+ *  FIESer by Christian M. Fuchs 2017/2018
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+#include "qemu/timer.h"
+#include "cpu.h"
+#include "exec/exec-all.h"
+
+#include "fault-injection-scheduler.h"
+#include "fault-injection-library.h"
+#include "fault-injection-controller.h"
+#include "fault-injection-index.h"
+#include "fault-injection-dcls.h"
+#include "trace-root.h"
+
+/**
+ * A time-triggered fault, which is applied at its activation edges
+ * (see FIESER_index_scheduled_fault) instead of being checked after
+ * every instruction. active is the state of the fault at its last
+ * edge, so that only changes of the state are passed on.
+ */
+typedef struct {
+    FaultList *fault;
+    QEMUTimer *timer;
+    bool active;
+} ScheduledFault;
+
+/**
+ * An edge of a scheduled fault, which is passed from the timer to the
+ * CPU. The edge is dropped, if the fault list was reloaded meanwhile.
+ */
+typedef struct {
+    uint64_t generation;
+    int slot;
+} ScheduledEdge;
+
+static ScheduledFault *scheduled_faults;
+static int num_scheduled_faults;
+static uint64_t scheduler_generation;
+static bool scheduler_exclusive;
+
+/**
+ * Returns the next time at which a fault may become active or inactive
+ * (see FIESER_fault_active). Transient and intermittent faults also have
+ * a falling edge at the end of their duration.
+ *
+ * @param[in] fault - pointer to the linked list entry.
+ * @param[in] now - the elapsed time of the experiment.
+ * @param[out] - the elapsed time of the next edge or -1, if the state
+ *               of the fault does not change anymore.
+ */
+static int64_t FIESER_scheduler_next_edge(FaultList *fault, int64_t now)
+{
+    int64_t next;
+
+    if (fault->type == FI_TYPE_PERMANENT || now >= fault->duration)
+        return -1;
+
+    if (now <= fault->timer)
+        return fault->timer + 1;
+
+    if (fault->type != FI_TYPE_INTERMITTENT || fault->interval <= 0)
+        return fault->duration;
+
+    next = (now / fault->interval + 1) * fault->interval;
+    return next < fault->duration ? next : fault->duration;
+}
+
+/**
+ * Arms the timer of a scheduled fault for its next edge.
+ *
+ * @param[in] scheduled - the scheduled fault.
+ */
+static void FIESER_scheduler_arm(ScheduledFault *scheduled)
+{
+    int64_t now = FIESER_timer_get();
+    int64_t next = FIESER_scheduler_next_edge(scheduled->fault, now);
+
+    if (next >= 0)
+        timer_mod(scheduled->timer, qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL) + next - now);
+}
+
+/**
+ * Evaluates an edge of a scheduled fault and passes a change of its state
+ * to the fault controller.
+ *
+ * @param[in] scheduled - the scheduled fault.
+ * @param[in] env - Reference to the information of the CPU state or NULL,
+ *                  if the fault is applied to a device.
+ */
+static void FIESER_scheduler_edge(ScheduledFault *scheduled, CPUArchState *env)
+{
+    bool active = FIESER_fault_active(scheduled->fault);
+
+    if (active != scheduled->active)
+    {
+        if (active)
+            trace_fies_scheduled_fault(scheduled->fault->id, FIESER_timer_get());
+
+        FIESER_controller_scheduled(env, scheduled->fault, active);
+    }
+
+    scheduled->active = active;
+    FIESER_scheduler_arm(scheduled);
+}
+
+/**
+ * Checks if a scheduled fault is applied to a device instead of the CPU
+ * state, so that its edges are evaluated right in the main loop.
+ *
+ * @param[in] fault - pointer to the linked list entry.
+ * @param[out] - true if the fault is an IRQ or TIMER fault.
+ */
+static bool FIESER_scheduler_device_fault(FaultList *fault)
+{
+    return fault->component == FI_COMP_IRQ || fault->component == FI_COMP_TIMER;
+}
+
+/**
+ * Evaluates an edge of a scheduled fault on the CPU, between two TBs. In
+ * DCLS mode, the shadow context keeps the state before the injection.
+ */
+static void FIESER_scheduler_work(CPUState *cpu, run_on_cpu_data data)
+{
+    ScheduledEdge *edge = data.host_ptr;
+
+    if (edge->generation == scheduler_generation)
+    {
+        FIESER_dcls_inject_begin(cpu);
+        FIESER_scheduler_edge(&scheduled_faults[edge->slot], cpu->env_ptr);
+        FIESER_dcls_inject_end(cpu);
+    }
+
+    g_free(edge);
+}
+
+/**
+ * Passes an edge of a scheduled fault from the main loop to the CPU. The
+ * edges of faults in devices are evaluated right away, as the devices are
+ * serialized by the BQL, which is held by the timer.
+ *
+ * @param[in] opaque - the scheduled fault.
+ */
+static void FIESER_scheduler_timer(void *opaque)
+{
+    ScheduledFault *scheduled = opaque;
+    ScheduledEdge *edge;
+
+    if (FIESER_scheduler_device_fault(scheduled->fault))
+    {
+        FIESER_scheduler_edge(scheduled, NULL);
+        return;
+    }
+
+    edge = g_new(ScheduledEdge, 1);
+    edge->generation = scheduler_generation;
+    edge->slot = scheduled - scheduled_faults;
+    async_run_on_cpu(first_cpu, FIESER_scheduler_work, RUN_ON_CPU_HOST_PTR(edge));
+}
+
+/**
+ * Checks if all faults of the fault list are scheduled. The AArch32
+ * translator then emits no fault controller helper after each instruction,
+ * as the scheduled faults are applied by their timers.
+ *
+ * @param[out] - true if the fault list holds only scheduled faults.
+ */
+bool FIESER_scheduler_exclusive(void)
+{
+    return scheduler_exclusive;
+}
+
+/**
+ * Creates a timer for each scheduled fault of the fault list, which fires
+ * at the next activation edge of the fault. Permanent faults and faults,
+ * which are active already, are injected once right away. Has to be called
+ * whenever the fault list is (re)loaded.
+ */
+void FIESER_scheduler_build(void)
+{
+    ScheduledFault *scheduled;
+    FaultList *fault;
+    bool was_exclusive = scheduler_exclusive;
+    int element, n = 0;
+
+    scheduler_generation++;
+
+    for (element = 0; element < num_scheduled_faults; element++)
+    {
+        timer_del(scheduled_faults[element].timer);
+        timer_free(scheduled_faults[element].timer);
+    }
+
+    g_free(scheduled_faults);
+    scheduled_faults = NULL;
+    num_scheduled_faults = 0;
+    scheduler_exclusive = false;
+
+    if (!first_cpu || !getNumFaultListElements())
+        goto out;
+
+    scheduled_faults = g_new0(ScheduledFault, getNumFaultListElements());
+
+    for (element = 0; element < getNumFaultListElements(); element++)
+    {
+        fault = getFaultListElement(element);
+
+        if (!FIESER_index_scheduled_fault(fault))
+            continue;
+
+        scheduled = &scheduled_faults[n++];
+        scheduled->fault = fault;
+        scheduled->timer = timer_new_ns(QEMU_CLOCK_VIRTUAL, FIESER_scheduler_timer,
+                                        scheduled);
+
+        /**
+         * a fault, which is already active when the fault list is loaded,
+         * has its rising edge right away
+         */
+        if (FIESER_fault_active(fault))
+            timer_mod(scheduled->timer, qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL));
+        else
+            FIESER_scheduler_arm(scheduled);
+    }
+
+    num_scheduled_faults = n;
+    scheduler_exclusive = n == getNumFaultListElements();
+
+out:
+    /**
+     * the translated code has to be rebuilt, if it lacks the helpers after
+     * each instruction, which the new fault list needs, or vice versa
+     */
+    if (first_cpu && scheduler_exclusive != was_exclusive)
+        tb_flush(first_cpu);
+}
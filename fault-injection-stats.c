@@ -0,0 +1,200 @@
+/*
+ * fault-injection-stats.c
+ *
+ *  FIESer by Christian M. Fuchs 2017/2018
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+#include "qemu/log.h"
+#include "qemu/error-report.h"
+#include "qemu/memfd.h"
+#include "cpu.h"
+#include "tcg/tcg-op.h"
+
+#include "fault-injection-stats.h"
+
+/**
+ * Special path argument, which publishes the segment in an
+ * anonymous memfd instead of a file.
+ */
+#define FIES_STATS_MEMFD "memfd"
+
+FIESStatsSegment *fies_stats;
+
+/**
+ * Maps a file-backed statistics segment.
+ *
+ * @param[in] path - the file, which should hold the segment.
+ * @param[out] the mapped segment or NULL on failure.
+ */
+static FIESStatsSegment *FIESER_stats_map_file(const char *path)
+{
+    void *ptr;
+    int fd;
+
+    fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        qemu_log("FIESER: Could not open statistics file %s: %s\n",
+                 path, strerror(errno));
+        return NULL;
+    }
+
+    if (ftruncate(fd, sizeof(FIESStatsSegment)))
+    {
+        qemu_log("FIESER: Could not size statistics file %s: %s\n",
+                 path, strerror(errno));
+        close(fd);
+        return NULL;
+    }
+
+    ptr = mmap(NULL, sizeof(FIESStatsSegment), PROT_READ | PROT_WRITE,
+               MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (ptr == MAP_FAILED)
+    {
+        qemu_log("FIESER: Could not map statistics file %s: %s\n",
+                 path, strerror(errno));
+        return NULL;
+    }
+
+    info_report("FIESER: Statistics published in %s", path);
+
+    return ptr;
+}
+
+/**
+ * Maps a memfd-backed statistics segment. External tools find it
+ * through /proc/<pid>/fd/<fd>, which is logged once.
+ *
+ * @param[out] the mapped segment or NULL on failure.
+ */
+static FIESStatsSegment *FIESER_stats_map_memfd(void)
+{
+    void *ptr;
+    int fd = -1;
+
+    ptr = qemu_memfd_alloc("fies-stats", sizeof(FIESStatsSegment), 0, &fd);
+    if (!ptr)
+    {
+        qemu_log("FIESER: Could not allocate statistics memfd\n");
+        return NULL;
+    }
+
+    info_report("FIESER: Statistics published in /proc/%d/fd/%d",
+                (int) getpid(), fd);
+
+    return ptr;
+}
+
+/**
+ * Publishes the FIES statistics segment. Is called once from the
+ * main-function if the argument-vector (argv) contains the
+ * parameter "-fi-stats".
+ *
+ * @param[in] path - the file to map or "memfd" for an anonymous memfd.
+ * @param[out] 0 on success, -1 on failure.
+ */
+int FIESER_stats_init(const char *path)
+{
+    FIESStatsSegment *s;
+
+    if (fies_stats)
+        return 0;
+
+    if (!strcmp(path, FIES_STATS_MEMFD))
+        s = FIESER_stats_map_memfd();
+    else
+        s = FIESER_stats_map_file(path);
+
+    if (!s)
+        return -1;
+
+    memset(s, 0, sizeof(*s));
+    s->version = FIES_STATS_VERSION;
+    s->size = sizeof(*s);
+    s->phase = FIES_PHASE_IDLE;
+    s->pid = getpid();
+
+    /**
+     * the magic is written last, readers treat the segment as
+     * valid only afterwards
+     */
+    smp_wmb();
+    atomic_set(&s->magic, FIES_STATS_MAGIC);
+
+    fies_stats = s;
+
+    return 0;
+}
+
+/**
+ * Publishes the current phase of the fault injection experiment.
+ *
+ * @param[in] phase - the new phase.
+ */
+void FIESER_stats_set_phase(FIESStatsPhase phase)
+{
+    if (fies_stats)
+        atomic_set(&fies_stats->phase, phase);
+}
+
+/**
+ * Counts a finished fault injection experiment. An experiment
+ * finishes if it is replaced by a newly loaded fault library or
+ * when QEMU terminates while it is running.
+ */
+void FIESER_stats_experiment_completed(void)
+{
+    FIESStatsSegment *s = fies_stats;
+
+    if (s)
+        atomic_set__nocheck(&s->experiments_completed,
+                            s->experiments_completed + 1);
+}
+
+/**
+ * Emits the increment of the guest instruction counter for the
+ * instruction currently being translated. The count is kept in
+ * translated code, so it is available for golden runs, which do
+ * not invoke any hooks. Each vCPU counts into its own CPUState,
+ * as the vCPUs of MTTCG would race on a shared counter, see
+ * FIESER_stats_publish_insns.
+ */
+void FIESER_stats_gen_count_insn(void)
+{
+    TCGv_i64 count = tcg_temp_new_i64();
+
+    tcg_gen_ld_i64(count, cpu_env,
+                   -ENV_OFFSET + offsetof(CPUState, fies_insns));
+    tcg_gen_addi_i64(count, count, 1);
+    tcg_gen_st_i64(count, cpu_env,
+                   -ENV_OFFSET + offsetof(CPUState, fies_insns));
+
+    tcg_temp_free_i64(count);
+}
+
+/**
+ * Adds the guest instructions, which a vCPU executed since its last
+ * call, to the published statistics. Is called by the thread of the
+ * vCPU, whenever it leaves the execution loop.
+ *
+ * @param[in] cpu - the vCPU.
+ */
+void FIESER_stats_publish_insns(CPUState *cpu)
+{
+    FIESStatsSegment *s = fies_stats;
+
+    if (s && cpu->fies_insns)
+    {
+        atomic_add(&s->guest_insns, cpu->fies_insns);
+        cpu->fies_insns = 0;
+    }
+}
@@ -0,0 +1,101 @@
+/*
+ * fault-injection-stats.h
+ *
+ *  FIESer by Christian M. Fuchs 2017/2018
+ *
+ *  Created on: 18.10.2026
+ *      Author: agent
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#ifndef FAULT_INJECTION_STATS_H_
+#define FAULT_INJECTION_STATS_H_
+
+#include "qemu/osdep.h"
+#include "qemu/atomic.h"
+
+#include "fault-injection-enums.h"
+
+/**
+ * Identifies a FIES statistics segment ("FIES" in little endian).
+ * Readers must check magic and version before interpreting the
+ * remainder of the segment.
+ */
+#define FIES_STATS_MAGIC   0x53454946
+#define FIES_STATS_VERSION 2
+
+/**
+ * The phase a FIES worker is currently in.
+ */
+typedef enum {
+    FIES_PHASE_IDLE = 0,
+    FIES_PHASE_LOADING,
+    FIES_PHASE_RUNNING,
+    FIES_PHASE_TERMINATING
+} FIESStatsPhase;
+
+/**
+ * Layout of the shared statistics segment. All fields are
+ * naturally aligned, written by QEMU only and may be read by
+ * external tools at any time without locking; counters only
+ * ever increase. The layout must only be extended at its end
+ * and FIES_STATS_VERSION bumped accordingly.
+ */
+typedef struct FIESStatsSegment {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;
+    uint32_t phase;
+    uint64_t pid;
+    uint64_t hook_calls[FI_INJECTION_MODE_MAX];
+    uint64_t faults_activated;
+    uint64_t experiments_completed;
+    uint64_t guest_insns;     /* counted in translated code per vCPU */
+} FIESStatsSegment;
+
+/**
+ * The published segment, NULL if statistics are not exported.
+ */
+extern FIESStatsSegment *fies_stats;
+
+/**
+ * see corresponding c-file for documentation
+ */
+int FIESER_stats_init(const char *path);
+void FIESER_stats_set_phase(FIESStatsPhase phase);
+void FIESER_stats_experiment_completed(void);
+void FIESER_stats_gen_count_insn(void);
+void FIESER_stats_publish_insns(CPUState *cpu);
+
+/**
+ * Counts a single FIESER_hook invocation. Counters have a single
+ * writer (the TCG thread holding the FIES state), hence a plain
+ * store suffices; it only has to be atomic towards readers.
+ *
+ * @param[in] injection_mode - the mode FIESER_hook was called with.
+ */
+static inline void FIESER_stats_count_hook(InjectionMode injection_mode)
+{
+    FIESStatsSegment *s = fies_stats;
+
+    if (likely(!s))
+        return;
+
+    atomic_set__nocheck(&s->hook_calls[injection_mode],
+                        s->hook_calls[injection_mode] + 1);
+}
+
+/**
+ * Counts the first activation of a fault within an experiment.
+ */
+static inline void FIESER_stats_count_activation(void)
+{
+    FIESStatsSegment *s = fies_stats;
+
+    if (s)
+        atomic_set__nocheck(&s->faults_activated, s->faults_activated + 1);
+}
+
+#endif /* FAULT_INJECTION_STATS_H_ */
@@ -26,6 +26,22 @@ STEXI
 @item info faults
 @findex info faults
 Show all injected faults.
+ETEXI
+
+    {
+        .name       = "fies-overhead",
+        .args_type  = "",
+        .params     = "",
+        .help       = "show the overhead of the fault injection hooks",
+        .cmd        = hmp_info_fies_overhead,
+    },
+
+STEXI
+@item info fies-overhead
+@findex info fies-overhead
+Show the number of fault injection hook invocations per call site and
+injection mode. With @code{-profiling t} the host cycles spent in the hooks,
+in profiler logging, TLB flushes and fault-list walks are shown as well.
 ETEXI
 
     {
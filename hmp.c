@@ -99,9 +99,6 @@ void hmp_fault_reload(Monitor *mon, const QDict *qdict)
 
     qmp_fault_reload(mon, filename, &errp);
     hmp_handle_error(mon, &errp);
-
-    if (fault_library_name)
-      free(fault_library_name);
 }
 
 void hmp_info_faults(Monitor *mon, const QDict *qdict)
@@ -157,13 +154,16 @@ void hmp_info_faults(Monitor *mon, const QDict *qdict)
     		monitor_printf(mon, "\tcf_address: 0x%x\n", (int) fault->value->params->cf_address);
 
     	if (fault->value->params->mask != -1)
-    		monitor_printf(mon, "\tmask: 0x%x\n", (int) fault->value->params->mask);
+    		monitor_printf(mon, "\tmask: 0x%" PRIx64 "\n", (uint64_t) fault->value->params->mask);
 
     	if (fault->value->params->instruction != -1)
     		monitor_printf(mon, "\tinstruction address: 0x%x\n", (int) fault->value->params->instruction);
 
     	if (fault->value->params->set_bit != -1)
-    		monitor_printf(mon, "\tset bit: 0x%x\n", (int) fault->value->params->set_bit);
+    		monitor_printf(mon, "\tset bit: 0x%" PRIx64 "\n", (uint64_t) fault->value->params->set_bit);
+
+    	monitor_printf(mon, "\twidth: %" PRId64 "\n", fault->value->params->width);
+    	monitor_printf(mon, "\tburst: %" PRId64 "\n", fault->value->params->burst);
 
     	monitor_printf(mon, "active: %d\n", (int) fault->value->is_active);
 
@@ -256,6 +256,38 @@ void hmp_info_faults(Monitor *mon, const QDict *qdict)
     qapi_free_FaultInfoList(fault_list);
 }
 
+void hmp_info_fies_overhead(Monitor *mon, const QDict *qdict)
+{
+    FiesOverheadInfo *info = qmp_query_fies_overhead(NULL);
+    FiesOverheadSiteInfoList *site;
+
+    monitor_printf(mon, "%-20s %-26s %14s %16s\n",
+                   "Call site", "Injection mode", "Calls", "Host cycles");
+    monitor_printf(mon, "--------------------------------------------------------------------------------\n");
+
+    for (site = info->sites; site; site = site->next)
+    {
+        monitor_printf(mon, "%-20s %-26s %14" PRId64 " %16" PRId64 "\n",
+                       site->value->site, site->value->mode,
+                       site->value->calls, site->value->cycles);
+    }
+
+    monitor_printf(mon, "--------------------------------------------------------------------------------\n");
+
+    if (!info->timing)
+    {
+        monitor_printf(mon, "Host-cycle timing disabled, use -profiling t\n");
+    }
+    else
+    {
+        monitor_printf(mon, "Profiler \t\t\t | %" PRId64 "\n", info->profiler_cycles);
+        monitor_printf(mon, "TLB flush \t\t\t | %" PRId64 "\n", info->tlb_flush_cycles);
+        monitor_printf(mon, "Fault list \t\t\t | %" PRId64 "\n", info->fault_list_cycles);
+    }
+
+    qapi_free_FiesOverheadInfo(info);
+}
+
 void hmp_info_kvm(Monitor *mon, const QDict *qdict)
 {
     KvmInfo *info;
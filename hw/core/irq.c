@@ -146,6 +146,25 @@ void qemu_irq_intercept_in(qemu_irq *gpio_in, qemu_irq_handler handler, int n)
     }
 }
 
+// CF FIES
+qemu_irq qemu_irq_fies_intercept(qemu_irq irq, qemu_irq_handler handler,
+                                 void *opaque)
+{
+    qemu_irq orig = qemu_allocate_irq(irq->handler, irq->opaque, irq->n);
+
+    irq->handler = handler;
+    irq->opaque = opaque;
+    return orig;
+}
+
+void qemu_irq_fies_restore(qemu_irq irq, qemu_irq orig)
+{
+    irq->handler = orig->handler;
+    irq->opaque = orig->opaque;
+    qemu_free_irq(orig);
+}
+// CF FIES END
+
 static const TypeInfo irq_type_info = {
    .name = TYPE_IRQ,
    .parent = TYPE_OBJECT,
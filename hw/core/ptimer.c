@@ -30,12 +30,43 @@ struct ptimer_state
     uint8_t policy_mask;
     QEMUBH *bh;
     QEMUTimer *timer;
+    // CF FIES
+    unsigned int fies_index;
+    bool fies_skip;
+    bool fies_stuck;
+    uint64_t fies_stuck_count;
+    int64_t fies_drift_ppm;
+    // CF FIES END
 };
 
+// CF FIES
+/* All ptimers in the order of their creation, freed ones are NULL.  */
+static GPtrArray *fies_ptimers;
+
+/* Scale the period by the drift of a fault injection experiment.  */
+static void ptimer_fies_drift(ptimer_state *s, uint64_t *period,
+                              uint32_t *period_frac)
+{
+    uint64_t frac;
+    uint32_t scale;
+
+    if (!s->fies_drift_ppm) {
+        return;
+    }
+
+    scale = 1000000 + s->fies_drift_ppm;
+    frac = muldiv64(*period_frac, scale, 1000000);
+    *period = muldiv64(*period, scale, 1000000) + (frac >> 32);
+    *period_frac = frac;
+}
+// CF FIES END
+
 /* Use a bottom-half routine to avoid reentrancy issues.  */
 static void ptimer_trigger(ptimer_state *s)
 {
-    if (s->bh) {
+    // CF FIES
+    if (s->bh && !s->fies_skip) {
+    // CF FIES END
         replay_bh_schedule_event(s->bh);
     }
 }
@@ -46,6 +77,15 @@ static void ptimer_reload(ptimer_state *s, int delta_adjust)
     uint64_t period = s->period;
     uint64_t delta = s->delta;
 
+    // CF FIES
+    /* A stuck counter neither counts nor expires.  */
+    if (s->fies_stuck) {
+        timer_del(s->timer);
+        return;
+    }
+    ptimer_fies_drift(s, &period, &period_frac);
+    // CF FIES END
+
     if (delta == 0 && !(s->policy_mask & PTIMER_POLICY_NO_IMMEDIATE_TRIGGER)) {
         ptimer_trigger(s);
     }
@@ -157,6 +197,12 @@ uint64_t ptimer_get_count(ptimer_state *s)
 {
     uint64_t counter;
 
+    // CF FIES
+    if (s->fies_stuck) {
+        return s->fies_stuck_count;
+    }
+    // CF FIES END
+
     if (s->enabled && s->delta != 0) {
         int64_t now = qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL);
         int64_t next = s->next_event;
@@ -177,6 +223,10 @@ uint64_t ptimer_get_count(ptimer_state *s)
             uint32_t period_frac = s->period_frac;
             uint64_t period = s->period;
 
+            // CF FIES
+            ptimer_fies_drift(s, &period, &period_frac);
+            // CF FIES END
+
             if (!oneshot && (s->delta * period < 10000) && !use_icount) {
                 period = 10000 / s->delta;
                 period_frac = 0;
@@ -353,12 +403,59 @@ ptimer_state *ptimer_init(QEMUBH *bh, uint8_t policy_mask)
     s->bh = bh;
     s->timer = timer_new_ns(QEMU_CLOCK_VIRTUAL, ptimer_tick, s);
     s->policy_mask = policy_mask;
+    // CF FIES
+    if (!fies_ptimers) {
+        fies_ptimers = g_ptr_array_new();
+    }
+    s->fies_index = fies_ptimers->len;
+    g_ptr_array_add(fies_ptimers, s);
+    // CF FIES END
     return s;
 }
 
 void ptimer_free(ptimer_state *s)
 {
+    // CF FIES
+    g_ptr_array_index(fies_ptimers, s->fies_index) = NULL;
+    // CF FIES END
     qemu_bh_delete(s->bh);
     timer_free(s->timer);
     g_free(s);
 }
+
+// CF FIES
+unsigned int ptimer_fies_count(void)
+{
+    return fies_ptimers ? fies_ptimers->len : 0;
+}
+
+ptimer_state *ptimer_fies_lookup(unsigned int index)
+{
+    if (index >= ptimer_fies_count()) {
+        return NULL;
+    }
+    return g_ptr_array_index(fies_ptimers, index);
+}
+
+void ptimer_fies_set(ptimer_state *s, bool skip, bool stuck, int64_t drift_ppm)
+{
+    uint64_t count;
+
+    s->fies_skip = skip;
+
+    if (stuck == s->fies_stuck && drift_ppm == s->fies_drift_ppm) {
+        return;
+    }
+
+    /* Continue from the current count with the new period, or hold it.  */
+    count = ptimer_get_count(s);
+    s->fies_stuck = stuck;
+    s->fies_stuck_count = count;
+    s->fies_drift_ppm = drift_ppm;
+    s->delta = count;
+    if (s->enabled) {
+        s->next_event = qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL);
+        ptimer_reload(s, 0);
+    }
+}
+// CF FIES END
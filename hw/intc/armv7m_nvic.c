@@ -22,6 +22,9 @@
 #include "exec/exec-all.h"
 #include "qemu/log.h"
 #include "trace.h"
+// CF FIES
+#include "fault-injection-nvic.h"
+// CF FIES END
 
 /* IRQ number counting:
  *
@@ -457,6 +460,9 @@ static void nvic_irq_update(NVICState *s)
     int lvl;
     int pend_prio;
 
+    // CF FIES
+    FIESER_hook_nvic(s);
+    // CF FIES END
     nvic_recompute_state(s);
     pend_prio = nvic_pending_prio(s);
 
@@ -471,6 +477,14 @@ static void nvic_irq_update(NVICState *s)
     qemu_set_irq(s->excpout, lvl);
 }
 
+// CF FIES
+/* Recompute state after a fault was injected into the vectors.  */
+void armv7m_nvic_fies_update(void *opaque)
+{
+    nvic_irq_update(opaque);
+}
+// CF FIES END
+
 /**
  * armv7m_nvic_clear_pending: mark the specified exception as not pending
  * @opaque: the NVIC
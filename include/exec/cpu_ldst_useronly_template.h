@@ -25,6 +25,9 @@
 
 #if !defined(CODE_ACCESS)
 #include "trace-root.h"
+// CF FIES
+#include "fault-injection-controller.h"
+// CF FIES END
 #endif
 
 #include "trace/mem.h"
@@ -64,8 +67,14 @@ glue(glue(cpu_ld, USUFFIX), MEMSUFFIX)(CPUArchState *env, target_ulong ptr)
     trace_guest_mem_before_exec(
         ENV_GET_CPU(env), ptr,
         trace_mem_build_info(DATA_SIZE, false, MO_TE, false));
-#endif
+    // CF FIES
+    return FIESER_hook_mem(env, ptr, glue(glue(ld, USUFFIX), _p)(g2h(ptr)),
+                           DATA_SIZE, MO_TE == MO_BE, read_access_type,
+                           FI_SITE_USER_LDST);
+    // CF FIES END
+#else
     return glue(glue(ld, USUFFIX), _p)(g2h(ptr));
+#endif
 }
 
 static inline RES_TYPE
@@ -88,8 +97,15 @@ glue(glue(cpu_lds, SUFFIX), MEMSUFFIX)(CPUArchState *env, target_ulong ptr)
     trace_guest_mem_before_exec(
         ENV_GET_CPU(env), ptr,
         trace_mem_build_info(DATA_SIZE, true, MO_TE, false));
-#endif
+    // CF FIES
+    return (DATA_STYPE)FIESER_hook_mem(env, ptr,
+                                       (DATA_TYPE)glue(glue(lds, SUFFIX), _p)(g2h(ptr)),
+                                       DATA_SIZE, MO_TE == MO_BE,
+                                       read_access_type, FI_SITE_USER_LDST);
+    // CF FIES END
+#else
     return glue(glue(lds, SUFFIX), _p)(g2h(ptr));
+#endif
 }
 
 static inline int
@@ -115,6 +131,10 @@ glue(glue(cpu_st, SUFFIX), MEMSUFFIX)(CPUArchState *env, target_ulong ptr,
         ENV_GET_CPU(env), ptr,
         trace_mem_build_info(DATA_SIZE, false, MO_TE, true));
 #endif
+    // CF FIES
+    v = FIESER_hook_mem(env, ptr, (DATA_TYPE)v, DATA_SIZE, MO_TE == MO_BE,
+                        write_access_type, FI_SITE_USER_LDST);
+    // CF FIES END
     glue(glue(st, SUFFIX), _p)(g2h(ptr), v);
 }
 
@@ -350,6 +350,11 @@ struct TranslationBlock {
     /* Per-vCPU dynamic tracing state used to generate this TB */
     uint32_t trace_vcpu_dstate;
 
+    // CF FIES
+    /* Set if the TB accesses the VFP/NEON registers */
+    bool fies_vfp;
+    // CF FIES END
+
     struct tb_tc tc;
 
     /* original tb when cflags has CF_NOCACHE */
@@ -403,6 +408,9 @@ static inline uint32_t curr_cflags(void)
 
 void tb_remove(TranslationBlock *tb);
 void tb_flush(CPUState *cpu);
+// CF FIES
+void tb_flush_exclusive(CPUState *cpu);
+// CF FIES END
 void tb_phys_invalidate(TranslationBlock *tb, tb_page_addr_t page_addr);
 TranslationBlock *tb_htable_lookup(CPUState *cpu, target_ulong pc,
                                    target_ulong cs_base, uint32_t flags,
@@ -89,4 +89,9 @@ typedef struct NVICState {
     SysTickState systick[M_REG_NUM_BANKS];
 } NVICState;
 
+// CF FIES
+/* Recompute the pending exception after a fault injection into vectors[].  */
+void armv7m_nvic_fies_update(void *opaque);
+// CF FIES END
+
 #endif
@@ -62,4 +62,13 @@ qemu_irq *qemu_irq_proxy(qemu_irq **target, int n);
    on an existing vector of qemu_irq.  */
 void qemu_irq_intercept_in(qemu_irq *gpio_in, qemu_irq_handler handler, int n);
 
+// CF FIES
+/* For fault injection: intercept a single line, so that it invokes handler
+ * with opaque and its own line number.  The returned irq invokes the
+ * original handler, until it is passed to qemu_irq_fies_restore().  */
+qemu_irq qemu_irq_fies_intercept(qemu_irq irq, qemu_irq_handler handler,
+                                 void *opaque);
+void qemu_irq_fies_restore(qemu_irq irq, qemu_irq orig);
+// CF FIES END
+
 #endif
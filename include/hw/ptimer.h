@@ -190,6 +190,33 @@ void ptimer_run(ptimer_state *s, int oneshot);
  */
 void ptimer_stop(ptimer_state *s);
 
+// CF FIES
+/**
+ * ptimer_fies_count - Get the number of ptimers created so far
+ */
+unsigned int ptimer_fies_count(void);
+
+/**
+ * ptimer_fies_lookup - Get a ptimer by the order of its creation
+ * @index: the number of the ptimer, starting at 0
+ *
+ * Returns NULL if the ptimer does not exist (anymore).
+ */
+ptimer_state *ptimer_fies_lookup(unsigned int index);
+
+/**
+ * ptimer_fies_set - Set the faults of a ptimer
+ * @s: ptimer
+ * @skip: if true, expiries do not invoke the bottom half
+ * @stuck: if true, the count is held at its current value
+ * @drift_ppm: deviation of the period in parts per million
+ *
+ * The ptimer continues from its current count, when it becomes unstuck
+ * or its drift changes.
+ */
+void ptimer_fies_set(ptimer_state *s, bool skip, bool stuck, int64_t drift_ppm);
+// CF FIES END
+
 extern const VMStateDescription vmstate_ptimer;
 
 #define VMSTATE_PTIMER(_field, _state) \
@@ -407,6 +407,12 @@ struct CPUState {
 
     bool ignore_memory_transaction_failures;
 
+    // CF FIES
+    /* Guest instructions executed since they were last added to the
+       published statistics. Only the thread of the vCPU writes it.  */
+    uint64_t fies_insns;
+    // CF FIES END
+
     /* Note that this is accessed at the start of every TB via a negative
        offset from AREG0.  Leave this field at the end so as to make the
        (absolute value) offset as small as possible.  This reduces code
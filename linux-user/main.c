@@ -35,6 +35,10 @@
 #include "elf.h"
 #include "exec/log.h"
 #include "trace/control.h"
+// CF FIES
+#include "fault-injection-config.h"
+#include "fault-injection-stats.h"
+// CF FIES END
 
 char *exec_path;
 
@@ -48,6 +52,14 @@ unsigned long mmap_min_addr;
 unsigned long guest_base;
 int have_guest_base;
 
+// CF FIES
+unsigned int profile_ram_addresses = 0;
+unsigned int profile_pc_status = 0;
+unsigned int profile_registers = 0;
+unsigned int profile_condition_flags = 0;
+unsigned int profile_hook_overhead = 0;
+// CF FIES END
+
 #define EXCP_DUMP(env, fmt, ...)                                        \
 do {                                                                    \
     CPUState *cs = ENV_GET_CPU(env);                                    \
@@ -4048,6 +4060,24 @@ static void handle_arg_trace(const char *arg)
     trace_file = trace_opt_parse(arg);
 }
 
+// CF FIES
+static void handle_arg_fi(const char *arg)
+{
+    g_free(fault_library_name);
+    fault_library_name = g_strdup(arg);
+    FIESER_enable();
+}
+
+static void handle_arg_fi_stats(const char *arg)
+{
+    if (FIESER_stats_init(arg)) {
+        fprintf(stderr, "qemu: could not publish FIES statistics in %s\n",
+                arg);
+        exit(EXIT_FAILURE);
+    }
+}
+// CF FIES END
+
 struct qemu_argument {
     const char *argv;
     const char *env;
@@ -4101,6 +4131,12 @@ static const struct qemu_argument arg_table[] = {
      "",           "[[enable=]<pattern>][,events=<file>][,file=<file>]"},
     {"version",    "QEMU_VERSION",     false, handle_arg_version,
      "",           "display version information and exit"},
+    // CF FIES
+    {"fi",         "QEMU_FI",          true,  handle_arg_fi,
+     "file",       "inject the faults of the fault library 'file'"},
+    {"fi-stats",   "QEMU_FI_STATS",    true,  handle_arg_fi_stats,
+     "path",       "publish FIES statistics in the shared memory 'path'"},
+    // CF FIES END
     {NULL, NULL, false, NULL, NULL, NULL}
 };
 
@@ -4889,6 +4925,9 @@ int main(int argc, char **argv, char **envp)
         }
         gdb_handlesig(cpu, 0);
     }
+    // CF FIES
+    FIESER_init();
+    // CF FIES END
     cpu_loop(env);
     /* never exits */
     return 0;
@@ -25,6 +25,9 @@
 #include "qemu-common.h"
 #include "target_signal.h"
 #include "trace.h"
+// CF FIES
+#include "fault-injection-library.h"
+// CF FIES END
 
 static struct target_sigaltstack target_sigaltstack_used = {
     .ss_sp = 0,
@@ -559,6 +562,9 @@ static void QEMU_NORETURN dump_core_and_abort(int target_sig)
     host_sig = target_to_host_signal(target_sig);
     trace_user_force_sig(env, target_sig, host_sig);
     gdb_signalled(env, target_sig);
+    // CF FIES
+    FIESER_experiment_exit(target_sig);
+    // CF FIES END
 
     /* dump core if supported by target binary format */
     if (core_dump_signal(target_sig) && (ts->bprm->core_dump != NULL)) {
@@ -116,6 +116,9 @@ int __clone2(int (*fn)(void *), void *child_stack_base,
 #include "uname.h"
 
 #include "qemu.h"
+// CF FIES
+#include "fault-injection-library.h"
+// CF FIES END
 
 #ifndef CLONE_IO
 #define CLONE_IO                0x80000000      /* Clone io context */
@@ -7792,6 +7795,9 @@ abi_long do_syscall(void *cpu_env, int num, abi_long arg1,
         _mcleanup();
 #endif
         gdb_exit(cpu_env, arg1);
+        // CF FIES
+        FIESER_experiment_exit(arg1);
+        // CF FIES END
         _exit(arg1);
         ret = 0; /* avoid warning */
         break;
@@ -9867,6 +9873,9 @@ abi_long do_syscall(void *cpu_env, int num, abi_long arg1,
         _mcleanup();
 #endif
         gdb_exit(cpu_env, arg1);
+        // CF FIES
+        FIESER_experiment_exit(arg1);
+        // CF FIES END
         ret = get_errno(exit_group(arg1));
         break;
 #endif
@@ -19,6 +19,17 @@
  * License along with this library; if not, see <http://www.gnu.org/licenses/>.
  */
 
+// CF FIES
+/* The fault controller sees each value in the byte order of its access. */
+#ifndef FIES_BIG_ENDIAN
+#if defined(TARGET_WORDS_BIGENDIAN)
+#define FIES_BIG_ENDIAN(endian) ((endian) != DEVICE_LITTLE_ENDIAN)
+#else
+#define FIES_BIG_ENDIAN(endian) ((endian) == DEVICE_BIG_ENDIAN)
+#endif
+#endif
+// CF FIES END
+
 /* warning: addr must be aligned */
 static inline uint32_t glue(address_space_ldl_internal, SUFFIX)(ARG1_DECL,
     hwaddr addr, MemTxAttrs attrs, MemTxResult *result,
@@ -68,7 +79,7 @@ static inline uint32_t glue(address_space_ldl_internal, SUFFIX)(ARG1_DECL,
         *result = r;
     }
     //CF FIES
-    FIESER_hook(NULL, &addr, ((uint32_t*)&val), FI_MEMORY_CONTENT, read_access_type);
+    val = FIESER_hook_mem(NULL, addr, val, 4, FIES_BIG_ENDIAN(endian), read_access_type, FI_SITE_MEMORY_LDST);
     //CF FIES END
     if (release_lock) {
         qemu_mutex_unlock_iothread();
@@ -166,7 +177,7 @@ static inline uint64_t glue(address_space_ldq_internal, SUFFIX)(ARG1_DECL,
         *result = r;
     }
     //CF FIES
-    FIESER_hook(NULL, &addr, ((uint32_t*)&val), FI_MEMORY_CONTENT, read_access_type);
+    val = FIESER_hook_mem(NULL, addr, val, 8, FIES_BIG_ENDIAN(endian), read_access_type, FI_SITE_MEMORY_LDST);
     //CF FIES END
     if (release_lock) {
         qemu_mutex_unlock_iothread();
@@ -241,6 +252,9 @@ uint32_t glue(address_space_ldub, SUFFIX)(ARG1_DECL,
     if (result) {
         *result = r;
     }
+// CF FIES
+    val = FIESER_hook_mem(NULL, addr, val, 1, false, read_access_type, FI_SITE_MEMORY_LDST);
+// CF FIES END
     if (release_lock) {
         qemu_mutex_unlock_iothread();
     }
@@ -303,7 +317,7 @@ static inline uint32_t glue(address_space_lduw_internal, SUFFIX)(ARG1_DECL,
         *result = r;
     }
 // CF FIES
-    FIESER_hook(NULL, &addr, ((uint32_t*)&val), FI_MEMORY_CONTENT, read_access_type);
+    val = FIESER_hook_mem(NULL, addr, val, 2, FIES_BIG_ENDIAN(endian), read_access_type, FI_SITE_MEMORY_LDST);
 // CF FIES END
     if (release_lock) {
         qemu_mutex_unlock_iothread();
@@ -367,7 +381,7 @@ void glue(address_space_stl_notdirty, SUFFIX)(ARG1_DECL,
 
     RCU_READ_LOCK();
 // CF FIES
-    FIESER_hook(NULL, &addr, &val, FI_MEMORY_CONTENT, write_access_type);
+    val = FIESER_hook_mem(NULL, addr, val, 4, FIES_BIG_ENDIAN(DEVICE_NATIVE_ENDIAN), write_access_type, FI_SITE_MEMORY_LDST);
 // CF FIES END
     
     mr = TRANSLATE(addr, &addr1, &l, true);
@@ -414,7 +428,7 @@ static inline void glue(address_space_stl_internal, SUFFIX)(ARG1_DECL,
 
     RCU_READ_LOCK();
 // CF FIES
-    FIESER_hook(NULL, &addr, &val, FI_MEMORY_CONTENT, write_access_type);
+    val = FIESER_hook_mem(NULL, addr, val, 4, FIES_BIG_ENDIAN(endian), write_access_type, FI_SITE_MEMORY_LDST);
 // CF FIES END
 
     mr = TRANSLATE(addr, &addr1, &l, true);
@@ -507,6 +521,9 @@ void glue(address_space_stb, SUFFIX)(ARG1_DECL,
     bool release_lock = false;
 
     RCU_READ_LOCK();
+// CF FIES
+    val = FIESER_hook_mem(NULL, addr, val, 1, false, write_access_type, FI_SITE_MEMORY_LDST);
+// CF FIES END
     mr = TRANSLATE(addr, &addr1, &l, true);
     if (!IS_DIRECT(mr, true)) {
         release_lock |= prepare_mmio_access(mr);
@@ -547,7 +564,7 @@ static inline void glue(address_space_stw_internal, SUFFIX)(ARG1_DECL,
 
     RCU_READ_LOCK();
 // CF FIES
-    FIESER_hook(NULL, &addr, &val, FI_MEMORY_CONTENT, write_access_type);
+    val = FIESER_hook_mem(NULL, addr, val, 2, FIES_BIG_ENDIAN(endian), write_access_type, FI_SITE_MEMORY_LDST);
 // CF FIES END
 
     mr = TRANSLATE(addr, &addr1, &l, true);
@@ -645,7 +662,7 @@ static void glue(address_space_stq_internal, SUFFIX)(ARG1_DECL,
     mr = TRANSLATE(addr, &addr1, &l, true);
     
     // CF FIES
-    FIESER_hook(NULL, &addr, (uint32_t*)&val, FI_MEMORY_CONTENT, write_access_type);
+    val = FIESER_hook_mem(NULL, addr, val, 8, FIES_BIG_ENDIAN(endian), write_access_type, FI_SITE_MEMORY_LDST);
     // CF FIES END
     
     if (l < 8 || !IS_DIRECT(mr, true)) {
@@ -27,6 +27,42 @@ STEXI
 Activates the fault injection experiment
 ETEXI
 
+DEF("fi-stats", HAS_ARG, QEMU_OPTION_fi_stats,
+    "-fi-stats memfd|file\n"
+    "                publish FIES statistics in a shared memory segment\n", QEMU_ARCH_ALL)
+STEXI
+@item -fi-stats memfd|@var{file}
+@findex -fi-stats
+Publishes the FIES counters (hook invocations per injection mode, activated
+faults, completed experiments, current phase and guest instruction count) in
+a shared memory segment, which external tools can mmap and read without
+querying the monitor. With @code{memfd} an anonymous memfd is used and its
+@code{/proc/<pid>/fd} path is logged, otherwise @var{file} is created and mapped.
+ETEXI
+
+DEF("fi-dcls", 0, QEMU_OPTION_fi_dcls,
+    "-fi-dcls        detect CPU faults by lockstep execution\n", QEMU_ARCH_ALL)
+STEXI
+@item -fi-dcls
+@findex -fi-dcls
+Runs every translation block twice, once with the injected faults and once in
+a fault-free shadow context, and compares the registers, exceptions, stores and
+device accesses of both, like a dual-core lockstep processor. A divergence is
+logged and counted as detected fault. Memory is shared by both contexts, so
+only faults of the CPU can be detected.
+ETEXI
+
+DEF("perfmap", 0, QEMU_OPTION_perfmap,
+    "-perfmap        write a host perf map of translated blocks\n", QEMU_ARCH_ALL)
+STEXI
+@item -perfmap
+@findex -perfmap
+Writes @file{/tmp/perf-<pid>.map}, which lets host @command{perf} attribute
+samples in translated code to the guest PC of each translation block. Blocks
+calling fault injection hooks are labelled @code{guest-tb-fies}, all others
+@code{guest-tb}.
+ETEXI
+
 DEF("profiling", HAS_ARG, QEMU_OPTION_profiling,
     "-profiling  activates profiling of memory/register usage of the binary\n", QEMU_ARCH_ALL)
 STEXI
@@ -40,6 +40,7 @@
 
 // CF FIES
 #include "fault-injection-library.h"
+#include "fault-injection-overhead.h"
 // CF FIES END
 
 NameInfo *qmp_query_name(Error **errp)
@@ -74,7 +75,10 @@ FaultInfoList *qmp_query_faults(Error **err)
         info->value->id = fault->id;
         info->value->component = g_strdup(FaultComponent2STR(fault->component));
         info->value->target = g_strdup(FaultTarget2STR(fault->target));
-        info->value->mode = g_strdup(FaultMode2STR(fault->mode));
+        if (fault->mode == FI_MODE_COUPLING_FAULT)
+            info->value->mode = g_strdup(fault->coupling.name);
+        else
+            info->value->mode = g_strdup(FaultMode2STR(fault->mode));
         info->value->type = g_strdup(FaultType2STR(fault->type));
         info->value->trigger = g_strdup(FaultTrigger2STR(fault->trigger));
         
@@ -87,6 +91,8 @@ FaultInfoList *qmp_query_faults(Error **err)
         info->value->params->mask = fault->params.mask;
         info->value->params->instruction = fault->params.instruction;
         info->value->params->set_bit = fault->params.set_bit;
+        info->value->params->width = fault->params.width;
+        info->value->params->burst = fault->params.burst;
         
         info->value->is_active = fault->was_triggered;
 
@@ -104,6 +110,44 @@ FaultInfoList *qmp_query_faults(Error **err)
 
     return head;
 }
+
+FiesOverheadInfo *qmp_query_fies_overhead(Error **errp)
+{
+    FiesOverheadInfo *info = g_malloc0(sizeof(*info));
+    FiesOverheadSiteInfoList *cur_item = NULL;
+    int site, mode;
+
+    info->timing = profile_hook_overhead;
+    info->profiler_cycles = fies_overhead_phase_cycles[FI_OVERHEAD_PROFILER];
+    info->tlb_flush_cycles = fies_overhead_phase_cycles[FI_OVERHEAD_TLB_FLUSH];
+    info->fault_list_cycles = fies_overhead_phase_cycles[FI_OVERHEAD_FAULT_LIST];
+
+    for (site = 0; site < FI_SITE_MAX; site++)
+    {
+        for (mode = 0; mode < FI_INJECTION_MODE_MAX; mode++)
+        {
+            FiesOverheadSiteInfoList *entry;
+
+            if (!fies_overhead_calls[site][mode])
+                continue;
+
+            entry = g_malloc0(sizeof(*entry));
+            entry->value = g_malloc0(sizeof(*entry->value));
+            entry->value->site = g_strdup(FIESCallSite2STR(site));
+            entry->value->mode = g_strdup(InjectionMode2STR(mode));
+            entry->value->calls = fies_overhead_calls[site][mode];
+            entry->value->cycles = fies_overhead_cycles[site][mode];
+
+            if (!cur_item)
+                info->sites = entry;
+            else
+                cur_item->next = entry;
+            cur_item = entry;
+        }
+    }
+
+    return info;
+}
 // CF FIES END
 
 VersionInfo *qmp_query_version(Error **errp)
@@ -2006,6 +2006,14 @@ static inline bool cp_access_ok(int current_el,
 /* Raw read of a coprocessor register (as needed for migration, etc) */
 uint64_t read_raw_cp_reg(CPUARMState *env, const ARMCPRegInfo *ri);
 
+// CF FIES
+/* Fault injection into the coprocessor registers, which are selected by
+ * their key without the non-secure bank bit (see FI_REG_CP).  */
+bool arm_fies_update_cpregs(ARMCPU *cpu);
+bool arm_fies_read_cpreg(CPUARMState *env, uint32_t regno, uint64_t *value);
+bool arm_fies_write_cpreg(CPUARMState *env, uint32_t regno, uint64_t value);
+// CF FIES END
+
 /**
  * write_list_to_cpustate
  * @cpu: ARMCPU
@@ -20,6 +20,7 @@
 
 // CF FIES
 //extern char is_safe_rtos;
+#include "fault-injection-controller.h"
 // CF FIES END
 
 #ifndef CONFIG_USER_ONLY
@@ -235,6 +236,182 @@ static bool raw_accessors_invalid(const ARMCPRegInfo *ri)
     return true;
 }
 
+// CF FIES
+/* A coprocessor register with a fault controller shim: its original
+ * ARMCPRegInfo (with the original accessors) and its FIES register number.
+ */
+typedef struct FIESCPReg {
+    ARMCPRegInfo orig;
+    uint32_t regno;
+} FIESCPReg;
+
+/* The shimmed registers of all CPUs, indexed by their ARMCPRegInfo in the
+ * cp_regs hashtable of their CPU.  Only modified in exclusive sections.  */
+static GHashTable *fies_cpregs;
+
+static inline FIESCPReg *fies_cpreg(const ARMCPRegInfo *ri)
+{
+    return g_hash_table_lookup(fies_cpregs, ri);
+}
+
+static uint64_t fies_cpreg_read(CPUARMState *env, const ARMCPRegInfo *ri)
+{
+    FIESCPReg *reg = fies_cpreg(ri);
+    const ARMCPRegInfo *orig = &reg->orig;
+    uint64_t value, faulted;
+
+    if (orig->type & ARM_CP_CONST) {
+        value = orig->resetvalue;
+    } else if (orig->readfn) {
+        value = orig->readfn(env, orig);
+    } else {
+        value = raw_read(env, orig);
+    }
+
+    faulted = FIESER_hook_reg(env, reg->regno, value, read_access_type,
+                              FI_SITE_CPREG);
+    trace_arm_fies_cp_reg(reg->regno, read_access_type, value, faulted);
+    return faulted;
+}
+
+static void fies_cpreg_write(CPUARMState *env, const ARMCPRegInfo *ri,
+                             uint64_t value)
+{
+    FIESCPReg *reg = fies_cpreg(ri);
+    const ARMCPRegInfo *orig = &reg->orig;
+    uint64_t faulted;
+
+    faulted = FIESER_hook_reg(env, reg->regno, value, write_access_type,
+                              FI_SITE_CPREG);
+    trace_arm_fies_cp_reg(reg->regno, write_access_type, value, faulted);
+
+    if (orig->type & ARM_CP_CONST) {
+        return;
+    } else if (orig->writefn) {
+        orig->writefn(env, orig, faulted);
+    } else if (orig->fieldoffset) {
+        raw_write(env, orig, faulted);
+    }
+}
+
+/* Migration and KVM synchronization bypass the fault controller.  */
+static uint64_t fies_cpreg_raw_read(CPUARMState *env, const ARMCPRegInfo *ri)
+{
+    return read_raw_cp_reg(env, &fies_cpreg(ri)->orig);
+}
+
+static void fies_cpreg_raw_write(CPUARMState *env, const ARMCPRegInfo *ri,
+                                 uint64_t value)
+{
+    write_raw_cp_reg(env, &fies_cpreg(ri)->orig, value);
+}
+
+/* Install the fault controller shims on the coprocessor registers of a CPU,
+ * for which an access triggered fault is armed, and restore the original
+ * accessors of all others.  The translator emits the get_cp_reg and
+ * set_cp_reg helpers for shimmed registers only, all other registers keep
+ * their direct loads and stores, so the caller has to flush the
+ * translations if this returns true.  Has to be called from an exclusive
+ * section.
+ */
+bool arm_fies_update_cpregs(ARMCPU *cpu)
+{
+    GHashTableIter iter;
+    gpointer key, value;
+    bool changed = false;
+
+    if (!fies_cpregs) {
+        fies_cpregs = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+                                            NULL, g_free);
+    }
+
+    g_hash_table_iter_init(&iter, cpu->cp_regs);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        ARMCPRegInfo *ri = value;
+        uint32_t regno = *(uint32_t *)key & ~CP_REG_NS_MASK;
+        FIESCPReg *reg = fies_cpreg(ri);
+        bool armed = FIESER_register_armed(regno);
+
+        if (reg && !armed) {
+            ri->type = reg->orig.type;
+            ri->readfn = reg->orig.readfn;
+            ri->writefn = reg->orig.writefn;
+            ri->raw_readfn = reg->orig.raw_readfn;
+            ri->raw_writefn = reg->orig.raw_writefn;
+            g_hash_table_remove(fies_cpregs, ri);
+            changed = true;
+        } else if (!reg && armed) {
+            /* Instructions (NOP, WFI, ...) and registers without state */
+            if ((ri->type & ARM_CP_SPECIAL) ||
+                !((ri->type & ARM_CP_CONST) || ri->readfn || ri->fieldoffset)) {
+                continue;
+            }
+
+            reg = g_new(FIESCPReg, 1);
+            reg->orig = *ri;
+            reg->regno = regno;
+            g_hash_table_insert(fies_cpregs, ri, reg);
+
+            ri->type &= ~ARM_CP_CONST;
+            ri->readfn = fies_cpreg_read;
+            ri->writefn = fies_cpreg_write;
+            ri->raw_readfn = fies_cpreg_raw_read;
+            ri->raw_writefn = fies_cpreg_raw_write;
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+/* Look up the instance of a coprocessor register, which the CPU accesses
+ * in its current security state.  */
+static const ARMCPRegInfo *fies_cpreg_lookup(CPUARMState *env, uint32_t regno)
+{
+    ARMCPU *cpu = arm_env_get_cpu(env);
+    const ARMCPRegInfo *ri = NULL;
+    bool aa64 = regno & CP_REG_AA64_MASK;
+
+    if (!aa64 && !arm_is_secure(env)) {
+        ri = get_arm_cp_reginfo(cpu->cp_regs, regno | CP_REG_NS_MASK);
+    }
+    if (!ri) {
+        ri = get_arm_cp_reginfo(cpu->cp_regs, regno);
+    }
+    if (!ri && !aa64) {
+        ri = get_arm_cp_reginfo(cpu->cp_regs, regno | CP_REG_NS_MASK);
+    }
+    if (!ri || (ri->type & (ARM_CP_SPECIAL | ARM_CP_NO_RAW))) {
+        return NULL;
+    }
+    return ri;
+}
+
+/* Read and write a coprocessor register for the injection of time and PC
+ * triggered faults, with the raw accessors used for migration.  */
+bool arm_fies_read_cpreg(CPUARMState *env, uint32_t regno, uint64_t *value)
+{
+    const ARMCPRegInfo *ri = fies_cpreg_lookup(env, regno);
+
+    if (!ri) {
+        return false;
+    }
+    *value = read_raw_cp_reg(env, ri);
+    return true;
+}
+
+bool arm_fies_write_cpreg(CPUARMState *env, uint32_t regno, uint64_t value)
+{
+    const ARMCPRegInfo *ri = fies_cpreg_lookup(env, regno);
+
+    if (!ri) {
+        return false;
+    }
+    write_raw_cp_reg(env, ri, value);
+    return true;
+}
+// CF FIES END
+
 bool write_cpustate_to_list(ARMCPU *cpu)
 {
     /* Write the coprocessor state from cpu->env to the (index,value) list. */
@@ -6023,6 +6200,39 @@ void aarch64_sync_64_to_32(CPUARMState *env)
 
 #else
 
+// CF FIES
+/* Pass the banked registers of a bank saved or restored by a mode switch
+ * through the fault controller.  */
+static void fies_switch_bank(CPUARMState *env, int bank, AccessType access_type)
+{
+    bool save = access_type == write_access_type;
+    uint32_t *r13 = save ? &env->banked_r13[bank] : &env->regs[13];
+    uint32_t *r14 = save ? &env->banked_r14[bank] : &env->regs[14];
+
+    if (FIESER_register_armed(FI_REG_BANKED_SP + bank)) {
+        *r13 = FIESER_hook_reg(env, FI_REG_BANKED_SP + bank, *r13,
+                               access_type, FI_SITE_SWITCH_MODE);
+    }
+    if (FIESER_register_armed(FI_REG_BANKED_LR + bank)) {
+        *r14 = FIESER_hook_reg(env, FI_REG_BANKED_LR + bank, *r14,
+                               access_type, FI_SITE_SWITCH_MODE);
+    }
+    if (!FIESER_register_armed(FI_REG_BANKED_SPSR + bank)) {
+        return;
+    }
+    if (save) {
+        env->banked_spsr[bank] = FIESER_hook_reg(env,
+                                                 FI_REG_BANKED_SPSR + bank,
+                                                 env->banked_spsr[bank],
+                                                 access_type,
+                                                 FI_SITE_SWITCH_MODE);
+    } else {
+        env->spsr = FIESER_hook_reg(env, FI_REG_BANKED_SPSR + bank, env->spsr,
+                                    access_type, FI_SITE_SWITCH_MODE);
+    }
+}
+// CF FIES END
+
 void switch_mode(CPUARMState *env, int mode)
 {
     int old_mode;
@@ -6049,6 +6259,17 @@ void switch_mode(CPUARMState *env, int mode)
     env->regs[13] = env->banked_r13[i];
     env->regs[14] = env->banked_r14[i];
     env->spsr = env->banked_spsr[i];
+
+// CF FIES
+    /* The registers of the old bank are written to and the ones of the new
+     * bank read from the register file.  */
+    if (unlikely(fies_enabled) &&
+        FIESER_register_range_armed(FI_REG_BANKED_SP,
+                                    FI_REG_BANKED_END - FI_REG_BANKED_SP)) {
+        fies_switch_bank(env, bank_number(old_mode), write_access_type);
+        fies_switch_bank(env, i, read_access_type);
+    }
+// CF FIES END
 }
 
 /* Physical Interrupt Target EL Lookup Table
@@ -6177,6 +6398,28 @@ static bool v7m_using_psp(CPUARMState *env)
         env->v7m.control[env->v7m.secure] & R_V7M_CONTROL_SPSEL_MASK;
 }
 
+// CF FIES
+/* The M profile stack pointers and the xPSR (register 16) only call the
+ * fault controller at exception entry and return and in MRS and MSR, if
+ * an access triggered fault is armed for them.  */
+static uint32_t fies_v7m_reg(CPUARMState *env, uint32_t regno, uint32_t value,
+                             AccessType access_type)
+{
+    if (likely(!fies_enabled) || !FIESER_register_armed(regno)) {
+        return value;
+    }
+
+    return FIESER_hook_reg(env, regno, value, access_type, FI_SITE_V7M);
+}
+
+static uint32_t fies_v7m_sp(CPUARMState *env, bool psp, uint32_t value,
+                            AccessType access_type)
+{
+    return fies_v7m_reg(env, psp ? FI_REG_M_PSP : FI_REG_M_MSP, value,
+                        access_type);
+}
+// CF FIES END
+
 /* Write to v7M CONTROL.SPSEL bit for the specified security bank.
  * This may change the current stack pointer between Main and Process
  * stack pointers if it is done for the CONTROL register for the current
@@ -6547,6 +6790,12 @@ static void v7m_push_stack(ARMCPU *cpu)
     CPUARMState *env = &cpu->env;
     uint32_t xpsr = xpsr_read(env);
 
+    // CF FIES
+    env->regs[13] = fies_v7m_sp(env, v7m_using_psp(env), env->regs[13],
+                                read_access_type);
+    xpsr = fies_v7m_reg(env, 16, xpsr, read_access_type);
+    // CF FIES END
+
     /* Align stack pointer if the guest wants that */
     if ((env->regs[13] & 4) &&
         (env->v7m.ccr[env->v7m.secure] & R_V7M_CCR_STKALIGN_MASK)) {
@@ -6816,6 +7065,9 @@ static void do_v7m_exception_exit(ARMCPU *cpu)
         }
 
         xpsr = ldl_phys(cs->as, frameptr + 0x1c);
+        // CF FIES
+        xpsr = fies_v7m_reg(env, 16, xpsr, write_access_type);
+        // CF FIES END
 
         if (arm_feature(env, ARM_FEATURE_V8)) {
             /* For v8M we have to check whether the xPSR exception field
@@ -6851,6 +7103,10 @@ static void do_v7m_exception_exit(ARMCPU *cpu)
         if (xpsr & XPSR_SPREALIGN) {
             frameptr |= 4;
         }
+        // CF FIES
+        frameptr = fies_v7m_sp(env, !return_to_handler && return_to_sp_process,
+                               frameptr, write_access_type);
+        // CF FIES END
         *frame_sp_p = frameptr;
     }
     /* This xpsr_write() will invalidate frame_sp_p as it may switch stack */
@@ -7647,6 +7903,15 @@ static void arm_cpu_do_interrupt_aarch32(CPUState *cs)
      */
     env->uncached_cpsr &= ~PSTATE_SS;
     env->spsr = cpsr_read(env);
+// CF FIES
+    if (unlikely(fies_enabled) &&
+        FIESER_register_armed(FI_REG_BANKED_SPSR + bank_number(new_mode))) {
+        env->spsr = FIESER_hook_reg(env,
+                                    FI_REG_BANKED_SPSR + bank_number(new_mode),
+                                    env->spsr, write_access_type,
+                                    FI_SITE_SWITCH_MODE);
+    }
+// CF FIES END
     /* Clear IT bits.  */
     env->condexec_bits = 0;
     /* Switch to the new mode, and to the correct instruction set.  */
@@ -9974,7 +10239,9 @@ uint32_t HELPER(v7m_mrs)(CPUARMState *env, uint32_t reg)
             mask |= XPSR_NZCV | XPSR_Q; /* APSR */
         }
         /* EPSR reads as zero */
-        return xpsr_read(env) & mask;
+        // CF FIES
+        return fies_v7m_reg(env, 16, xpsr_read(env), read_access_type) & mask;
+        // CF FIES END
         break;
     case 20: /* CONTROL */
         return env->v7m.control[env->v7m.secure];
@@ -10042,9 +10309,17 @@ uint32_t HELPER(v7m_mrs)(CPUARMState *env, uint32_t reg)
 
     switch (reg) {
     case 8: /* MSP */
-        return v7m_using_psp(env) ? env->v7m.other_sp : env->regs[13];
+        // CF FIES
+        return fies_v7m_sp(env, false,
+                           v7m_using_psp(env) ? env->v7m.other_sp : env->regs[13],
+                           read_access_type);
+        // CF FIES END
     case 9: /* PSP */
-        return v7m_using_psp(env) ? env->regs[13] : env->v7m.other_sp;
+        // CF FIES
+        return fies_v7m_sp(env, true,
+                           v7m_using_psp(env) ? env->regs[13] : env->v7m.other_sp,
+                           read_access_type);
+        // CF FIES END
     case 16: /* PRIMASK */
         return env->v7m.primask[env->v7m.secure];
     case 17: /* BASEPRI */
@@ -10142,10 +10417,16 @@ void HELPER(v7m_msr)(CPUARMState *env, uint32_t maskreg, uint32_t val)
             if ((mask & 4) && arm_feature(env, ARM_FEATURE_THUMB_DSP)) {
                 apsrmask |= XPSR_GE;
             }
+            // CF FIES
+            val = fies_v7m_reg(env, 16, val, write_access_type);
+            // CF FIES END
             xpsr_write(env, val, apsrmask);
         }
         break;
     case 8: /* MSP */
+        // CF FIES
+        val = fies_v7m_sp(env, false, val, write_access_type);
+        // CF FIES END
         if (v7m_using_psp(env)) {
             env->v7m.other_sp = val;
         } else {
@@ -10153,6 +10434,9 @@ void HELPER(v7m_msr)(CPUARMState *env, uint32_t maskreg, uint32_t val)
         }
         break;
     case 9: /* PSP */
+        // CF FIES
+        val = fies_v7m_sp(env, true, val, write_access_type);
+        // CF FIES END
         if (v7m_using_psp(env)) {
             env->regs[13] = val;
         } else {
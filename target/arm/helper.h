@@ -3,10 +3,13 @@ DEF_HELPER_FLAGS_1(uxtb16, TCG_CALL_NO_RWG_SE, i32, i32)
 
 // CF FIES
 DEF_HELPER_2(fault_controller_call_time, void, env, i32)
-DEF_HELPER_3(fault_controller_call_pc, void, env, i32, i32)
+DEF_HELPER_3(fault_controller_call_pc, void, env, i64, i32)
 DEF_HELPER_3(fault_controller_call_load_reg, i32, env, i32, i32)
 DEF_HELPER_3(fault_controller_call_store_reg, i32, env, i32, i32)
 DEF_HELPER_2(fault_controller_call_reg_decoder, i32, env, i32)
+DEF_HELPER_3(fault_controller_call_a64_reg, void, env, i32, i32)
+DEF_HELPER_4(fault_controller_call_vfp_reg, i64, env, i64, i32, i32)
+DEF_HELPER_3(fault_controller_call_spsr, i32, env, i32, i32)
 // CF FIES END
 
 DEF_HELPER_3(add_setq, i32, env, i32, i32)
@@ -747,4 +747,15 @@ static inline bool regime_is_secure(CPUARMState *env, ARMMMUIdx mmu_idx)
     }
 }
 
+// CF FIES
+/* Return true if r13 is the process stack pointer of an M profile CPU
+ * (the same as v7m_using_psp() in helper.c).
+ */
+static inline bool arm_fies_v7m_using_psp(CPUARMState *env)
+{
+    return !arm_v7m_is_handler_mode(env) &&
+        env->v7m.control[env->v7m.secure] & R_V7M_CONTROL_SPSEL_MASK;
+}
+// CF FIES END
+
 #endif
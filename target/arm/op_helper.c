@@ -25,6 +25,8 @@
 #include "exec/exec-all.h"
 #include "exec/cpu_ldst.h"
 #include "fault-injection-controller.h"
+#include "fault-injection-dcls.h"
+#include "trace.h"
 
 #define SIGNBIT (uint32_t)0x80000000
 #define SIGNBIT64 ((uint64_t)1 << 63)
@@ -44,63 +46,111 @@ static void raise_exception(CPUARMState *env, uint32_t excp,
 void HELPER(fault_controller_call_time)(CPUARMState *env, uint32_t pc)
 {
     uint64_t pc64 = pc;
-    FIESER_hook(env, &pc64, NULL, FI_TIME, -1);
+    FIESER_hook(env, &pc64, NULL, FI_TIME, -1, FI_SITE_OP_HELPER);
     pc = pc64;
 }
 
-void HELPER(fault_controller_call_pc)(CPUARMState *env, uint32_t pc, uint32_t type)
+void HELPER(fault_controller_call_pc)(CPUARMState *env, uint64_t pc, uint32_t type)
 {
-    uint64_t pc64 = pc;
     InjectionMode t = type;
-    FIESER_hook(env, &pc64, NULL, t, -1);
-    pc = pc64;
+    FIESER_hook(env, &pc, NULL, t, -1, FI_SITE_OP_HELPER);
 }
 
 uint32_t HELPER(fault_controller_call_reg_decoder)(CPUARMState *env, uint32_t regno)
 {
     uint64_t regno64 = regno;
-    FIESER_hook(env, &regno64, NULL, FI_REGISTER_ADDR, -1);
+    FIESER_hook(env, &regno64, NULL, FI_REGISTER_ADDR, -1, FI_SITE_OP_HELPER);
     regno = regno64;
 
     return regno;
 }
 
-uint32_t HELPER(fault_controller_call_store_reg)(CPUARMState *env, uint32_t value_to_write, uint32_t regno)
+/* Banked registers only call the fault controller, if an access triggered
+ * fault is armed for them.  */
+static uint32_t fies_banked_reg(CPUARMState *env, uint32_t regno, uint32_t value, AccessType access_type)
 {
-	uint64_t regno64 = regno;
+    uint32_t faulted;
 
-#if defined(DEBUG_FAULT_CONTROLLER)
-	if (regno == 10)
-		printf("ORIGINAL: write %x to reg %d (initial content: %x)\n", value_to_write, regno, env->regs[regno]);
-#endif
+    if (likely(!fies_enabled) || !FIESER_register_armed(regno)) {
+        return value;
+    }
 
-	FIESER_hook(env, &regno64, &value_to_write, FI_REGISTER_CONTENT, write_access_type);
+    faulted = FIESER_hook_reg(env, regno, value, access_type, FI_SITE_OP_HELPER);
+    trace_arm_fies_banked_reg(regno, access_type, value, faulted);
+    return faulted;
+}
 
-#if defined(DEBUG_FAULT_CONTROLLER)
-	if (regno == 10)
-		printf("AFTER FI: write %x to reg %d (initial content: %x)\n", value_to_write, regno, env->regs[regno]);
-#endif
+/* r13 and r14 are also the SP and LR of the bank of the current mode, r13
+ * of M profile CPUs is the MSP or the PSP.  */
+static uint32_t fies_current_bank_reg(CPUARMState *env, uint32_t regno, uint32_t value, AccessType access_type)
+{
+    if (regno != 13 && regno != 14) {
+        return value;
+    }
 
-	return value_to_write;
+    if (arm_feature(env, ARM_FEATURE_M)) {
+        if (regno != 13) {
+            return value;
+        }
+        return fies_banked_reg(env, arm_fies_v7m_using_psp(env) ? FI_REG_M_PSP : FI_REG_M_MSP,
+                               value, access_type);
+    }
+
+    return fies_banked_reg(env, (regno == 13 ? FI_REG_BANKED_SP : FI_REG_BANKED_LR)
+                           + bank_number(env->uncached_cpsr & CPSR_M),
+                           value, access_type);
+}
+
+uint32_t HELPER(fault_controller_call_store_reg)(CPUARMState *env, uint32_t value_to_write, uint32_t regno)
+{
+    uint64_t regno64 = regno;
+    uint32_t original = value_to_write;
+
+    FIESER_hook(env, &regno64, &value_to_write, FI_REGISTER_CONTENT, write_access_type, FI_SITE_OP_HELPER);
+    value_to_write = fies_current_bank_reg(env, regno, value_to_write, write_access_type);
+    trace_arm_fies_store_reg(regno, env->regs[regno], original, value_to_write);
+
+    return value_to_write;
 }
 
 uint32_t HELPER(fault_controller_call_load_reg)(CPUARMState *env, uint32_t reg_val, uint32_t regno)
 {
     uint64_t regno64 = regno;
+    uint32_t original = reg_val;
 
-#if defined(DEBUG_FAULT_CONTROLLER)
-	if (regno == 10)
-		printf("ORIGINAL: read %x from reg %d\n", reg_val, regno);
-#endif
+    FIESER_hook(env, &regno64, &reg_val, FI_REGISTER_CONTENT, read_access_type, FI_SITE_OP_HELPER);
+    reg_val = fies_current_bank_reg(env, regno, reg_val, read_access_type);
+    trace_arm_fies_load_reg(regno, original, reg_val);
 
-	FIESER_hook(env, &regno64, &reg_val, FI_REGISTER_CONTENT, read_access_type);
+    return reg_val;
+}
 
-#if defined(DEBUG_FAULT_CONTROLLER)
-	if (regno == 10)
-		printf("AFTER FI: read %x from reg %d\n", reg_val, regno);
-#endif
+/* MRS and MSR of the SPSR and the exception returns access the SPSR of the
+ * bank of the current mode.  */
+uint32_t HELPER(fault_controller_call_spsr)(CPUARMState *env, uint32_t value, uint32_t access_type)
+{
+    return fies_banked_reg(env, FI_REG_BANKED_SPSR + bank_number(env->uncached_cpsr & CPSR_M),
+                           value, access_type);
+}
 
-	return reg_val;
+/* The A64 register hooks inject into the architectural register in place,
+ * xregs[31] being the SP.  */
+void HELPER(fault_controller_call_a64_reg)(CPUARMState *env, uint32_t regno, uint32_t access_type)
+{
+    uint64_t original = env->xregs[regno];
+
+    env->xregs[regno] = FIESER_hook_reg(env, regno, original, access_type, FI_SITE_OP_HELPER);
+    trace_arm_fies_a64_reg(regno, access_type, original, env->xregs[regno]);
+}
+
+/* The VFP and NEON register hooks pass the value of a S or D register (or
+ * the FPSCR) as it is transferred by the instruction.  */
+uint64_t HELPER(fault_controller_call_vfp_reg)(CPUARMState *env, uint64_t value, uint32_t regno, uint32_t access_type)
+{
+    uint64_t faulted = FIESER_hook_vfp(env, regno, value, access_type, FI_SITE_OP_HELPER);
+
+    trace_arm_fies_vfp_reg(regno, access_type, value, faulted);
+    return faulted;
 }
 
 static int exception_target_el(CPUARMState *env)
@@ -710,15 +760,27 @@ void HELPER(msr_banked)(CPUARMState *env, uint32_t value, uint32_t tgtmode,
 
     switch (regno) {
     case 16: /* SPSRs */
+        // CF FIES
+        value = fies_banked_reg(env, FI_REG_BANKED_SPSR + bank_number(tgtmode),
+                                value, write_access_type);
+        // CF FIES END
         env->banked_spsr[bank_number(tgtmode)] = value;
         break;
     case 17: /* ELR_Hyp */
         env->elr_el[2] = value;
         break;
     case 13:
+        // CF FIES
+        value = fies_banked_reg(env, FI_REG_BANKED_SP + bank_number(tgtmode),
+                                value, write_access_type);
+        // CF FIES END
         env->banked_r13[bank_number(tgtmode)] = value;
         break;
     case 14:
+        // CF FIES
+        value = fies_banked_reg(env, FI_REG_BANKED_LR + bank_number(tgtmode),
+                                value, write_access_type);
+        // CF FIES END
         env->banked_r14[bank_number(tgtmode)] = value;
         break;
     case 8 ... 12:
@@ -744,13 +806,25 @@ uint32_t HELPER(mrs_banked)(CPUARMState *env, uint32_t tgtmode, uint32_t regno)
 
     switch (regno) {
     case 16: /* SPSRs */
-        return env->banked_spsr[bank_number(tgtmode)];
+        // CF FIES
+        return fies_banked_reg(env, FI_REG_BANKED_SPSR + bank_number(tgtmode),
+                               env->banked_spsr[bank_number(tgtmode)],
+                               read_access_type);
+        // CF FIES END
     case 17: /* ELR_Hyp */
         return env->elr_el[2];
     case 13:
-        return env->banked_r13[bank_number(tgtmode)];
+        // CF FIES
+        return fies_banked_reg(env, FI_REG_BANKED_SP + bank_number(tgtmode),
+                               env->banked_r13[bank_number(tgtmode)],
+                               read_access_type);
+        // CF FIES END
     case 14:
-        return env->banked_r14[bank_number(tgtmode)];
+        // CF FIES
+        return fies_banked_reg(env, FI_REG_BANKED_LR + bank_number(tgtmode),
+                               env->banked_r14[bank_number(tgtmode)],
+                               read_access_type);
+        // CF FIES END
     case 8 ... 12:
         switch (tgtmode) {
         case ARM_CPU_MODE_USR:
@@ -831,11 +905,27 @@ void HELPER(access_check_cp_reg)(CPUARMState *env, void *rip, uint32_t syndrome,
 void HELPER(set_cp_reg)(CPUARMState *env, void *rip, uint32_t value)
 {
     const ARMCPRegInfo *ri = rip;
+    // CF FIES
+    uint64_t written = value;
+    // CF FIES END
 
     if (ri->type & ARM_CP_IO) {
+        // CF FIES
+        /* The shadow context of DCLS mode replays the register accesses
+           with side effects.  */
+        if (unlikely(fies_dcls_active)
+            && FIESER_dcls_io_begin((uintptr_t)ri, 4, &written, true)) {
+            return;
+        }
+        // CF FIES END
         qemu_mutex_lock_iothread();
         ri->writefn(env, ri, value);
         qemu_mutex_unlock_iothread();
+        // CF FIES
+        if (unlikely(fies_dcls_active)) {
+            FIESER_dcls_io_end((uintptr_t)ri, 4, written, true);
+        }
+        // CF FIES END
     } else {
         ri->writefn(env, ri, value);
     }
@@ -845,11 +935,25 @@ uint32_t HELPER(get_cp_reg)(CPUARMState *env, void *rip)
 {
     const ARMCPRegInfo *ri = rip;
     uint32_t res;
+    // CF FIES
+    uint64_t replayed;
+    // CF FIES END
 
     if (ri->type & ARM_CP_IO) {
+        // CF FIES
+        if (unlikely(fies_dcls_active)
+            && FIESER_dcls_io_begin((uintptr_t)ri, 4, &replayed, false)) {
+            return replayed;
+        }
+        // CF FIES END
         qemu_mutex_lock_iothread();
         res = ri->readfn(env, ri);
         qemu_mutex_unlock_iothread();
+        // CF FIES
+        if (unlikely(fies_dcls_active)) {
+            FIESER_dcls_io_end((uintptr_t)ri, 4, res, false);
+        }
+        // CF FIES END
     } else {
         res = ri->readfn(env, ri);
     }
@@ -860,11 +964,27 @@ uint32_t HELPER(get_cp_reg)(CPUARMState *env, void *rip)
 void HELPER(set_cp_reg64)(CPUARMState *env, void *rip, uint64_t value)
 {
     const ARMCPRegInfo *ri = rip;
+    // CF FIES
+    uint64_t written = value;
+    // CF FIES END
 
     if (ri->type & ARM_CP_IO) {
+        // CF FIES
+        /* The shadow context of DCLS mode replays the register accesses
+           with side effects.  */
+        if (unlikely(fies_dcls_active)
+            && FIESER_dcls_io_begin((uintptr_t)ri, 8, &written, true)) {
+            return;
+        }
+        // CF FIES END
         qemu_mutex_lock_iothread();
         ri->writefn(env, ri, value);
         qemu_mutex_unlock_iothread();
+        // CF FIES
+        if (unlikely(fies_dcls_active)) {
+            FIESER_dcls_io_end((uintptr_t)ri, 8, written, true);
+        }
+        // CF FIES END
     } else {
         ri->writefn(env, ri, value);
     }
@@ -874,11 +994,25 @@ uint64_t HELPER(get_cp_reg64)(CPUARMState *env, void *rip)
 {
     const ARMCPRegInfo *ri = rip;
     uint64_t res;
+    // CF FIES
+    uint64_t replayed;
+    // CF FIES END
 
     if (ri->type & ARM_CP_IO) {
+        // CF FIES
+        if (unlikely(fies_dcls_active)
+            && FIESER_dcls_io_begin((uintptr_t)ri, 8, &replayed, false)) {
+            return replayed;
+        }
+        // CF FIES END
         qemu_mutex_lock_iothread();
         res = ri->readfn(env, ri);
         qemu_mutex_unlock_iothread();
+        // CF FIES
+        if (unlikely(fies_dcls_active)) {
+            FIESER_dcls_io_end((uintptr_t)ri, 8, res, false);
+        }
+        // CF FIES END
     } else {
         res = ri->readfn(env, ri);
     }
@@ -36,6 +36,10 @@
 
 #include "trace-tcg.h"
 
+// CF FIES
+#include "../fault-injection-controller.h"
+// CF FIES END
+
 static TCGv_i64 cpu_X[32];
 static TCGv_i64 cpu_pc;
 
@@ -300,8 +304,15 @@ static void gen_exception(int excp, uint32_t syndrome, uint32_t target_el)
     tcg_temp_free_i32(tcg_excp);
 }
 
+// CF FIES
+static void gen_a64_fies_insn_end(DisasContext *s);
+// CF FIES END
+
 static void gen_exception_internal_insn(DisasContext *s, int offset, int excp)
 {
+    // CF FIES
+    gen_a64_fies_insn_end(s);
+    // CF FIES END
     gen_a64_set_pc_im(s->pc - offset);
     gen_exception_internal(excp);
     s->base.is_jmp = DISAS_NORETURN;
@@ -310,6 +321,9 @@ static void gen_exception_internal_insn(DisasContext *s, int offset, int excp)
 static void gen_exception_insn(DisasContext *s, int offset, int excp,
                                uint32_t syndrome, uint32_t target_el)
 {
+    // CF FIES
+    gen_a64_fies_insn_end(s);
+    // CF FIES END
     gen_a64_set_pc_im(s->pc - offset);
     gen_exception(excp, syndrome, target_el);
     s->base.is_jmp = DISAS_NORETURN;
@@ -367,6 +381,10 @@ static inline void gen_goto_tb(DisasContext *s, int n, uint64_t dest)
 {
     TranslationBlock *tb;
 
+    // CF FIES
+    gen_a64_fies_insn_end(s);
+    // CF FIES END
+
     tb = s->base.tb;
     if (use_goto_tb(s, n, dest)) {
         tcg_gen_goto_tb(n);
@@ -435,6 +453,74 @@ static TCGv_i64 new_tmp_a64_zero(DisasContext *s)
     return t;
 }
 
+// CF FIES
+/* Emit the read hook of a register with an armed fault at its first
+ * reference by the current insn; the write hook follows the insn (see
+ * gen_a64_fies_store_regs).  Both inject into the register in place, so
+ * the code of all other registers stays uninstrumented.  */
+static void gen_a64_fies_load_reg(DisasContext *s, int reg)
+{
+    TCGv_i32 tcg_reg, tcg_access;
+
+    if (!s->fies || (s->fies_regs & (1u << reg)) || !FIESER_register_armed(reg)) {
+        return;
+    }
+
+    s->fies_regs |= 1u << reg;
+    tcg_reg = tcg_const_i32(reg);
+    tcg_access = tcg_const_i32(read_access_type);
+    tcg_ctx->fies_instrumented = true;
+    gen_helper_fault_controller_call_a64_reg(cpu_env, tcg_reg, tcg_access);
+    tcg_temp_free_i32(tcg_reg);
+    tcg_temp_free_i32(tcg_access);
+}
+
+static void gen_a64_fies_store_regs(DisasContext *s)
+{
+    TCGv_i32 tcg_reg, tcg_access;
+    int reg;
+
+    if (!s->fies_regs) {
+        return;
+    }
+
+    tcg_access = tcg_const_i32(write_access_type);
+    for (reg = 0; reg < 32; reg++) {
+        if (!(s->fies_regs & (1u << reg))) {
+            continue;
+        }
+        tcg_reg = tcg_const_i32(reg);
+        gen_helper_fault_controller_call_a64_reg(cpu_env, tcg_reg, tcg_access);
+        tcg_temp_free_i32(tcg_reg);
+    }
+    tcg_temp_free_i32(tcg_access);
+}
+
+/* Emit the write hooks and the PC hook of the current insn.  An insn, which
+ * ends the TB itself (a direct branch or an exception), calls this in front
+ * of each of its exits, as nothing after them is reached; a conditional
+ * branch thus emits the hooks once per path.  All other insns get them from
+ * aarch64_tr_translate_insn.  The exits, which aarch64_tr_tb_stop emits
+ * after the last insn, must not repeat them.  */
+static void gen_a64_fies_insn_end(DisasContext *s)
+{
+    if (!s->fies || !s->fies_insn_pending) {
+        return;
+    }
+
+    gen_a64_fies_store_regs(s);
+
+    if (FIESER_pc_armed(s->pc)) {
+        TCGv_i64 tcg_pc = tcg_const_i64(s->pc);
+        TCGv_i32 tcg_type = tcg_const_i32(FI_PC_A64);
+        tcg_ctx->fies_instrumented = true;
+        gen_helper_fault_controller_call_pc(cpu_env, tcg_pc, tcg_type);
+        tcg_temp_free_i64(tcg_pc);
+        tcg_temp_free_i32(tcg_type);
+    }
+}
+// CF FIES END
+
 /*
  * Register access functions
  *
@@ -455,6 +541,7 @@ static TCGv_i64 cpu_reg(DisasContext *s, int reg)
     if (reg == 31) {
         return new_tmp_a64_zero(s);
     } else {
+        gen_a64_fies_load_reg(s, reg);
         return cpu_X[reg];
     }
 }
@@ -462,6 +549,7 @@ static TCGv_i64 cpu_reg(DisasContext *s, int reg)
 /* register access for when 31 == SP */
 static TCGv_i64 cpu_reg_sp(DisasContext *s, int reg)
 {
+    gen_a64_fies_load_reg(s, reg);
     return cpu_X[reg];
 }
 
@@ -473,6 +561,7 @@ static TCGv_i64 read_cpu_reg(DisasContext *s, int reg, int sf)
 {
     TCGv_i64 v = new_tmp_a64(s);
     if (reg != 31) {
+        gen_a64_fies_load_reg(s, reg);
         if (sf) {
             tcg_gen_mov_i64(v, cpu_X[reg]);
         } else {
@@ -487,6 +576,7 @@ static TCGv_i64 read_cpu_reg(DisasContext *s, int reg, int sf)
 static TCGv_i64 read_cpu_reg_sp(DisasContext *s, int reg, int sf)
 {
     TCGv_i64 v = new_tmp_a64(s);
+    gen_a64_fies_load_reg(s, reg);
     if (sf) {
         tcg_gen_mov_i64(v, cpu_X[reg]);
     } else {
@@ -1107,6 +1197,9 @@ static inline bool fp_access_check(DisasContext *s)
 {
     assert(!s->fp_access_checked);
     s->fp_access_checked = true;
+    // CF FIES
+    tcg_ctx->fies_vfp = true;
+    // CF FIES END
 
     if (!s->fp_excp_el) {
         return true;
@@ -11177,6 +11270,15 @@ static void disas_a64_insn(CPUARMState *env, DisasContext *s)
     uint32_t insn;
 
     insn = arm_ldl_code(env, s->pc, s->sctlr_b);
+
+// CF FIES
+    /* only the single-use TB of an active fault is faulty, see cpu_exec */
+    if (s->base.tb->cflags & CF_NOCACHE) {
+        hwaddr pc = s->pc;
+        FIESER_hook(env, &pc, &insn, FI_INSTRUCTION_VALUE_A64, -1, FI_SITE_TRANSLATE);
+    }
+// CF FIES END
+
     s->insn = insn;
     s->pc += 4;
 
@@ -11277,6 +11379,20 @@ static int aarch64_tr_init_disas_context(DisasContextBase *dcbase,
     if (dc->ss_active) {
         bound = 1;
     }
+
+// CF FIES
+    dc->fies = fies_enabled;
+    dc->fies_regs = 0;
+    dc->fies_insn_pending = false;
+
+    /* An instruction with an armed instruction fault gets a TB of its own,
+       so that cpu_exec can run its faulty variant while the fault is
+       active.  */
+    if (dc->fies && FIESER_insn_armed(dc->base.pc_first)) {
+        bound = 1;
+    }
+// CF FIES END
+
     max_insns = MIN(max_insns, bound);
 
     init_tmp_a64_array(dc);
@@ -11286,6 +11402,19 @@ static int aarch64_tr_init_disas_context(DisasContextBase *dcbase,
 
 static void aarch64_tr_tb_start(DisasContextBase *db, CPUState *cpu)
 {
+// CF FIES
+    DisasContext *dc = container_of(db, DisasContext, base);
+
+    /* Time-triggered faults are checked once per TB execution instead of
+       after every instruction.  */
+    if (dc->fies && FIESER_time_armed()) {
+        TCGv_i32 tcg_pc = tcg_const_i32(dc->base.pc_first);
+        tcg_ctx->fies_instrumented = true;
+        gen_helper_fault_controller_call_time(cpu_env, tcg_pc);
+        tcg_temp_free_i32(tcg_pc);
+    }
+// CF FIES END
+
     tcg_clear_temp_count();
 }
 
@@ -11295,6 +11424,9 @@ static void aarch64_tr_insn_start(DisasContextBase *dcbase, CPUState *cpu)
 
     dc->insn_start_idx = tcg_op_buf_count();
     tcg_gen_insn_start(dc->pc, 0, 0);
+// CF FIES
+    dc->fies_insn_pending = true;
+// CF FIES END
 }
 
 static bool aarch64_tr_breakpoint_check(DisasContextBase *dcbase, CPUState *cpu,
@@ -11345,6 +11477,20 @@ static void aarch64_tr_translate_insn(DisasContextBase *dcbase, CPUState *cpu)
         disas_a64_insn(env, dc);
     }
 
+// CF FIES
+    /* an insn, which ended the TB itself, emitted its hooks before the exit */
+    if (dc->base.is_jmp != DISAS_NORETURN) {
+        gen_a64_fies_insn_end(dc);
+    }
+    dc->fies_regs = 0;
+    dc->fies_insn_pending = false;
+
+    /* end the TB in front of an instruction with an armed fault */
+    if (dc->fies && dc->base.is_jmp == DISAS_NEXT && FIESER_insn_armed(dc->pc)) {
+        dc->base.is_jmp = DISAS_TOO_MANY;
+    }
+// CF FIES END
+
     dc->base.pc_next = dc->pc;
     translator_loop_temp_check(&dc->base);
 }
@@ -39,6 +39,7 @@
 // CF FIES
 #include "../fault-injection-controller.h"
 #include "../fault-injection-profiler.h"
+#include "../fault-injection-scheduler.h"
 // CF FIES END
 
 #define ENABLE_ARCH_4T    arm_dc_feature(s, ARM_FEATURE_V4T)
@@ -73,6 +74,12 @@ TCGv_i64 cpu_exclusive_val;
 static TCGv_i32 cpu_F0s, cpu_F1s;
 static TCGv_i64 cpu_F0d, cpu_F1d;
 
+// CF FIES
+/* dc->fies of the TB in translation, for the VFP and NEON register
+   accessors, which do not get the DisasContext.  */
+static bool fies_vfp_tb;
+// CF FIES END
+
 #include "exec/gen-icount.h"
 
 static const char *regnames[] =
@@ -222,9 +229,16 @@ static inline TCGv_i32 load_reg(DisasContext *s, int reg)
     load_reg_var(s, tmp, reg);
     return tmp;
 */
-    TCGv_i32 tcg_reg = tcg_const_i32(reg);
+    TCGv_i32 tcg_reg;
     TCGv_i32 tmp = tcg_temp_new_i32();
 
+    if (!s->fies) {
+        load_reg_var(s, tmp, reg);
+        return tmp;
+    }
+
+    tcg_reg = tcg_const_i32(reg);
+    tcg_ctx->fies_instrumented = true;
     gen_helper_fault_controller_call_reg_decoder(tcg_reg, cpu_env, tcg_reg);
     load_reg_var(s, tmp, reg);
 
@@ -240,11 +254,15 @@ static inline TCGv_i32 load_reg(DisasContext *s, int reg)
 static void store_reg(DisasContext *s, int reg, TCGv_i32 var)
 {
 // CF FIES
-	TCGv_i32 tcg_reg = tcg_const_i32(reg);
+    if (s->fies) {
+        TCGv_i32 tcg_reg = tcg_const_i32(reg);
 
-    //write
-	gen_helper_fault_controller_call_reg_decoder(tcg_reg, cpu_env, tcg_reg);
-    gen_helper_fault_controller_call_store_reg(var, cpu_env, var, tcg_reg);
+        //write
+        tcg_ctx->fies_instrumented = true;
+        gen_helper_fault_controller_call_reg_decoder(tcg_reg, cpu_env, tcg_reg);
+        gen_helper_fault_controller_call_store_reg(var, cpu_env, var, tcg_reg);
+        tcg_temp_free_i32(tcg_reg);
+    }
 // CF FIES END
 
     if (reg == 15) {
@@ -257,12 +275,46 @@ static void store_reg(DisasContext *s, int reg, TCGv_i32 var)
         s->base.is_jmp = DISAS_JUMP;
     }
     tcg_gen_mov_i32(cpu_R[reg], var);
-// CF FIES
-    tcg_temp_free_i32(tcg_reg);
-// CF FIES END
     tcg_temp_free_i32(var);
 }
 
+// CF FIES
+/* The SPSR calls the fault controller only while a fault is armed for the
+   SPSR of a bank, the bank of the current mode is selected at run time.  */
+static inline bool fies_spsr_armed(DisasContext *s)
+{
+    return s->fies
+        && FIESER_register_range_armed(FI_REG_BANKED_SPSR,
+                                       FI_REG_BANKED_END - FI_REG_BANKED_SPSR);
+}
+
+static TCGv_i32 load_spsr(DisasContext *s)
+{
+    TCGv_i32 tmp = load_cpu_field(spsr);
+
+    if (fies_spsr_armed(s)) {
+        TCGv_i32 tcg_access = tcg_const_i32(read_access_type);
+
+        tcg_ctx->fies_instrumented = true;
+        gen_helper_fault_controller_call_spsr(tmp, cpu_env, tmp, tcg_access);
+        tcg_temp_free_i32(tcg_access);
+    }
+    return tmp;
+}
+
+static void store_spsr(DisasContext *s, TCGv_i32 var)
+{
+    if (fies_spsr_armed(s)) {
+        TCGv_i32 tcg_access = tcg_const_i32(write_access_type);
+
+        tcg_ctx->fies_instrumented = true;
+        gen_helper_fault_controller_call_spsr(var, cpu_env, var, tcg_access);
+        tcg_temp_free_i32(tcg_access);
+    }
+    store_cpu_field(var, spsr);
+}
+// CF FIES END
+
 /* Value extensions.  */
 #define gen_uxtb(var) tcg_gen_ext8u_i32(var, var)
 #define gen_uxth(var) tcg_gen_ext16u_i32(var, var)
@@ -1565,15 +1617,74 @@ neon_reg_offset (int reg, int n)
     return vfp_reg_offset(0, sreg);
 }
 
+// CF FIES
+/* The FIES register number of a S or D register.  */
+static inline int fies_vfp_regno(int dp, int reg)
+{
+    return dp ? FI_REG_VFP_D0 + reg : FI_REG_VFP_S0 + reg;
+}
+
+/* VFP and NEON code is only instrumented for the registers an armed
+   fault names, all other accesses stay plain loads and stores.  */
+static inline bool fies_vfp_armed(int regno)
+{
+    return unlikely(fies_vfp_tb) && FIESER_vfp_register_armed(regno);
+}
+
+/* Pass a value read from or written to a FP/SIMD register through the
+   fault controller.  */
+static void gen_fies_vfp_reg_i64(TCGv_i64 var, int regno,
+                                 AccessType access_type)
+{
+    TCGv_i32 tcg_regno, tcg_access;
+
+    if (!fies_vfp_armed(regno)) {
+        return;
+    }
+
+    tcg_regno = tcg_const_i32(regno);
+    tcg_access = tcg_const_i32(access_type);
+    gen_helper_fault_controller_call_vfp_reg(var, cpu_env, var, tcg_regno,
+                                             tcg_access);
+    tcg_temp_free_i32(tcg_access);
+    tcg_temp_free_i32(tcg_regno);
+    tcg_ctx->fies_instrumented = true;
+}
+
+static void gen_fies_vfp_reg_i32(TCGv_i32 var, int regno,
+                                 AccessType access_type)
+{
+    TCGv_i64 tmp;
+
+    if (!fies_vfp_armed(regno)) {
+        return;
+    }
+
+    tmp = tcg_temp_new_i64();
+    tcg_gen_extu_i32_i64(tmp, var);
+    gen_fies_vfp_reg_i64(tmp, regno, access_type);
+    tcg_gen_extrl_i64_i32(var, tmp);
+    tcg_temp_free_i64(tmp);
+}
+// CF FIES END
+
 static TCGv_i32 neon_load_reg(int reg, int pass)
 {
     TCGv_i32 tmp = tcg_temp_new_i32();
     tcg_gen_ld_i32(tmp, cpu_env, neon_reg_offset(reg, pass));
+// CF FIES
+    gen_fies_vfp_reg_i32(tmp, FI_REG_VFP_S0 + reg * 2 + pass,
+                         read_access_type);
+// CF FIES END
     return tmp;
 }
 
 static void neon_store_reg(int reg, int pass, TCGv_i32 var)
 {
+// CF FIES
+    gen_fies_vfp_reg_i32(var, FI_REG_VFP_S0 + reg * 2 + pass,
+                         write_access_type);
+// CF FIES END
     tcg_gen_st_i32(var, cpu_env, neon_reg_offset(reg, pass));
     tcg_temp_free_i32(var);
 }
@@ -1581,10 +1692,25 @@ static void neon_store_reg(int reg, int pass, TCGv_i32 var)
 static inline void neon_load_reg64(TCGv_i64 var, int reg)
 {
     tcg_gen_ld_i64(var, cpu_env, vfp_reg_offset(1, reg));
+// CF FIES
+    gen_fies_vfp_reg_i64(var, FI_REG_VFP_D0 + reg, read_access_type);
+// CF FIES END
 }
 
 static inline void neon_store_reg64(TCGv_i64 var, int reg)
 {
+// CF FIES
+    /* the source may be used again by the caller */
+    if (fies_vfp_armed(FI_REG_VFP_D0 + reg)) {
+        TCGv_i64 tmp = tcg_temp_new_i64();
+
+        tcg_gen_mov_i64(tmp, var);
+        gen_fies_vfp_reg_i64(tmp, FI_REG_VFP_D0 + reg, write_access_type);
+        tcg_gen_st_i64(tmp, cpu_env, vfp_reg_offset(1, reg));
+        tcg_temp_free_i64(tmp);
+        return;
+    }
+// CF FIES END
     tcg_gen_st_i64(var, cpu_env, vfp_reg_offset(1, reg));
 }
 
@@ -1595,22 +1721,63 @@ static inline void neon_store_reg64(TCGv_i64 var, int reg)
 
 static inline void gen_mov_F0_vreg(int dp, int reg)
 {
-    if (dp)
+    if (dp) {
         tcg_gen_ld_f64(cpu_F0d, cpu_env, vfp_reg_offset(dp, reg));
-    else
+// CF FIES
+        gen_fies_vfp_reg_i64(cpu_F0d, fies_vfp_regno(dp, reg),
+                             read_access_type);
+// CF FIES END
+    } else {
         tcg_gen_ld_f32(cpu_F0s, cpu_env, vfp_reg_offset(dp, reg));
+// CF FIES
+        gen_fies_vfp_reg_i32(cpu_F0s, fies_vfp_regno(dp, reg),
+                             read_access_type);
+// CF FIES END
+    }
 }
 
 static inline void gen_mov_F1_vreg(int dp, int reg)
 {
-    if (dp)
+    if (dp) {
         tcg_gen_ld_f64(cpu_F1d, cpu_env, vfp_reg_offset(dp, reg));
-    else
+// CF FIES
+        gen_fies_vfp_reg_i64(cpu_F1d, fies_vfp_regno(dp, reg),
+                             read_access_type);
+// CF FIES END
+    } else {
         tcg_gen_ld_f32(cpu_F1s, cpu_env, vfp_reg_offset(dp, reg));
+// CF FIES
+        gen_fies_vfp_reg_i32(cpu_F1s, fies_vfp_regno(dp, reg),
+                             read_access_type);
+// CF FIES END
+    }
 }
 
 static inline void gen_mov_vreg_F0(int dp, int reg)
 {
+// CF FIES
+    /* F0 may be used again by the following operations */
+    if (fies_vfp_armed(fies_vfp_regno(dp, reg))) {
+        if (dp) {
+            TCGv_i64 tmp = tcg_temp_new_i64();
+
+            tcg_gen_mov_i64(tmp, cpu_F0d);
+            gen_fies_vfp_reg_i64(tmp, fies_vfp_regno(dp, reg),
+                                 write_access_type);
+            tcg_gen_st_f64(tmp, cpu_env, vfp_reg_offset(dp, reg));
+            tcg_temp_free_i64(tmp);
+        } else {
+            TCGv_i32 tmp = tcg_temp_new_i32();
+
+            tcg_gen_mov_i32(tmp, cpu_F0s);
+            gen_fies_vfp_reg_i32(tmp, fies_vfp_regno(dp, reg),
+                                 write_access_type);
+            tcg_gen_st_f32(tmp, cpu_env, vfp_reg_offset(dp, reg));
+            tcg_temp_free_i32(tmp);
+        }
+        return;
+    }
+// CF FIES END
     if (dp)
         tcg_gen_st_f64(cpu_F0d, cpu_env, vfp_reg_offset(dp, reg));
     else
@@ -3308,6 +3475,10 @@ static int disas_vfp_insn(DisasContext *s, uint32_t insn)
     TCGv_i32 tmp;
     TCGv_i32 tmp2;
 
+    // CF FIES
+    tcg_ctx->fies_vfp = true;
+    // CF FIES END
+
     if (!arm_dc_feature(s, ARM_FEATURE_VFP)) {
         return 1;
     }
@@ -3473,10 +3644,18 @@ static int disas_vfp_insn(DisasContext *s, uint32_t insn)
                         case ARM_VFP_FPSCR:
                             if (rd == 15) {
                                 tmp = load_cpu_field(vfp.xregs[ARM_VFP_FPSCR]);
+// CF FIES
+                                gen_fies_vfp_reg_i32(tmp, FI_REG_FPSCR,
+                                                     read_access_type);
+// CF FIES END
                                 tcg_gen_andi_i32(tmp, tmp, 0xf0000000);
                             } else {
                                 tmp = tcg_temp_new_i32();
                                 gen_helper_vfp_get_fpscr(tmp, cpu_env);
+// CF FIES
+                                gen_fies_vfp_reg_i32(tmp, FI_REG_FPSCR,
+                                                     read_access_type);
+// CF FIES END
                             }
                             break;
                         case ARM_VFP_MVFR2:
@@ -3519,6 +3698,10 @@ static int disas_vfp_insn(DisasContext *s, uint32_t insn)
                             break;
                         case ARM_VFP_FPSCR:
                             tmp = load_reg(s, rd);
+// CF FIES
+                            gen_fies_vfp_reg_i32(tmp, FI_REG_FPSCR,
+                                                 write_access_type);
+// CF FIES END
                             gen_helper_vfp_set_fpscr(cpu_env, tmp);
                             tcg_temp_free_i32(tmp);
                             gen_lookup_tb(s);
@@ -4323,11 +4506,11 @@ static int gen_set_psr(DisasContext *s, uint32_t mask, int spsr, TCGv_i32 t0)
         if (IS_USER(s))
             return 1;
 
-        tmp = load_cpu_field(spsr);
+        tmp = load_spsr(s);
         tcg_gen_andi_i32(tmp, tmp, ~mask);
         tcg_gen_andi_i32(t0, t0, mask);
         tcg_gen_or_i32(tmp, tmp, t0);
-        store_cpu_field(tmp, spsr);
+        store_spsr(s, tmp);
     } else {
         gen_set_cpsr(t0, mask);
     }
@@ -4561,7 +4744,7 @@ static void gen_rfe(DisasContext *s, TCGv_i32 pc, TCGv_i32 cpsr)
 /* Generate an old-style exception return. Marks pc as dead. */
 static void gen_exception_return(DisasContext *s, TCGv_i32 pc)
 {
-    gen_rfe(s, pc, load_cpu_field(spsr));
+    gen_rfe(s, pc, load_spsr(s));
 }
 
 /*
@@ -4866,6 +5049,10 @@ static int disas_neon_ls_insn(DisasContext *s, uint32_t insn)
     TCGv_i32 tmp2;
     TCGv_i64 tmp64;
 
+    // CF FIES
+    tcg_ctx->fies_vfp = true;
+    // CF FIES END
+
     /* FIXME: this access check should not take precedence over UNDEF
      * for invalid encodings; we will generate incorrect syndrome information
      * for attempts to execute invalid vfp/neon encodings with FP disabled.
@@ -5628,6 +5815,10 @@ static int disas_neon_data_insn(DisasContext *s, uint32_t insn)
     TCGv_i32 tmp, tmp2, tmp3, tmp4, tmp5;
     TCGv_i64 tmp64;
 
+    // CF FIES
+    tcg_ctx->fies_vfp = true;
+    // CF FIES END
+
     /* FIXME: this access check should not take precedence over UNDEF
      * for invalid encodings; we will generate incorrect syndrome information
      * for attempts to execute invalid vfp/neon encodings with FP disabled.
@@ -8145,7 +8336,7 @@ static void gen_srs(DisasContext *s,
     tmp = load_reg(s, 14);
     gen_aa32_st32(s, tmp, addr, get_mem_index(s));
     tcg_temp_free_i32(tmp);
-    tmp = load_cpu_field(spsr);
+    tmp = load_spsr(s);
     tcg_gen_addi_i32(addr, addr, 4);
     gen_aa32_st32(s, tmp, addr, get_mem_index(s));
     tcg_temp_free_i32(tmp);
@@ -8469,7 +8660,7 @@ static void disas_arm_insn(DisasContext *s, unsigned int insn)
                 if (op1 & 2) {
                     if (IS_USER(s))
                         goto illegal_op;
-                    tmp = load_cpu_field(spsr);
+                    tmp = load_spsr(s);
                 } else {
                     tmp = tcg_temp_new_i32();
                     gen_helper_cpsr_read(tmp, cpu_env);
@@ -9630,7 +9821,7 @@ static void disas_arm_insn(DisasContext *s, unsigned int insn)
                 }
                 if (exc_return) {
                     /* Restore CPSR from SPSR.  */
-                    tmp = load_cpu_field(spsr);
+                    tmp = load_spsr(s);
                     gen_helper_cpsr_write_eret(cpu_env, tmp);
                     tcg_temp_free_i32(tmp);
                     /* Must exit loop to check un-masked IRQs */
@@ -10811,7 +11002,7 @@ static int disas_thumb2_insn(DisasContext *s, uint32_t insn)
                             goto illegal_op;
                         }
 
-                        tmp = load_cpu_field(spsr);
+                        tmp = load_spsr(s);
                         store_reg(s, rd, tmp);
                         break;
                     }
@@ -12002,6 +12193,9 @@ static int arm_tr_init_disas_context(DisasContextBase *dcbase,
 
     dc->pc = dc->base.pc_first;
     dc->condjmp = 0;
+// CF FIES
+    dc->fies = fies_enabled;
+// CF FIES END
 
     dc->aarch64 = 0;
     /* If we are coming from secure EL0 in a system with a 32-bit EL3, then
@@ -12059,6 +12253,15 @@ static int arm_tr_init_disas_context(DisasContextBase *dcbase,
         max_insns = 1;
     }
 
+// CF FIES
+    /* An instruction with an armed instruction fault gets a TB of its own,
+       so that cpu_exec can run its faulty variant while the fault is
+       active.  */
+    if (dc->fies && FIESER_insn_armed(dc->base.pc_first)) {
+        max_insns = 1;
+    }
+// CF FIES END
+
     /* ARM is a fixed-length ISA.  Bound the number of insns to execute
        to those left on the page.  */
     if (!dc->thumb) {
@@ -12068,6 +12271,9 @@ static int arm_tr_init_disas_context(DisasContextBase *dcbase,
 
     cpu_F0s = tcg_temp_new_i32();
     cpu_F1s = tcg_temp_new_i32();
+// CF FIES
+    fies_vfp_tb = dc->fies;
+// CF FIES END
     cpu_F0d = tcg_temp_new_i64();
     cpu_F1d = tcg_temp_new_i64();
     cpu_V0 = cpu_F0d;
@@ -12220,9 +12426,12 @@ static void arm_tr_translate_insn(DisasContextBase *dcbase, CPUState *cpu)
     //printf ("FIES: %s:%d hook instruction VALUE at pc=%x, Op=%x\r\n", __func__, __LINE__, dc->pc, insn);
 //    profiler_debuglog("%s PC = %08x    ARM = %08x\n", __func__, dc->pc, insn);
     
-    hwaddr pc = dc->pc;
-    FIESER_hook(env, &pc, &insn, FI_INSTRUCTION_VALUE_ARM, -1);
-    dc->pc = pc;
+    /* only the single-use TB of an active fault is faulty, see cpu_exec */
+    if (dc->base.tb->cflags & CF_NOCACHE) {
+        hwaddr pc = dc->pc;
+        FIESER_hook(env, &pc, &insn, FI_INSTRUCTION_VALUE_ARM, -1, FI_SITE_TRANSLATE);
+        dc->pc = pc;
+    }
     // CF FIES END
     }
 //    profiler_debuglog("%s PC = %08x    ARM = %08x\n", __func__, dc->pc, insn);
@@ -12236,13 +12445,21 @@ static void arm_tr_translate_insn(DisasContextBase *dcbase, CPUState *cpu)
     arm_post_translate_insn(dc);
 
     // CF FIES
-    {
-    TCGv_i32 tcg_pc = tcg_const_i32(dc->pc);
+    /* a fault list of scheduled faults only needs no check after each
+     * instruction, they are applied by their timers */
+    if (dc->fies && !FIESER_scheduler_exclusive()) {
+    TCGv_i64 tcg_pc = tcg_const_i64(dc->pc);
     TCGv_i32 tcg_type = tcg_const_i32(FI_PC_ARM);
+    tcg_ctx->fies_instrumented = true;
     gen_helper_fault_controller_call_pc(cpu_env, tcg_pc, tcg_type);
-    tcg_temp_free_i32(tcg_pc);
+    tcg_temp_free_i64(tcg_pc);
     tcg_temp_free_i32(tcg_type);
     }
+
+    /* end the TB in front of an instruction with an armed fault */
+    if (dc->fies && dc->base.is_jmp == DISAS_NEXT && FIESER_insn_armed(dc->pc)) {
+        dc->base.is_jmp = DISAS_TOO_MANY;
+    }
     // CF FIES END
 
     /* ARM is a fixed-length ISA.  We performed the cross-page check
@@ -12323,18 +12540,23 @@ static void thumb_tr_translate_insn(DisasContextBase *dcbase, CPUState *cpu)
         // decrement the PC again, so we get the original PC, 
         // we left it incremented above to avoid assumptions about arm_lduw_code
         // not accessing the PC and expecting it to be incremented already
-        dc->pc -= 2;
-        uint64_t pc64 = dc->pc;
-        FIESER_hook(env, &pc64, &insn, FI_INSTRUCTION_VALUE_THUMB32, -1);
-        dc->pc += 2;
+        // only the single-use TB of an active fault is faulty, see cpu_exec
+        if (dc->base.tb->cflags & CF_NOCACHE) {
+            dc->pc -= 2;
+            uint64_t pc64 = dc->pc;
+            FIESER_hook(env, &pc64, &insn, FI_INSTRUCTION_VALUE_THUMB32, -1, FI_SITE_TRANSLATE);
+            dc->pc += 2;
+        }
         // CF FIES END
 
         dc->pc += 2;
     }
     //CF: FIES new feature
     else {
-        uint64_t pc64 = dc->pc;
-        FIESER_hook(env, &pc64, &insn, FI_INSTRUCTION_VALUE_THUMB16, -1);
+        if (dc->base.tb->cflags & CF_NOCACHE) {
+            uint64_t pc64 = dc->pc;
+            FIESER_hook(env, &pc64, &insn, FI_INSTRUCTION_VALUE_THUMB16, -1, FI_SITE_TRANSLATE);
+        }
         
         dc->pc += 2;
         
@@ -12375,12 +12597,20 @@ static void thumb_tr_translate_insn(DisasContextBase *dcbase, CPUState *cpu)
     arm_post_translate_insn(dc);
     
     // CF FIES
-    {
-    TCGv_i32 tcg_pc = tcg_const_i32(dc->pc);
-    TCGv_i32 tcg_type = tcg_const_i32(is_16bit? FI_PC_THUMB32: FI_PC_THUMB16);
+    /* a fault list of scheduled faults only needs no check after each
+     * instruction, they are applied by their timers */
+    if (dc->fies && !FIESER_scheduler_exclusive()) {
+    TCGv_i64 tcg_pc = tcg_const_i64(dc->pc);
+    TCGv_i32 tcg_type = tcg_const_i32(is_16bit ? FI_PC_THUMB16 : FI_PC_THUMB32);
+    tcg_ctx->fies_instrumented = true;
     gen_helper_fault_controller_call_pc(cpu_env, tcg_pc, tcg_type);
-    tcg_temp_free_i32(tcg_pc);
-    tcg_temp_free_i32(tcg_pc);
+    tcg_temp_free_i64(tcg_pc);
+    tcg_temp_free_i32(tcg_type);
+    }
+
+    /* end the TB in front of an instruction with an armed fault */
+    if (dc->fies && dc->base.is_jmp == DISAS_NEXT && FIESER_insn_armed(dc->pc)) {
+        dc->base.is_jmp = DISAS_TOO_MANY;
     }
     // CF FIES END
 
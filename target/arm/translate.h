@@ -71,6 +71,15 @@ typedef struct DisasContext {
 #define TMP_A64_MAX 16
     int tmp_a64_count;
     TCGv_i64 tmp_a64[TMP_A64_MAX];
+// CF FIES
+    /* Emit the fault controller helpers, sampled once per TB.  */
+    bool fies;
+    /* A64 registers with armed faults, which the current insn references.  */
+    uint32_t fies_regs;
+    /* An A64 insn is being translated, which has not emitted its write
+       and PC hooks yet.  */
+    bool fies_insn_pending;
+// CF FIES END
 } DisasContext;
 
 typedef struct DisasCompare {
@@ -2644,12 +2644,85 @@ static void tcg_gen_req_mo(TCGBar type)
     }
 }
 
+// CF FIES
+#ifdef CONFIG_USER_ONLY
+/* In user mode, the generated loads and stores access the host memory
+   directly.  While memory faults are loaded (see tb_gen_code), the loaded
+   value passes the fault controller after the load, the stored value
+   before the store.  */
+static TCGv gen_fies_user_addr(TCGv addr)
+{
+    TCGv t = tcg_temp_new();
+
+    /* the loaded value may overwrite the address */
+    tcg_gen_mov_tl(t, addr);
+    return t;
+}
+
+static void gen_fies_user_ld_i64(TCGv_i64 val, TCGv addr, TCGMemOp memop)
+{
+    TCGv_i32 oi = tcg_const_i32(memop);
+
+    gen_helper_fies_user_ld(val, cpu_env, addr, val, oi);
+    tcg_temp_free_i32(oi);
+    tcg_temp_free(addr);
+    tcg_ctx->fies_instrumented = true;
+}
+
+static void gen_fies_user_ld_i32(TCGv_i32 val, TCGv addr, TCGMemOp memop)
+{
+    TCGv_i64 t = tcg_temp_new_i64();
+
+    tcg_gen_extu_i32_i64(t, val);
+    gen_fies_user_ld_i64(t, addr, memop);
+    tcg_gen_extrl_i64_i32(val, t);
+    tcg_temp_free_i64(t);
+}
+
+static TCGv_i64 gen_fies_user_st_i64(TCGv_i64 val, TCGv addr, TCGMemOp memop)
+{
+    TCGv_i64 t = tcg_temp_new_i64();
+    TCGv_i32 oi = tcg_const_i32(memop);
+
+    gen_helper_fies_user_st(t, cpu_env, addr, val, oi);
+    tcg_temp_free_i32(oi);
+    tcg_ctx->fies_instrumented = true;
+    return t;
+}
+
+static TCGv_i32 gen_fies_user_st_i32(TCGv_i32 val, TCGv addr, TCGMemOp memop)
+{
+    TCGv_i64 t = tcg_temp_new_i64();
+    TCGv_i64 r;
+    TCGv_i32 ret = tcg_temp_new_i32();
+
+    tcg_gen_extu_i32_i64(t, val);
+    r = gen_fies_user_st_i64(t, addr, memop);
+    tcg_gen_extrl_i64_i32(ret, r);
+    tcg_temp_free_i64(r);
+    tcg_temp_free_i64(t);
+    return ret;
+}
+#endif
+// CF FIES END
+
 void tcg_gen_qemu_ld_i32(TCGv_i32 val, TCGv addr, TCGArg idx, TCGMemOp memop)
 {
     tcg_gen_req_mo(TCG_MO_LD_LD | TCG_MO_ST_LD);
     memop = tcg_canonicalize_memop(memop, 0, 0);
     trace_guest_mem_before_tcg(tcg_ctx->cpu, cpu_env,
                                addr, trace_mem_get_info(memop, 0));
+    // CF FIES
+#ifdef CONFIG_USER_ONLY
+    if (tcg_ctx->fies_mem_hooks) {
+        TCGv t = gen_fies_user_addr(addr);
+
+        gen_ldst_i32(INDEX_op_qemu_ld_i32, val, addr, memop, idx);
+        gen_fies_user_ld_i32(val, t, memop);
+        return;
+    }
+#endif
+    // CF FIES END
     gen_ldst_i32(INDEX_op_qemu_ld_i32, val, addr, memop, idx);
 }
 
@@ -2659,6 +2732,17 @@ void tcg_gen_qemu_st_i32(TCGv_i32 val, TCGv addr, TCGArg idx, TCGMemOp memop)
     memop = tcg_canonicalize_memop(memop, 0, 1);
     trace_guest_mem_before_tcg(tcg_ctx->cpu, cpu_env,
                                addr, trace_mem_get_info(memop, 1));
+    // CF FIES
+#ifdef CONFIG_USER_ONLY
+    if (tcg_ctx->fies_mem_hooks) {
+        TCGv_i32 t = gen_fies_user_st_i32(val, addr, memop);
+
+        gen_ldst_i32(INDEX_op_qemu_st_i32, t, addr, memop, idx);
+        tcg_temp_free_i32(t);
+        return;
+    }
+#endif
+    // CF FIES END
     gen_ldst_i32(INDEX_op_qemu_st_i32, val, addr, memop, idx);
 }
 
@@ -2678,6 +2762,17 @@ void tcg_gen_qemu_ld_i64(TCGv_i64 val, TCGv addr, TCGArg idx, TCGMemOp memop)
     memop = tcg_canonicalize_memop(memop, 1, 0);
     trace_guest_mem_before_tcg(tcg_ctx->cpu, cpu_env,
                                addr, trace_mem_get_info(memop, 0));
+    // CF FIES
+#ifdef CONFIG_USER_ONLY
+    if (tcg_ctx->fies_mem_hooks) {
+        TCGv t = gen_fies_user_addr(addr);
+
+        gen_ldst_i64(INDEX_op_qemu_ld_i64, val, addr, memop, idx);
+        gen_fies_user_ld_i64(val, t, memop);
+        return;
+    }
+#endif
+    // CF FIES END
     gen_ldst_i64(INDEX_op_qemu_ld_i64, val, addr, memop, idx);
 }
 
@@ -2692,6 +2787,17 @@ void tcg_gen_qemu_st_i64(TCGv_i64 val, TCGv addr, TCGArg idx, TCGMemOp memop)
     memop = tcg_canonicalize_memop(memop, 1, 1);
     trace_guest_mem_before_tcg(tcg_ctx->cpu, cpu_env,
                                addr, trace_mem_get_info(memop, 1));
+    // CF FIES
+#ifdef CONFIG_USER_ONLY
+    if (tcg_ctx->fies_mem_hooks) {
+        TCGv_i64 t = gen_fies_user_st_i64(val, addr, memop);
+
+        gen_ldst_i64(INDEX_op_qemu_st_i64, t, addr, memop, idx);
+        tcg_temp_free_i64(t);
+        return;
+    }
+#endif
+    // CF FIES END
     gen_ldst_i64(INDEX_op_qemu_st_i64, val, addr, memop, idx);
 }
 
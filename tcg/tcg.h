@@ -670,6 +670,16 @@ struct TCGContext {
     /* Track which vCPU triggers events */
     CPUState *cpu;                      /* *_trans */
 
+    // CF FIES
+    /* Set by the translator if the current TB calls fault injection hooks */
+    bool fies_instrumented;
+    /* Set in user mode while loads and stores pass the memory hooks */
+    bool fies_mem_hooks;
+    /* Set by the translator if the current TB accesses the VFP/NEON
+       registers, which DCLS mode only swaps for such TBs */
+    bool fies_vfp;
+    // CF FIES END
+
     /* These structures are private to tcg-target.inc.c.  */
 #ifdef TCG_TARGET_NEED_LDST_LABELS
     struct TCGLabelQemuLdst *ldst_labels;
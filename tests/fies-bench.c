@@ -0,0 +1,443 @@
+/*
+ * FIES performance benchmark
+ *
+ * Runs a guest workload under qemu-system-arm in a set of fault
+ * injection and profiling configurations and reports wall time and
+ * guest MIPS for each of them as CSV on stdout.
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+#include "qemu/osdep.h"
+#include <sys/wait.h>
+
+#include "fault-injection-stats.h"
+
+struct scenario {
+    const char *name;
+    const char *trigger;     /* fault trigger, NULL for none */
+    int n_faults;            /* faults in the library, -1 runs without -fi */
+    const char *profiling;   /* -profiling argument, NULL for none */
+};
+
+struct result {
+    const struct scenario *sc;
+    unsigned int run;
+    double wall;
+    uint64_t guest_insns;
+    int status;
+};
+
+static const struct scenario scenarios[] = {
+    { "baseline",       NULL,     -1,    NULL },
+    { "fi-empty",       NULL,     0,     NULL },
+    { "fi-access-1",    "ACCESS", 1,     NULL },
+    { "fi-access-100",  "ACCESS", 100,   NULL },
+    { "fi-access-10k",  "ACCESS", 10000, NULL },
+    { "fi-time-1",      "TIME",   1,     NULL },
+    { "fi-time-100",    "TIME",   100,   NULL },
+    { "fi-time-10k",    "TIME",   10000, NULL },
+    { "fi-pc-1",        "PC",     1,     NULL },
+    { "fi-pc-100",      "PC",     100,   NULL },
+    { "fi-pc-10k",      "PC",     10000, NULL },
+    { "profiling-r",    NULL,     -1,    "r" },
+    { "profiling-m",    NULL,     -1,    "m" },
+    { "profiling-c",    NULL,     -1,    "c" },
+    { "profiling-p",    NULL,     -1,    "p" },
+    { "profiling-t",    NULL,     -1,    "t" },
+};
+
+static const char *qemu_binary = "arm-softmmu/qemu-system-arm";
+static const char *kernel = "fies_sandbox/example_binaries/Basicmath_Small_Cubic";
+static const char *machine;
+static const char *filter;
+static unsigned int repetitions = 3;
+static unsigned int timeout = 600;
+static uint64_t reference_insns;
+static uint64_t baseline_insns;
+static char *work_dir;
+
+static const char commands_string[] =
+    " -q = path to qemu-system-arm\n"
+    " -k = guest kernel to run\n"
+    " -M = machine type passed to QEMU (default: none)\n"
+    " -n = number of runs per scenario\n"
+    " -t = timeout per run in seconds\n"
+    " -s = only run scenarios whose name contains this string\n"
+    " -i = guest instructions of the workload (default: measured)";
+
+static void usage_complete(char *argv[])
+{
+    fprintf(stderr, "Usage: %s [options]\n", argv[0]);
+    fprintf(stderr, "options:\n%s\n", commands_string);
+}
+
+/*
+ * Faults are placed such that they never fire in the workload: the
+ * addresses and PCs are unmapped and time-triggered faults start after
+ * an hour of virtual time.  The fault list is still walked on every
+ * hook, which is what we want to measure.
+ */
+static void append_fault(GString *xml, const char *trigger, int id)
+{
+    g_string_append_printf(xml, "\t<fault>\n\t\t<id>%d</id>\n", id);
+
+    if (!strcmp(trigger, "ACCESS")) {
+        g_string_append_printf(xml,
+            "\t\t<component>RAM</component>\n"
+            "\t\t<target>MEMORY CELL</target>\n"
+            "\t\t<mode>BITFLIP</mode>\n"
+            "\t\t<trigger>ACCESS</trigger>\n"
+            "\t\t<type>PERMANENT</type>\n"
+            "\t\t<params>\n"
+            "\t\t\t<address>0x%08x</address>\n"
+            "\t\t\t<mask>0x1</mask>\n"
+            "\t\t</params>\n",
+            0xf0000000u + 4 * id);
+    } else if (!strcmp(trigger, "TIME")) {
+        g_string_append_printf(xml,
+            "\t\t<component>REGISTER</component>\n"
+            "\t\t<target>REGISTER CELL</target>\n"
+            "\t\t<mode>BITFLIP</mode>\n"
+            "\t\t<trigger>TIME</trigger>\n"
+            "\t\t<type>TRANSIENT</type>\n"
+            "\t\t<timer>3600000MS</timer>\n"
+            "\t\t<duration>3600001MS</duration>\n"
+            "\t\t<params>\n"
+            "\t\t\t<address>0x0</address>\n"
+            "\t\t\t<instruction>0x%x</instruction>\n"
+            "\t\t\t<mask>0x1</mask>\n"
+            "\t\t</params>\n",
+            id % 13);
+    } else {
+        g_string_append_printf(xml,
+            "\t\t<component>REGISTER</component>\n"
+            "\t\t<target>REGISTER CELL</target>\n"
+            "\t\t<mode>BITFLIP</mode>\n"
+            "\t\t<trigger>PC</trigger>\n"
+            "\t\t<type>PERMANENT</type>\n"
+            "\t\t<params>\n"
+            "\t\t\t<address>0x%08x</address>\n"
+            "\t\t\t<instruction>0x%x</instruction>\n"
+            "\t\t\t<mask>0x1</mask>\n"
+            "\t\t</params>\n",
+            0xf0000000u + 4 * id, id % 13);
+    }
+
+    g_string_append(xml, "\t</fault>\n");
+}
+
+static char *write_library(const struct scenario *sc)
+{
+    GString *xml = g_string_new("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                                "<injection>\n");
+    char *path = g_strdup_printf("%s/%s.xml", work_dir, sc->name);
+    GError *err = NULL;
+    int i;
+
+    for (i = 1; i <= sc->n_faults; i++) {
+        append_fault(xml, sc->trigger, i);
+    }
+    g_string_append(xml, "</injection>\n");
+
+    if (!g_file_set_contents(path, xml->str, xml->len, &err)) {
+        fprintf(stderr, "could not write %s: %s\n", path, err->message);
+        exit(1);
+    }
+    g_string_free(xml, true);
+    return path;
+}
+
+static uint64_t read_guest_insns(const char *stats_path)
+{
+    FIESStatsSegment *s;
+    gchar *buf;
+    gsize len;
+    uint64_t insns = 0;
+
+    if (!g_file_get_contents(stats_path, &buf, &len, NULL)) {
+        return 0;
+    }
+    s = (FIESStatsSegment *)buf;
+    if (len >= sizeof(*s) && s->magic == FIES_STATS_MAGIC &&
+        s->version == FIES_STATS_VERSION) {
+        insns = s->guest_insns;
+    }
+    g_free(buf);
+    return insns;
+}
+
+/* The baseline runs QEMU without any FIES option, not even -fi-stats.  */
+static bool is_baseline(const struct scenario *sc)
+{
+    return sc->n_faults < 0 && !sc->profiling;
+}
+
+static void run_one(const struct scenario *sc, unsigned int run,
+                    bool count_insns, struct result *res)
+{
+    char *stats_path = g_strdup_printf("%s/%s.stats", work_dir, sc->name);
+    char *library = NULL;
+    const char *argv[16];
+    int argc = 0;
+    int64_t start, deadline;
+    pid_t pid;
+    int status = -1;
+
+    if (sc->n_faults >= 0) {
+        library = write_library(sc);
+    }
+
+    argv[argc++] = qemu_binary;
+    if (machine) {
+        argv[argc++] = "-M";
+        argv[argc++] = machine;
+    }
+    argv[argc++] = "-display";
+    argv[argc++] = "none";
+    argv[argc++] = "-semihosting";
+    argv[argc++] = "-kernel";
+    argv[argc++] = kernel;
+    if (count_insns) {
+        argv[argc++] = "-fi-stats";
+        argv[argc++] = stats_path;
+    }
+    if (library) {
+        argv[argc++] = "-fi";
+        argv[argc++] = library;
+    }
+    if (sc->profiling) {
+        argv[argc++] = "-profiling";
+        argv[argc++] = sc->profiling;
+    }
+    argv[argc] = NULL;
+
+    start = g_get_monotonic_time();
+    deadline = start + (int64_t)timeout * G_USEC_PER_SEC;
+
+    pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        exit(1);
+    }
+    if (pid == 0) {
+        int null = open("/dev/null", O_RDWR);
+
+        /* profiling output files are written to the working directory */
+        if (null < 0 || chdir(work_dir) ||
+            dup2(null, STDIN_FILENO) < 0 || dup2(null, STDOUT_FILENO) < 0 ||
+            dup2(null, STDERR_FILENO) < 0) {
+            _exit(127);
+        }
+        execv(argv[0], (char **)argv);
+        _exit(127);
+    }
+
+    for (;;) {
+        pid_t ret = waitpid(pid, &status, WNOHANG);
+
+        if (ret == pid) {
+            break;
+        }
+        if (ret < 0 && errno != EINTR) {
+            perror("waitpid");
+            exit(1);
+        }
+        if (g_get_monotonic_time() > deadline) {
+            kill(pid, SIGKILL);
+            waitpid(pid, &status, 0);
+            status = -1;
+            break;
+        }
+        g_usleep(1000);
+    }
+
+    res->sc = sc;
+    res->run = run;
+    res->wall = (g_get_monotonic_time() - start) / 1e6;
+    res->guest_insns = count_insns ? read_guest_insns(stats_path) : 0;
+    res->status = status < 0 ? -1 :
+                  WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+
+    if (library) {
+        unlink(library);
+        g_free(library);
+    }
+    unlink(stats_path);
+    g_free(stats_path);
+}
+
+/* The profiling modes leave their logs behind in the working directory,
+   which has to be emptied before it can be removed.  */
+static void remove_work_dir(void)
+{
+    GDir *dir = g_dir_open(work_dir, 0, NULL);
+    const char *name;
+
+    if (dir) {
+        while ((name = g_dir_read_name(dir))) {
+            char *path = g_build_filename(work_dir, name, NULL);
+
+            unlink(path);
+            g_free(path);
+        }
+        g_dir_close(dir);
+    }
+    if (rmdir(work_dir)) {
+        fprintf(stderr, "could not remove %s: %s\n", work_dir, strerror(errno));
+    }
+    g_free(work_dir);
+}
+
+static void pr_params(void)
+{
+    fprintf(stderr, "Parameters:\n");
+    fprintf(stderr, " qemu:              %s\n", qemu_binary);
+    fprintf(stderr, " kernel:            %s\n", kernel);
+    fprintf(stderr, " machine:           %s\n", machine ? machine : "(none)");
+    fprintf(stderr, " runs per scenario: %u\n", repetitions);
+    fprintf(stderr, " timeout:           %u s\n", timeout);
+}
+
+/*
+ * The baseline is timed without -fi-stats, so its guest instructions
+ * are counted by one more run of the same configuration with -fi-stats,
+ * which is not reported.  Not needed if -i gives the count.
+ */
+static void measure_baseline(const struct scenario *sc)
+{
+    struct result ref;
+
+    fprintf(stderr, "%s reference run\n", sc->name);
+    run_one(sc, 0, true, &ref);
+    if (ref.status || !ref.guest_insns) {
+        fprintf(stderr, "%s reference run failed (status %d)\n",
+                sc->name, ref.status);
+        return;
+    }
+    baseline_insns = ref.guest_insns;
+}
+
+/*
+ * The workload is deterministic and the benchmark faults never fire, so
+ * every run executes the same guest instructions.  Runs which did not
+ * report a count (the baseline or runs killed on timeout) use -i, the
+ * count of the baseline reference run or the largest count measured in
+ * any other run.
+ */
+static void pr_stats(struct result *res, unsigned int n)
+{
+    uint64_t reference = reference_insns ? reference_insns : baseline_insns;
+    bool known = reference != 0;
+    unsigned int i;
+
+    for (i = 0; !known && i < n; i++) {
+        if (!res[i].status && res[i].guest_insns > reference) {
+            reference = res[i].guest_insns;
+        }
+    }
+
+    printf("scenario,trigger,faults,profiling,run,status,wall_s,"
+           "guest_insns,insns_measured,mips\n");
+    for (i = 0; i < n; i++) {
+        const struct scenario *sc = res[i].sc;
+        bool measured = res[i].guest_insns && !reference_insns;
+        uint64_t insns = measured ? res[i].guest_insns : reference;
+
+        printf("%s,%s,%d,%s,%u,%d,%.6f,%" PRIu64 ",%d,%.3f\n",
+               sc->name, sc->trigger ? sc->trigger : "",
+               sc->n_faults < 0 ? 0 : sc->n_faults,
+               sc->profiling ? sc->profiling : "",
+               res[i].run, res[i].status, res[i].wall, insns, measured,
+               res[i].wall > 0 ? insns / res[i].wall / 1e6 : 0.0);
+    }
+}
+
+static const char *absolute_path(const char *path)
+{
+    char *abs = realpath(path, NULL);
+
+    if (!abs) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        exit(1);
+    }
+    return abs;
+}
+
+static void parse_args(int argc, char *argv[])
+{
+    int c;
+
+    for (;;) {
+        c = getopt(argc, argv, "hq:k:M:n:t:s:i:");
+        if (c < 0) {
+            break;
+        }
+        switch (c) {
+        case 'h':
+            usage_complete(argv);
+            exit(0);
+        case 'q':
+            qemu_binary = optarg;
+            break;
+        case 'k':
+            kernel = optarg;
+            break;
+        case 'M':
+            machine = optarg;
+            break;
+        case 'n':
+            repetitions = atoi(optarg);
+            break;
+        case 't':
+            timeout = atoi(optarg);
+            break;
+        case 's':
+            filter = optarg;
+            break;
+        case 'i':
+            reference_insns = g_ascii_strtoull(optarg, NULL, 0);
+            break;
+        default:
+            usage_complete(argv);
+            exit(1);
+        }
+    }
+
+    qemu_binary = absolute_path(qemu_binary);
+    kernel = absolute_path(kernel);
+}
+
+int main(int argc, char *argv[])
+{
+    struct result *res;
+    unsigned int i, run, n = 0;
+
+    parse_args(argc, argv);
+    pr_params();
+
+    work_dir = g_dir_make_tmp("fies-bench-XXXXXX", NULL);
+    if (!work_dir) {
+        fprintf(stderr, "could not create a temporary directory\n");
+        return 1;
+    }
+
+    res = g_new0(struct result, ARRAY_SIZE(scenarios) * repetitions);
+    for (i = 0; i < ARRAY_SIZE(scenarios); i++) {
+        if (filter && !strstr(scenarios[i].name, filter)) {
+            continue;
+        }
+        if (is_baseline(&scenarios[i]) && !reference_insns) {
+            measure_baseline(&scenarios[i]);
+        }
+        for (run = 0; run < repetitions; run++) {
+            fprintf(stderr, "%s run %u\n", scenarios[i].name, run);
+            run_one(&scenarios[i], run, !is_baseline(&scenarios[i]),
+                    &res[n++]);
+        }
+    }
+    pr_stats(res, n);
+
+    remove_work_dir();
+    return 0;
+}
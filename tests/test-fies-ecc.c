@@ -0,0 +1,153 @@
+/*
+ * Test the ECC codes of the FIES fault injection
+ *
+ * License: GNU GPL, version 2 or later.
+ *   See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+#include "fault-injection-ecc-code.h"
+
+static const uint8_t test_words[][FIES_ECC_WORD] = {
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+    { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff },
+    { 0xef, 0xbe, 0xad, 0xde, 0x78, 0x56, 0x34, 0x12 },
+    { 0x01, 0x80, 0x55, 0xaa, 0x0f, 0xf0, 0x3c, 0xc3 },
+};
+
+static void test_correct(FIESEccCode code)
+{
+    uint8_t word[FIES_ECC_WORD];
+    uint32_t syndrome;
+    uint16_t check;
+    int i;
+
+    for (i = 0; i < ARRAY_SIZE(test_words); i++) {
+        memcpy(word, test_words[i], FIES_ECC_WORD);
+        check = FIESER_ecc_encode(code, word);
+
+        g_assert_cmpint(FIESER_ecc_decode(code, word, check, &syndrome),
+                        ==, FIES_ECC_OK);
+        g_assert_cmpint(syndrome, ==, 0);
+        g_assert(!memcmp(word, test_words[i], FIES_ECC_WORD));
+    }
+}
+
+static void test_secded_ok(void)
+{
+    test_correct(FIES_ECC_SECDED);
+}
+
+static void test_secded_single(void)
+{
+    uint8_t word[FIES_ECC_WORD];
+    uint32_t syndrome;
+    uint16_t check;
+    int i, bit;
+
+    for (i = 0; i < ARRAY_SIZE(test_words); i++) {
+        check = FIESER_ecc_encode(FIES_ECC_SECDED, test_words[i]);
+
+        for (bit = 0; bit < 64; bit++) {
+            memcpy(word, test_words[i], FIES_ECC_WORD);
+            word[bit / 8] ^= 1 << (bit % 8);
+
+            g_assert_cmpint(FIESER_ecc_decode(FIES_ECC_SECDED, word, check,
+                                              &syndrome),
+                            ==, FIES_ECC_CORRECTED);
+            g_assert_cmpint(syndrome, !=, 0);
+            g_assert(!memcmp(word, test_words[i], FIES_ECC_WORD));
+        }
+
+        /* an error in the check bits leaves the word untouched */
+        for (bit = 0; bit < 8; bit++) {
+            memcpy(word, test_words[i], FIES_ECC_WORD);
+
+            g_assert_cmpint(FIESER_ecc_decode(FIES_ECC_SECDED, word,
+                                              check ^ (1 << bit), &syndrome),
+                            ==, FIES_ECC_CORRECTED);
+            g_assert(!memcmp(word, test_words[i], FIES_ECC_WORD));
+        }
+    }
+}
+
+static void test_secded_double(void)
+{
+    uint8_t word[FIES_ECC_WORD];
+    uint32_t syndrome;
+    uint16_t check;
+    int i, a, b;
+
+    for (i = 0; i < ARRAY_SIZE(test_words); i++) {
+        check = FIESER_ecc_encode(FIES_ECC_SECDED, test_words[i]);
+
+        for (a = 0; a < 64; a++) {
+            for (b = a + 1; b < 64; b++) {
+                memcpy(word, test_words[i], FIES_ECC_WORD);
+                word[a / 8] ^= 1 << (a % 8);
+                word[b / 8] ^= 1 << (b % 8);
+
+                g_assert_cmpint(FIESER_ecc_decode(FIES_ECC_SECDED, word,
+                                                  check, &syndrome),
+                                ==, FIES_ECC_UNCORRECTABLE);
+            }
+        }
+    }
+}
+
+static void test_chipkill_ok(void)
+{
+    test_correct(FIES_ECC_CHIPKILL);
+}
+
+static void test_chipkill_symbol(void)
+{
+    uint8_t word[FIES_ECC_WORD];
+    uint32_t syndrome;
+    uint16_t check;
+    int i, byte, error;
+
+    for (i = 0; i < ARRAY_SIZE(test_words); i++) {
+        check = FIESER_ecc_encode(FIES_ECC_CHIPKILL, test_words[i]);
+
+        /* any error pattern within one byte, i.e. one x8 chip */
+        for (byte = 0; byte < FIES_ECC_WORD; byte++) {
+            for (error = 1; error < 256; error++) {
+                memcpy(word, test_words[i], FIES_ECC_WORD);
+                word[byte] ^= error;
+
+                g_assert_cmpint(FIESER_ecc_decode(FIES_ECC_CHIPKILL, word,
+                                                  check, &syndrome),
+                                ==, FIES_ECC_CORRECTED);
+                g_assert(!memcmp(word, test_words[i], FIES_ECC_WORD));
+            }
+        }
+
+        /* an error in one of the check bytes leaves the word untouched */
+        for (error = 1; error < 256; error++) {
+            memcpy(word, test_words[i], FIES_ECC_WORD);
+            g_assert_cmpint(FIESER_ecc_decode(FIES_ECC_CHIPKILL, word,
+                                              check ^ error, &syndrome),
+                            ==, FIES_ECC_CORRECTED);
+            g_assert(!memcmp(word, test_words[i], FIES_ECC_WORD));
+
+            g_assert_cmpint(FIESER_ecc_decode(FIES_ECC_CHIPKILL, word,
+                                              check ^ error << 8, &syndrome),
+                            ==, FIES_ECC_CORRECTED);
+            g_assert(!memcmp(word, test_words[i], FIES_ECC_WORD));
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    FIESER_ecc_init_tables();
+
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func("/fies-ecc/secded/ok", test_secded_ok);
+    g_test_add_func("/fies-ecc/secded/single", test_secded_single);
+    g_test_add_func("/fies-ecc/secded/double", test_secded_double);
+    g_test_add_func("/fies-ecc/chipkill/ok", test_chipkill_ok);
+    g_test_add_func("/fies-ecc/chipkill/symbol", test_chipkill_symbol);
+    return g_test_run();
+}
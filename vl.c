@@ -122,6 +122,8 @@ int main(int argc, char **argv)
 // CF FIES
 #include "fault-injection-collector.h"
 #include "fault-injection-config.h"
+#include "fault-injection-stats.h"
+#include "accel/tcg/perf-map.h"
 // CF FIES END
 #include "qapi/opts-visitor.h"
 #include "qom/object_interfaces.h"
@@ -194,6 +196,7 @@ unsigned int profile_ram_addresses = 0;
 unsigned int profile_pc_status = 0;
 unsigned int profile_registers = 0;
 unsigned int profile_condition_flags = 0;
+unsigned int profile_hook_overhead = 0;
 // CF FIES END
 
 int icount_align_option;
@@ -3902,10 +3905,15 @@ int main(int argc, char **argv, char **envp)
                         case 'p':
                             profile_pc_status = 1;
                             break;
+                        case 't':
+                            profile_hook_overhead = 1;
+                            error_report("Profile hook overhead");
+                            break;
                         default:
                             break;
                     }
                 }
+                FIESER_enable();
                 break;
             case QEMU_OPTION_fi:
                 /*
@@ -3915,6 +3923,7 @@ int main(int argc, char **argv, char **envp)
                 if (!optarg)
                 {
                     set_do_fault_injection(1);
+                    FIESER_enable();
                     break;
                 }
 
@@ -3954,10 +3963,24 @@ int main(int argc, char **argv, char **envp)
                 }
 
                 set_do_fault_injection(1);
-               // fault_reload_arg();
+                FIESER_enable();
 
                 free(opt_str);
                 break;
+            case QEMU_OPTION_fi_dcls:
+                fies_dcls = true;
+                FIESER_enable();
+                break;
+            case QEMU_OPTION_perfmap:
+                perf_map_enable();
+                break;
+            case QEMU_OPTION_fi_stats:
+                if (FIESER_stats_init(optarg)) {
+                    error_report("could not publish FIES statistics in %s",
+                                 optarg);
+                    exit(1);
+                }
+                break;
             // CF FIES
             case QEMU_OPTION_usbdevice:
                 error_report("'-usbdevice' is deprecated, please use "
@@ -4960,6 +4983,10 @@ int main(int argc, char **argv, char **envp)
         return 0;
     }
 
+    // CF FIES
+    FIESER_init();
+    // CF FIES END
+
     if (incoming) {
         Error *local_err = NULL;
         qemu_start_incoming_migration(incoming, &local_err);